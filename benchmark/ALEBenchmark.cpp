@@ -0,0 +1,58 @@
+/*
+ * Copyright 2012, Clemens Zeidler <haiku@clemens-zeidler.de>
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*! Headless benchmark for the editor operations, the object system and the
+component roster. Results are written as JSON to stdout:
+
+	ALEBenchmark [maxAreas] [iterations] [--icons]
+
+The component palette decodes icons into bitmaps, which needs the app_server,
+so it is only measured with --icons. The benchmark links against the Haiku
+kits and the ALM layout library and only runs on Haiku.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Application.h>
+
+#include "Benchmark.h"
+
+
+int
+main(int argc, char** argv)
+{
+	int32 maxAreas = 400;
+	int32 iterations = 5;
+	bool icons = false;
+	if (argc > 1)
+		maxAreas = atoi(argv[1]);
+	if (argc > 2)
+		iterations = atoi(argv[2]);
+	if (argc > 3)
+		icons = strcmp(argv[3], "--icons") == 0;
+	if (maxAreas < 1 || iterations < 1 || (argc > 3 && !icons)) {
+		fprintf(stderr, "Usage: %s [maxAreas] [iterations] [--icons]\n",
+			argv[0]);
+		return 1;
+	}
+
+	srand(42);
+
+	BenchmarkReport report;
+	RunLayoutBenchmarks(report, maxAreas, iterations);
+	RunObjectBenchmarks(report, iterations);
+	RunRosterBenchmarks(report, iterations);
+	if (icons) {
+		// connects to the app_server for the bitmaps
+		BApplication application("application/x-vnd.ALEBenchmark");
+		RunIconBenchmarks(report, iterations);
+	}
+	RunObjectStress(report, iterations);
+	return 0;
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2012, Clemens Zeidler <haiku@clemens-zeidler.de>
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef	BENCHMARK_H
+#define	BENCHMARK_H
+
+
+#include <OS.h>
+
+
+/*! Writes the results as JSON to stdout. Every result is one entry of name
+and value fields. */
+class BenchmarkReport {
+public:
+								BenchmarkReport();
+								~BenchmarkReport();
+
+			//! Starts a result, its fields are added until EndEntry().
+			void				BeginEntry();
+			void				EndEntry();
+
+			void				AddString(const char* name, const char* value);
+			void				AddInt(const char* name, int64 value);
+			void				AddFloat(const char* name, double value,
+									int32 precision);
+			//! Adds the number of calls per second.
+			void				AddRate(const char* name, int32 calls,
+									bigtime_t time);
+
+private:
+			void				_BeginField(const char* name);
+
+			int32				fCount;
+			int32				fFields;
+};
+
+
+//! Counts all heap allocations, to check that a code path doesn't allocate.
+int32 CountAllocations();
+
+
+void RunLayoutBenchmarks(BenchmarkReport& report, int32 maxAreas,
+	int32 iterations);
+void RunObjectBenchmarks(BenchmarkReport& report, int32 iterations);
+void RunObjectStress(BenchmarkReport& report, int32 iterations);
+void RunRosterBenchmarks(BenchmarkReport& report, int32 iterations);
+//! Needs the app_server for the bitmaps.
+void RunIconBenchmarks(BenchmarkReport& report, int32 iterations);
+
+
+#endif	// BENCHMARK_H
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2012, Clemens Zeidler <haiku@clemens-zeidler.de>
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "Benchmark.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <new>
+
+
+static int32 sAllocations = 0;
+
+
+void*
+operator new(size_t size)
+{
+	atomic_add(&sAllocations, 1);
+	void* memory = malloc(size > 0 ? size : 1);
+	if (memory == NULL)
+		throw std::bad_alloc();
+	return memory;
+}
+
+
+void
+operator delete(void* memory) throw()
+{
+	free(memory);
+}
+
+
+int32
+CountAllocations()
+{
+	return atomic_get(&sAllocations);
+}
+
+
+BenchmarkReport::BenchmarkReport()
+	:
+	fCount(0),
+	fFields(0)
+{
+	printf("{\n\t\"benchmarks\": [");
+}
+
+
+BenchmarkReport::~BenchmarkReport()
+{
+	printf("\n\t]\n}\n");
+}
+
+
+void
+BenchmarkReport::BeginEntry()
+{
+	if (fCount > 0)
+		printf(",");
+	printf("\n\t\t{ ");
+	fFields = 0;
+}
+
+
+void
+BenchmarkReport::EndEntry()
+{
+	printf(" }");
+	fflush(stdout);
+	fCount++;
+}
+
+
+void
+BenchmarkReport::AddString(const char* name, const char* value)
+{
+	_BeginField(name);
+	printf("\"%s\"", value);
+}
+
+
+void
+BenchmarkReport::AddInt(const char* name, int64 value)
+{
+	_BeginField(name);
+	printf("%lli", (long long)value);
+}
+
+
+void
+BenchmarkReport::AddFloat(const char* name, double value, int32 precision)
+{
+	_BeginField(name);
+	printf("%.*f", (int)precision, value);
+}
+
+
+void
+BenchmarkReport::AddRate(const char* name, int32 calls, bigtime_t time)
+{
+	AddFloat(name, time > 0 ? calls * 1000000. / time : 0., 0);
+}
+
+
+void
+BenchmarkReport::_BeginField(const char* name)
+{
+	if (fFields > 0)
+		printf(", ");
+	printf("\"%s\": ", name);
+	fFields++;
+}
@@ -0,0 +1,385 @@
+/*
+ * Copyright 2012, Clemens Zeidler <haiku@clemens-zeidler.de>
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*! The editor operations on synthetic layouts. The layouts are built from
+space items, so neither a window nor the app_server is needed. */
+
+
+#include "Benchmark.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <vector>
+
+#include <SpaceLayoutItem.h>
+
+#include <ALMLayout.h>
+#include <LayoutArchive.h>
+
+#include "AreaRemoval.h"
+#include "GroupDetection.h"
+#include "OverlapManager.h"
+
+
+using namespace BALM;
+
+
+const float kLayoutWidth = 2000;
+const float kLayoutHeight = 2000;
+
+
+// holds references, tabs that are not yet used by an area would get lost
+struct cell {
+	BReference<XTab>	left;
+	BReference<YTab>	top;
+	BReference<XTab>	right;
+	BReference<YTab>	bottom;
+};
+
+
+enum layout_type {
+	kGridLayout,
+	kGuillotineLayout,
+	kNestedLayout
+};
+
+
+static const char*
+LayoutName(layout_type type)
+{
+	switch (type) {
+		case kGridLayout:
+			return "grid";
+		case kGuillotineLayout:
+			return "guillotine";
+		case kNestedLayout:
+			return "nested";
+	}
+	return "unknown";
+}
+
+
+static BALMLayout*
+CreateLayout()
+{
+	BALMLayout* layout = new BALMLayout();
+	layout->Left()->SetValue(0);
+	layout->Top()->SetValue(0);
+	layout->Right()->SetValue(kLayoutWidth);
+	layout->Bottom()->SetValue(kLayoutHeight);
+	return layout;
+}
+
+
+static void
+AddCells(BALMLayout* layout, const std::vector<cell>& cells)
+{
+	for (unsigned int i = 0; i < cells.size(); i++) {
+		const cell& current = cells[i];
+		layout->AddItem(BSpaceLayoutItem::CreateGlue(), current.left,
+			current.top, current.right, current.bottom);
+	}
+}
+
+
+//! Splits cell index into two cells, returns the index of the second one.
+static int32
+SplitCell(BALMLayout* layout, std::vector<cell>& cells, int32 index,
+	bool vertical, float fraction)
+{
+	cell first = cells[index];
+	cell second = first;
+	if (vertical) {
+		BReference<XTab> tab = layout->AddXTab();
+		tab->SetValue(first.left->Value()
+			+ (first.right->Value() - first.left->Value()) * fraction);
+		first.right = tab;
+		second.left = tab;
+	} else {
+		BReference<YTab> tab = layout->AddYTab();
+		tab->SetValue(first.top->Value()
+			+ (first.bottom->Value() - first.top->Value()) * fraction);
+		first.bottom = tab;
+		second.top = tab;
+	}
+	cells[index] = first;
+	cells.push_back(second);
+	return cells.size() - 1;
+}
+
+
+static BALMLayout*
+CreateGridLayout(int32 nAreas)
+{
+	BALMLayout* layout = CreateLayout();
+
+	int32 columns = 1;
+	while (columns * columns < nAreas)
+		columns++;
+	int32 rows = (nAreas + columns - 1) / columns;
+
+	std::vector<BReference<XTab> > xTabs;
+	xTabs.push_back(layout->Left());
+	for (int32 i = 1; i < columns; i++) {
+		xTabs.push_back(layout->AddXTab());
+		xTabs[i]->SetValue(kLayoutWidth * i / columns);
+	}
+	xTabs.push_back(layout->Right());
+
+	std::vector<BReference<YTab> > yTabs;
+	yTabs.push_back(layout->Top());
+	for (int32 i = 1; i < rows; i++) {
+		yTabs.push_back(layout->AddYTab());
+		yTabs[i]->SetValue(kLayoutHeight * i / rows);
+	}
+	yTabs.push_back(layout->Bottom());
+
+	std::vector<cell> cells;
+	for (int32 i = 0; i < nAreas; i++) {
+		cell current;
+		current.left = xTabs[i % columns];
+		current.right = xTabs[i % columns + 1];
+		current.top = yTabs[i / columns];
+		current.bottom = yTabs[i / columns + 1];
+		cells.push_back(current);
+	}
+	AddCells(layout, cells);
+	return layout;
+}
+
+
+/*! Random rectangle packing, each step splits a random cell along its longer
+side. */
+static BALMLayout*
+CreateGuillotineLayout(int32 nAreas)
+{
+	BALMLayout* layout = CreateLayout();
+
+	std::vector<cell> cells;
+	cell border = { layout->Left(), layout->Top(), layout->Right(),
+		layout->Bottom() };
+	cells.push_back(border);
+	while ((int32)cells.size() < nAreas) {
+		int32 index = rand() % cells.size();
+		const cell& current = cells[index];
+		bool vertical = current.right->Value() - current.left->Value()
+			>= current.bottom->Value() - current.top->Value();
+		float fraction = 0.25 + 0.5 * (rand() % 1000) / 1000.;
+		SplitCell(layout, cells, index, vertical, fraction);
+	}
+	AddCells(layout, cells);
+	return layout;
+}
+
+
+//! Deeply nested groups, always splits the last cell in alternating direction.
+static BALMLayout*
+CreateNestedLayout(int32 nAreas)
+{
+	BALMLayout* layout = CreateLayout();
+
+	std::vector<cell> cells;
+	cell border = { layout->Left(), layout->Top(), layout->Right(),
+		layout->Bottom() };
+	cells.push_back(border);
+	int32 index = 0;
+	bool vertical = true;
+	while ((int32)cells.size() < nAreas) {
+		index = SplitCell(layout, cells, index, vertical, 0.5);
+		vertical = !vertical;
+	}
+	AddCells(layout, cells);
+	return layout;
+}
+
+
+static BALMLayout*
+CreateLayout(layout_type type, int32 nAreas)
+{
+	switch (type) {
+		case kGridLayout:
+			return CreateGridLayout(nAreas);
+		case kGuillotineLayout:
+			return CreateGuillotineLayout(nAreas);
+		case kNestedLayout:
+			return CreateNestedLayout(nAreas);
+	}
+	return NULL;
+}
+
+
+
+
+static void
+BeginLayoutEntry(BenchmarkReport& report, layout_type type, int32 nAreas,
+	const char* operation, int32 iterations, bigtime_t time)
+{
+	report.BeginEntry();
+	report.AddString("layout", LayoutName(type));
+	report.AddInt("areas", nAreas);
+	report.AddString("operation", operation);
+	report.AddInt("iterations", iterations);
+	report.AddFloat("usPerIteration", double(time) / iterations, 1);
+}
+
+
+static void
+AddLayoutEntry(BenchmarkReport& report, layout_type type, int32 nAreas,
+	const char* operation, int32 iterations, bigtime_t time)
+{
+	BeginLayoutEntry(report, type, nAreas, operation, iterations, time);
+	report.EndEntry();
+}
+
+
+static void
+RunBenchmarks(BenchmarkReport& report, layout_type type, int32 nAreas,
+	int32 iterations)
+{
+	BALMLayout* layout = CreateLayout(type, nAreas);
+
+	// layout archive
+	BMessage archive;
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < iterations; i++)
+		LayoutArchive(layout).SaveLayout(&archive, false);
+	AddLayoutEntry(report, type, nAreas, "archiveSave", iterations,
+		system_time() - start);
+
+	start = system_time();
+	for (int32 i = 0; i < iterations; i++)
+		LayoutArchive(layout).RestoreLayout(&archive, false);
+	AddLayoutEntry(report, type, nAreas, "archiveRestore", iterations,
+		system_time() - start);
+
+	// window resize, the editor only updates the tab values of the archived
+	// layout, compare with archiveSave
+	status_t status = B_OK;
+	start = system_time();
+	for (int32 i = 0; i < iterations && status == B_OK; i++) {
+		layout->Right()->SetValue(kLayoutWidth - i % 2);
+		status = LayoutArchive(layout).UpdateTabValues(&archive);
+	}
+	bigtime_t resizeTime = system_time() - start;
+	layout->Right()->SetValue(kLayoutWidth);
+	if (status == B_OK) {
+		AddLayoutEntry(report, type, nAreas, "resizeUpdateTabValues",
+			iterations, resizeTime);
+	} else
+		fprintf(stderr, "Updating the tab values failed.\n");
+
+	// tab connections
+	TabConnections connections;
+	start = system_time();
+	for (int32 i = 0; i < iterations; i++)
+		connections.Fill(layout);
+	AddLayoutEntry(report, type, nAreas, "tabConnectionsFill", iterations,
+		system_time() - start);
+
+	// overlap manager
+	{
+		OverlapManager overlapManager(layout);
+		bigtime_t connectTime = 0;
+		bigtime_t disconnectTime = 0;
+		for (int32 i = 0; i < iterations; i++) {
+			start = system_time();
+			overlapManager.ConnectAreas();
+			connectTime += system_time() - start;
+
+			if (i == iterations - 1)
+				break;
+			start = system_time();
+			overlapManager.DisconnectAreas();
+			disconnectTime += system_time() - start;
+		}
+
+		int32 eliminatedRows;
+		int32 coalescedTabs;
+		overlapManager.GetPresolveStatistics(eliminatedRows, coalescedTabs);
+		BeginLayoutEntry(report, type, nAreas, "overlapConnect", iterations,
+			connectTime);
+		report.AddInt("constraints",
+			layout->Solver()->Constraints().CountItems());
+		report.AddInt("presolveEliminatedRows", eliminatedRows);
+		report.AddInt("presolveCoalescedTabs", coalescedTabs);
+		report.EndEntry();
+		if (iterations > 1) {
+			AddLayoutEntry(report, type, nAreas, "overlapDisconnect",
+				iterations - 1, disconnectTime);
+		}
+
+		// solve with the overlap constraints in place
+		LinearSpec* solver = layout->Solver();
+		BObjectList<Constraint> borderConstraints;
+		borderConstraints.AddItem(solver->AddConstraint(1., layout->Left(),
+			LinearProgramming::kEQ, 0));
+		borderConstraints.AddItem(solver->AddConstraint(1., layout->Top(),
+			LinearProgramming::kEQ, 0));
+		borderConstraints.AddItem(solver->AddConstraint(1., layout->Right(),
+			LinearProgramming::kEQ, kLayoutWidth));
+		borderConstraints.AddItem(solver->AddConstraint(1., layout->Bottom(),
+			LinearProgramming::kEQ, kLayoutHeight));
+		start = system_time();
+		for (int32 i = 0; i < iterations; i++)
+			solver->Solve();
+		AddLayoutEntry(report, type, nAreas, "solve", iterations,
+			system_time() - start);
+		for (int32 i = 0; i < borderConstraints.CountItems(); i++)
+			solver->RemoveConstraint(borderConstraints.ItemAt(i));
+
+		// the solver may have moved the tabs, start from the generated layout
+		LayoutArchive(layout).RestoreLayout(&archive, false);
+	}
+
+	// group detection
+	connections.Fill(layout);
+	GroupDetection groupDetection(&connections);
+	start = system_time();
+	for (int32 i = 0; i < iterations; i++) {
+		for (int32 a = 0; a < layout->CountAreas(); a++) {
+			BObjectList<Area> group;
+			groupDetection.FindAdjacentAreas(layout->AreaAt(a), kRight, group);
+		}
+	}
+	AddLayoutEntry(report, type, nAreas, "groupDetection", iterations,
+		system_time() - start);
+
+	delete layout;
+
+	// area removal, needs a fresh layout for every run
+	bigtime_t removalTime = 0;
+	for (int32 i = 0; i < iterations; i++) {
+		layout = CreateLayout(type, nAreas);
+		Area* area = layout->AreaAt(layout->CountAreas() / 2);
+		BReference<XTab> left = area->Left();
+		BReference<YTab> top = area->Top();
+		BReference<XTab> right = area->Right();
+		BReference<YTab> bottom = area->Bottom();
+		BLayoutItem* item = area->Item();
+		layout->RemoveItem(item);
+		delete item;
+
+		start = system_time();
+		AreaRemoval::FillEmptySpace(layout, left, top, right, bottom);
+		removalTime += system_time() - start;
+		delete layout;
+	}
+	AddLayoutEntry(report, type, nAreas, "areaRemoval", iterations,
+		removalTime);
+}
+
+
+void
+RunLayoutBenchmarks(BenchmarkReport& report, int32 maxAreas, int32 iterations)
+{
+	const layout_type types[] = { kGridLayout, kGuillotineLayout,
+		kNestedLayout };
+	for (int32 nAreas = 25; nAreas <= maxAreas; nAreas *= 4) {
+		for (unsigned int t = 0; t < sizeof(types) / sizeof(types[0]); t++)
+			RunBenchmarks(report, types[t], nAreas, iterations);
+	}
+}
@@ -0,0 +1,775 @@
+/*
+ * Copyright 2012, Clemens Zeidler <haiku@clemens-zeidler.de>
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*! The object system: method and event dispatch, property access, archiving,
+the C bindings and the object registry. */
+
+
+#include "Benchmark.h"
+
+#include <stdio.h>
+
+#include <vector>
+
+#include <Looper.h>
+
+#include <CInterface.h>
+#include <Object.h>
+#include <PObject.h>
+#include <PObjectBroker.h>
+#include <PPropertySchema.h>
+
+
+const int32 kMethodCalls = 10000;
+const int32 kRegistryOperations = 1000;
+const int32 kLiveObjects = 1000;
+const int32 kEventOperations = 1000;
+const int32 kArchivedObjects = 10000;
+
+
+static void
+AddObject(BenchmarkReport& report, int32 nMethods, const char* operation,
+	int32 calls, bigtime_t time)
+{
+	report.BeginEntry();
+	report.AddString("object", "PObject");
+	report.AddInt("methods", nMethods);
+	report.AddString("operation", operation);
+	report.AddInt("calls", calls);
+	report.AddRate("callsPerSecond", calls, time);
+	report.EndEntry();
+}
+
+
+static void
+AddEvents(BenchmarkReport& report, const char* operation, int32 calls,
+	bigtime_t time)
+{
+	report.BeginEntry();
+	report.AddString("object", "BObject");
+	report.AddString("operation", operation);
+	report.AddInt("calls", calls);
+	report.AddRate("callsPerSecond", calls, time);
+	report.EndEntry();
+}
+
+
+static void
+AddAsyncEvents(BenchmarkReport& report, int32 nTargets, const char* operation,
+	int32 calls, bigtime_t time, int32 allocations)
+{
+	report.BeginEntry();
+	report.AddString("object", "BObject");
+	report.AddInt("targets", nTargets);
+	report.AddString("operation", operation);
+	report.AddInt("calls", calls);
+	report.AddRate("callsPerSecond", calls, time);
+	report.AddFloat("allocationsPerCall", double(allocations) / calls, 2);
+	report.EndEntry();
+}
+
+
+static void
+AddValues(BenchmarkReport& report, const char* operation, int32 calls,
+	bigtime_t time, int32 allocations)
+{
+	report.BeginEntry();
+	report.AddString("object", "PData");
+	report.AddString("operation", operation);
+	report.AddInt("calls", calls);
+	report.AddRate("callsPerSecond", calls, time);
+	report.AddFloat("allocationsPerCall", double(allocations) / calls, 2);
+	report.EndEntry();
+}
+
+
+static void
+AddArchive(BenchmarkReport& report, const char* operation, int32 objects,
+	ssize_t bytes, bigtime_t archiveTime, bigtime_t loadTime)
+{
+	report.BeginEntry();
+	report.AddString("object", "PObject");
+	report.AddString("operation", operation);
+	report.AddInt("objects", objects);
+	report.AddInt("bytes", bytes);
+	report.AddInt("archiveUs", archiveTime);
+	report.AddInt("loadUs", loadTime);
+	report.EndEntry();
+}
+
+
+static void
+AddCInterface(BenchmarkReport& report, const char* operation, int32 calls,
+	bigtime_t time)
+{
+	report.BeginEntry();
+	report.AddString("object", "CInterface");
+	report.AddString("operation", operation);
+	report.AddInt("calls", calls);
+	report.AddRate("callsPerSecond", calls, time);
+	report.EndEntry();
+}
+
+
+static void
+AddDuplicates(BenchmarkReport& report, const char* operation, int32 copies,
+	bigtime_t time, int32 allocations)
+{
+	report.BeginEntry();
+	report.AddString("object", "PObject");
+	report.AddString("operation", operation);
+	report.AddInt("copies", copies);
+	report.AddFloat("usPerCopy", double(time) / copies, 3);
+	report.AddFloat("allocationsPerCopy", double(allocations) / copies, 2);
+	report.EndEntry();
+}
+
+
+//! A stress test result, object is the class under test.
+static void
+AddStress(BenchmarkReport& report, const char* object, int32 nThreads,
+	const char* operation, int32 operations, bigtime_t time, int32 failures)
+{
+	report.BeginEntry();
+	report.AddString("object", object);
+	report.AddInt("threads", nThreads);
+	report.AddString("operation", operation);
+	report.AddInt("operations", operations);
+	report.AddFloat("usPerOperation", double(time) / operations, 3);
+	report.AddInt("failures", failures);
+	report.EndEntry();
+}
+
+
+static status_t
+EmptyMethod(void* object, PArgs* in, PArgs* out, void* extraData)
+{
+	return B_OK;
+}
+
+
+class BenchmarkObject : public PObject {
+public:
+	BenchmarkObject(int32 nMethods)
+	{
+		fType = "BenchmarkObject";
+		for (int32 i = 0; i < nMethods; i++) {
+			BString name("Method");
+			name << i;
+			AddMethod(new PMethod(name.String(), EmptyMethod));
+		}
+	}
+};
+
+
+//! The name search RunMethod() did before the method tables.
+static status_t
+RunMethodLinear(PObject* object, const char* name, PArgs& in, PArgs& out)
+{
+	for (int32 i = 0; i < object->CountMethods(); i++) {
+		PMethod* method = object->MethodAt(i);
+		if (method->GetName().ICompare(name) == 0)
+			return method->Run(object, in, out);
+	}
+	return B_NAME_NOT_FOUND;
+}
+
+
+static void
+RunMethodBenchmarks(BenchmarkReport& report, int32 nMethods, int32 iterations)
+{
+	BenchmarkObject object(nMethods);
+	// the last method is the worst case for a linear search
+	BString name("Method");
+	name << nMethods - 1;
+	int32 calls = iterations * kMethodCalls;
+	PArgs in, out;
+
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < calls; i++)
+		RunMethodLinear(&object, name.String(), in, out);
+	AddObject(report, nMethods, "runMethodLinearSearch", calls,
+		system_time() - start);
+
+	start = system_time();
+	for (int32 i = 0; i < calls; i++)
+		object.RunMethod(name.String(), in, out);
+	AddObject(report, nMethods, "runMethodByName", calls,
+		system_time() - start);
+
+	PMethod* method = object.FindMethod(name.String());
+	start = system_time();
+	for (int32 i = 0; i < calls; i++)
+		object.RunMethod(method, in, out);
+	AddObject(report, nMethods, "runMethodHandle", calls,
+		system_time() - start);
+
+	// a second object of the type shares the method table
+	BenchmarkObject other(nMethods);
+	start = system_time();
+	for (int32 i = 0; i < calls; i++)
+		other.RunMethod(name.String(), in, out);
+	AddObject(report, nMethods, "runMethodByNameShared", calls,
+		system_time() - start);
+}
+
+
+static status_t
+HandleEvent(void* object, PArgs* in, PArgs* out, void* extraData)
+{
+	int32 value;
+	BString text;
+	in->FindInt32("value", &value);
+	in->FindString("text", &text);
+	return B_OK;
+}
+
+
+class EventTarget : public BObject {
+public:
+	EventTarget()
+	{
+		AddMethod(new PMethod("Handle", HandleEvent));
+	}
+};
+
+
+//! Adds an argument like PArgs did when it kept its fields in a BMessage.
+static void
+AddMessageArg(BMessage& message, const char* name, type_code type)
+{
+	type_code code;
+	int32 count = 0;
+	message.GetInfo(name, &code, &count);
+	message.AddString("fieldname", name);
+	message.AddInt32("type", type);
+	message.AddInt32("callindex", 0);
+	message.AddInt32("fieldindex", count);
+}
+
+
+static void
+RunEventBenchmarks(BenchmarkReport& report, int32 iterations)
+{
+	BObject* source = new BObject;
+	EventTarget* target = new EventTarget;
+	source->AddEvent("Changed", NULL);
+	source->ConnectEvent("Changed", target, "Handle");
+
+	int32 calls = iterations * kMethodCalls;
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < calls; i++) {
+		PArgs in, out;
+		in.AddInt32("value", i);
+		in.AddString("text", "changed");
+		source->FireEventSync("Changed", in, out);
+	}
+	AddEvents(report, "fireEventSync", calls, system_time() - start);
+
+	// The argument handling of a synchronous event before PArgs got its flat
+	// storage, the dispatch itself is the same as above.
+	start = system_time();
+	for (int32 i = 0; i < calls; i++) {
+		BMessage in;
+		AddMessageArg(in, "value", B_INT32_TYPE);
+		in.AddInt32("value", i);
+		AddMessageArg(in, "text", B_STRING_TYPE);
+		in.AddString("text", "changed");
+
+		int32 value;
+		BString text;
+		in.FindInt32("value", &value);
+		in.FindString("text", &text);
+	}
+	AddEvents(report, "argsMessageBackend", calls, system_time() - start);
+
+	start = system_time();
+	for (int32 i = 0; i < calls; i++) {
+		PArgs in;
+		in.AddInt32("value", i);
+		in.AddString("text", "changed");
+
+		int32 value;
+		BString text;
+		in.FindInt32("value", &value);
+		in.FindString("text", &text);
+	}
+	AddEvents(report, "argsFlat", calls, system_time() - start);
+
+	source->ReleaseReference();
+	target->ReleaseReference();
+}
+
+
+static int32 sAsyncCalls = 0;
+
+
+static status_t
+HandleAsyncEvent(void* object, PArgs* in, PArgs* out, void* extraData)
+{
+	atomic_add(&sAsyncCalls, 1);
+	return B_OK;
+}
+
+
+class AsyncEventTarget : public BObject {
+public:
+	AsyncEventTarget()
+	{
+		AddMethod(new PMethod("Handle", HandleAsyncEvent));
+	}
+};
+
+
+/*! Fires an event asynchronously to targets that share one looper, until all
+methods have run. The looper gets one message per fired event. */
+static void
+RunAsyncEventBenchmarks(BenchmarkReport& report, int32 nTargets,
+	int32 iterations)
+{
+	BLooper* looper = new BLooper("async events");
+	looper->Run();
+
+	BObject* source = new BObject;
+	source->AddEvent("Changed", NULL);
+	std::vector<AsyncEventTarget*> targets;
+	looper->Lock();
+	for (int32 i = 0; i < nTargets; i++) {
+		AsyncEventTarget* target = new AsyncEventTarget;
+		target->SetLooper(looper);
+		source->ConnectEvent("Changed", target, "Handle");
+		targets.push_back(target);
+	}
+	looper->Unlock();
+
+	int32 calls = iterations * kEventOperations;
+	sAsyncCalls = 0;
+	int32 allocations = CountAllocations();
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < calls; i++) {
+		PArgs in, out;
+		in.AddInt32("value", i);
+		in.AddString("text", "changed");
+		source->FireEventAsync("Changed", in, out);
+	}
+	while (atomic_get(&sAsyncCalls) < calls * nTargets)
+		snooze(100);
+	AddAsyncEvents(report, nTargets, "fireEventAsync", calls,
+		system_time() - start, CountAllocations() - allocations);
+
+	source->ReleaseReference();
+	looper->Lock();
+	for (unsigned int i = 0; i < targets.size(); i++) {
+		looper->RemoveHandler(targets[i]);
+		targets[i]->ReleaseReference();
+	}
+	looper->Quit();
+}
+
+
+struct event_stress {
+	BObject*			source;
+	int32				operations;
+	int32				failures;
+};
+
+
+struct event_connector {
+	event_stress*		stress;
+	EventTarget*		target;
+};
+
+
+static status_t
+EventFireThread(void* data)
+{
+	event_stress* stress = (event_stress*)data;
+	for (int32 i = 0; i < stress->operations; i++) {
+		PArgs in, out;
+		in.AddInt32("value", i);
+		if (stress->source->FireEventSync("Changed", in, out) != B_OK)
+			atomic_add(&stress->failures, 1);
+	}
+	return B_OK;
+}
+
+
+static status_t
+EventConnectThread(void* data)
+{
+	event_connector* connector = (event_connector*)data;
+	event_stress* stress = connector->stress;
+	for (int32 i = 0; i < stress->operations; i++) {
+		if (stress->source->ConnectEvent("Changed", connector->target,
+				"Handle") != B_OK)
+			atomic_add(&stress->failures, 1);
+		if (stress->source->DisconnectEvent("Changed", connector->target)
+				!= B_OK)
+			atomic_add(&stress->failures, 1);
+	}
+	return B_OK;
+}
+
+
+/*! Fires an event from some threads while the same number of threads connect
+and disconnect targets. A failure is a call that doesn't succeed or a
+connection that is left over at the end. */
+static void
+RunEventStress(BenchmarkReport& report, int32 nThreads, int32 iterations)
+{
+	event_stress stress;
+	stress.source = new BObject;
+	stress.operations = iterations * kEventOperations;
+	stress.failures = 0;
+	stress.source->AddEvent("Changed", NULL);
+
+	EventTarget* target = new EventTarget;
+	stress.source->ConnectEvent("Changed", target, "Handle");
+
+	std::vector<event_connector> connectors(nThreads);
+	for (int32 i = 0; i < nThreads; i++) {
+		connectors[i].stress = &stress;
+		connectors[i].target = new EventTarget;
+	}
+
+	std::vector<thread_id> threads;
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < nThreads; i++) {
+		thread_id thread = spawn_thread(EventFireThread, "event fire",
+			B_NORMAL_PRIORITY, &stress);
+		if (thread >= 0)
+			threads.push_back(thread);
+		thread = spawn_thread(EventConnectThread, "event connect",
+			B_NORMAL_PRIORITY, &connectors[i]);
+		if (thread >= 0)
+			threads.push_back(thread);
+	}
+	for (unsigned int i = 0; i < threads.size(); i++)
+		resume_thread(threads[i]);
+	for (unsigned int i = 0; i < threads.size(); i++) {
+		status_t result;
+		wait_for_thread(threads[i], &result);
+	}
+	bigtime_t time = system_time() - start;
+
+	for (int32 i = 0; i < nThreads; i++) {
+		if (stress.source->DisconnectEvent("Changed", connectors[i].target)
+				== B_OK)
+			atomic_add(&stress.failures, 1);
+	}
+	AddStress(report, "BObject", threads.size(), "eventStress",
+		threads.size() * stress.operations, time, stress.failures);
+
+	stress.source->ReleaseReference();
+	target->ReleaseReference();
+	for (int32 i = 0; i < nThreads; i++)
+		connectors[i].target->ReleaseReference();
+}
+
+
+/*! Sets and gets properties through the typed PData accessors. The values
+live inline, so a round trip should not allocate at all. */
+static void
+RunValueBenchmarks(BenchmarkReport& report, int32 iterations)
+{
+	PObject* object = new PObject();
+	object->AddProperty(new IntProperty("Value", 0));
+	object->AddProperty(new BoolProperty("Enabled", false));
+	object->AddProperty(new FloatProperty("Weight", 0));
+
+	int32 calls = iterations * kMethodCalls;
+	int32 allocations = CountAllocations();
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < calls; i++) {
+		int64 value;
+		object->SetIntProperty("Value", i);
+		object->GetIntProperty("Value", value);
+	}
+	AddValues(report, "intProperty", calls, system_time() - start,
+		CountAllocations() - allocations);
+
+	allocations = CountAllocations();
+	start = system_time();
+	for (int32 i = 0; i < calls; i++) {
+		bool enabled;
+		object->SetBoolProperty("Enabled", (i & 1) != 0);
+		object->GetBoolProperty("Enabled", enabled);
+	}
+	AddValues(report, "boolProperty", calls, system_time() - start,
+		CountAllocations() - allocations);
+
+	allocations = CountAllocations();
+	start = system_time();
+	for (int32 i = 0; i < calls; i++) {
+		float weight;
+		object->SetFloatProperty("Weight", i);
+		object->GetFloatProperty("Weight", weight);
+	}
+	AddValues(report, "floatProperty", calls, system_time() - start,
+		CountAllocations() - allocations);
+
+	delete object;
+}
+
+
+static PObject*
+CreateArchiveObject(int32 index)
+{
+	PObject* object = new PObject();
+	object->AddProperty(new StringProperty("Label", "Button"));
+	object->AddProperty(new IntProperty("Value", index));
+	object->AddProperty(new BoolProperty("Enabled", true));
+	object->AddProperty(new RectProperty("Frame", BRect(0, 0, 100, 20)));
+	object->AddProperty(new ColorProperty("Color", 216, 216, 216),
+		PROPERTY_HIDE_IN_EDITOR);
+	return object;
+}
+
+
+/*! Archives many objects of the same type, once with a full archive per object
+and once as value rows that share a schema, and instantiates them again. */
+static void
+RunArchiveBenchmarks(BenchmarkReport& report)
+{
+	std::vector<PObject*> objects;
+	for (int32 i = 0; i < kArchivedObjects; i++)
+		objects.push_back(CreateArchiveObject(i));
+
+	BMessage legacy;
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < kArchivedObjects; i++) {
+		BMessage archive;
+		objects[i]->Archive(&archive);
+		legacy.AddMessage("object", &archive);
+	}
+	bigtime_t archiveTime = system_time() - start;
+
+	start = system_time();
+	BMessage archive;
+	for (int32 i = 0; legacy.FindMessage("object", i, &archive) == B_OK; i++)
+		delete PObject::Instantiate(&archive);
+	AddArchive(report, "archiveLegacy", kArchivedObjects,
+		legacy.FlattenedSize(), archiveTime, system_time() - start);
+
+	BMessage rows;
+	BMessage schemas;
+	start = system_time();
+	for (int32 i = 0; i < kArchivedObjects; i++) {
+		BMessage row;
+		objects[i]->ArchiveValues(&row, &schemas);
+		rows.AddMessage("object", &row);
+	}
+	rows.AddMessage("schemas", &schemas);
+	archiveTime = system_time() - start;
+
+	start = system_time();
+	if (rows.FindMessage("schemas", &schemas) == B_OK)
+		PPropertySchema::RegisterSchemas(&schemas);
+	for (int32 i = 0; rows.FindMessage("object", i, &archive) == B_OK; i++)
+		delete PObject::Instantiate(&archive);
+	AddArchive(report, "archiveSchema", kArchivedObjects, rows.FlattenedSize(),
+		archiveTime, system_time() - start);
+
+	for (unsigned int i = 0; i < objects.size(); i++)
+		delete objects[i];
+}
+
+
+struct c_arguments {
+	int32		value;
+	float		weight;
+	const char*	label;
+};
+
+
+/*! Fills and reads method arguments through the C bindings the way scripted
+methods do, by field name, through field handles and as one struct. A call is
+one round trip of three fields. */
+static void
+RunCInterfaceBenchmarks(BenchmarkReport& report, int32 iterations)
+{
+	PArgs args;
+	int32 calls = iterations * kMethodCalls;
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < calls; i++) {
+		int32 value;
+		float weight;
+		const char* label;
+		args.MakeEmpty();
+		add_parg_int32(&args, "value", i);
+		add_parg_float(&args, "weight", 0.5f);
+		add_parg_string(&args, "label", "Button");
+		find_parg_int32(&args, "value", &value);
+		find_parg_float(&args, "weight", &weight);
+		find_parg_string(&args, "label", &label);
+	}
+	AddCInterface(report, "argsByName", calls, system_time() - start);
+
+	parg_field_handle valueField = parg_field("value");
+	parg_field_handle weightField = parg_field("weight");
+	parg_field_handle labelField = parg_field("label");
+	start = system_time();
+	for (int32 i = 0; i < calls; i++) {
+		int32 value;
+		float weight;
+		const char* label;
+		args.MakeEmpty();
+		add_parg_int32_field(&args, valueField, i);
+		add_parg_float_field(&args, weightField, 0.5f);
+		add_parg_string_field(&args, labelField, "Button");
+		find_parg_int32_field(&args, valueField, &value);
+		find_parg_float_field(&args, weightField, &weight);
+		find_parg_string_field(&args, labelField, &label);
+	}
+	AddCInterface(report, "argsByHandle", calls, system_time() - start);
+
+	const parg_field_desc fields[] = {
+		{ valueField, B_INT32_TYPE, offsetof(c_arguments, value),
+			sizeof(int32) },
+		{ weightField, B_FLOAT_TYPE, offsetof(c_arguments, weight),
+			sizeof(float) },
+		{ labelField, B_STRING_TYPE, offsetof(c_arguments, label), 0 }
+	};
+	const int32 fieldCount = sizeof(fields) / sizeof(fields[0]);
+	start = system_time();
+	for (int32 i = 0; i < calls; i++) {
+		c_arguments in = { i, 0.5f, "Button" };
+		c_arguments out;
+		args.MakeEmpty();
+		add_parg_fields(&args, fields, fieldCount, &in);
+		find_parg_fields(&args, fields, fieldCount, &out);
+	}
+	AddCInterface(report, "argsBulk", calls, system_time() - start);
+}
+
+
+/*! Duplicates an object with several properties and methods. The copies share
+the property and method tables of the original, so a copy should cost a few
+allocations; the first write to a property of a copy has to unshare it. */
+static void
+RunDuplicateBenchmarks(BenchmarkReport& report)
+{
+	PObject* original = new BenchmarkObject(16);
+	original->AddProperty(new StringProperty("Label", "Button"));
+	original->AddProperty(new IntProperty("Value", 0));
+	original->AddProperty(new BoolProperty("Enabled", true));
+	original->AddProperty(new RectProperty("Frame", BRect(0, 0, 100, 20)));
+	original->AddProperty(new ColorProperty("Color", 216, 216, 216));
+
+	std::vector<PObject*> copies;
+	copies.reserve(kArchivedObjects);
+	int32 allocations = CountAllocations();
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < kArchivedObjects; i++)
+		copies.push_back(original->Duplicate());
+	AddDuplicates(report, "duplicate", kArchivedObjects, system_time() - start,
+		CountAllocations() - allocations);
+
+	allocations = CountAllocations();
+	start = system_time();
+	for (int32 i = 0; i < kArchivedObjects; i++)
+		copies[i]->SetIntProperty("Value", i);
+	AddDuplicates(report, "firstWrite", kArchivedObjects, system_time() - start,
+		CountAllocations() - allocations);
+
+	for (unsigned int i = 0; i < copies.size(); i++)
+		delete copies[i];
+	delete original;
+}
+
+
+struct registry_stress {
+	int32				operations;
+	int32				failures;
+};
+
+
+/*! Registers, looks up and unregisters objects while the other threads do the
+same. A failure is an object that can't be found while it is alive or that is
+still found after it has been deleted. */
+static status_t
+RegistryStressThread(void* data)
+{
+	registry_stress* stress = (registry_stress*)data;
+	PObjectBroker* broker = PObjectBroker::GetBrokerInstance();
+	for (int32 i = 0; i < stress->operations; i++) {
+		PObject* object = new PObject();
+		uint64 id = object->GetID();
+		broker->PublishObject(object);
+		if (broker->FindObject(id) != object)
+			atomic_add(&stress->failures, 1);
+		// objects of the other threads, they may be gone already
+		broker->FindObject(id - 1);
+		broker->FindObject(id + 1);
+		broker->DeleteObject(object);
+		if (broker->FindObject(id) != NULL)
+			atomic_add(&stress->failures, 1);
+	}
+	return B_OK;
+}
+
+
+static void
+RunRegistryStress(BenchmarkReport& report, int32 nThreads, int32 iterations)
+{
+	// lookups in a registry of realistic size
+	PObjectBroker* broker = PObjectBroker::GetBrokerInstance();
+	std::vector<PObject*> liveObjects;
+	for (int32 i = 0; i < kLiveObjects; i++) {
+		liveObjects.push_back(new PObject());
+		broker->PublishObject(liveObjects.back());
+	}
+
+	registry_stress stress;
+	stress.operations = iterations * kRegistryOperations;
+	stress.failures = 0;
+
+	std::vector<thread_id> threads;
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < nThreads; i++) {
+		thread_id thread = spawn_thread(RegistryStressThread,
+			"registry stress", B_NORMAL_PRIORITY, &stress);
+		if (thread < 0)
+			break;
+		threads.push_back(thread);
+		resume_thread(thread);
+	}
+	for (unsigned int i = 0; i < threads.size(); i++) {
+		status_t result;
+		wait_for_thread(threads[i], &result);
+	}
+	AddStress(report, "PObjectBroker", threads.size(), "registryStress",
+		threads.size() * stress.operations, system_time() - start,
+		stress.failures);
+
+	for (unsigned int i = 0; i < liveObjects.size(); i++)
+		broker->DeleteObject(liveObjects[i]);
+}
+
+
+void
+RunObjectBenchmarks(BenchmarkReport& report, int32 iterations)
+{
+	for (int32 nMethods = 4; nMethods <= 64; nMethods *= 4)
+		RunMethodBenchmarks(report, nMethods, iterations);
+	RunEventBenchmarks(report, iterations);
+	for (int32 nTargets = 1; nTargets <= 16; nTargets *= 4)
+		RunAsyncEventBenchmarks(report, nTargets, iterations);
+	RunValueBenchmarks(report, iterations);
+	RunCInterfaceBenchmarks(report, iterations);
+	RunArchiveBenchmarks(report);
+	RunDuplicateBenchmarks(report);
+}
+
+
+void
+RunObjectStress(BenchmarkReport& report, int32 iterations)
+{
+	for (int32 nThreads = 1; nThreads <= 16; nThreads *= 4)
+		RunRegistryStress(report, nThreads, iterations);
+	for (int32 nThreads = 1; nThreads <= 4; nThreads *= 2)
+		RunEventStress(report, nThreads, iterations);
+}
@@ -0,0 +1,569 @@
+/*
+ * Copyright 2012, Clemens Zeidler <haiku@clemens-zeidler.de>
+ * Distributed under the terms of the MIT License.
+ */
+
+
+/*! The component roster: restoring components, socket connections,
+registration, watcher notifications, recycle pools and the icon atlas. The
+default components need the app_server, only the benchmark's own components
+are instantiated. */
+
+
+#include "Benchmark.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include <Bitmap.h>
+#include <Looper.h>
+
+#include <CustomizableRoster.h>
+
+
+using namespace BALM;
+
+
+static void
+AddRoster(BenchmarkReport& report, const char* operation, int32 addOns,
+	int32 components, bigtime_t time)
+{
+	report.BeginEntry();
+	report.AddString("object", "CustomizableRoster");
+	report.AddInt("addOns", addOns);
+	report.AddString("operation", operation);
+	report.AddInt("components", components);
+	report.AddFloat("usPerComponent", double(time) / components, 3);
+	report.EndEntry();
+}
+
+
+static void
+AddSockets(BenchmarkReport& report, const char* operation, int32 components,
+	int32 matches, int32 queries, bigtime_t time)
+{
+	report.BeginEntry();
+	report.AddString("object", "CustomizableRoster");
+	report.AddString("operation", operation);
+	report.AddInt("components", components);
+	report.AddInt("matches", matches);
+	report.AddFloat("usPerQuery", double(time) / queries, 3);
+	report.EndEntry();
+}
+
+
+static void
+AddLayer(BenchmarkReport& report, const char* operation, int32 components,
+	int32 operations, bigtime_t time)
+{
+	report.BeginEntry();
+	report.AddString("object", "Layer");
+	report.AddString("operation", operation);
+	report.AddInt("components", components);
+	report.AddFloat("usPerOperation", double(time) / operations, 3);
+	report.EndEntry();
+}
+
+
+static void
+AddNotifications(BenchmarkReport& report, const char* operation,
+	int32 components, int32 messages, bigtime_t time)
+{
+	report.BeginEntry();
+	report.AddString("object", "CustomizableRoster");
+	report.AddString("operation", operation);
+	report.AddInt("components", components);
+	report.AddInt("messages", messages);
+	report.AddFloat("usPerComponent", double(time) / components, 3);
+	report.EndEntry();
+}
+
+
+static void
+AddPool(BenchmarkReport& report, const char* operation, int32 insertions,
+	bigtime_t time, int32 allocations, const customizable_pool_info& info)
+{
+	report.BeginEntry();
+	report.AddString("object", "CustomizableRoster");
+	report.AddString("operation", operation);
+	report.AddInt("poolSize", info.size);
+	report.AddFloat("usPerInsertion", double(time) / insertions, 3);
+	report.AddFloat("allocationsPerInsertion",
+		double(allocations) / insertions, 2);
+	report.AddInt("hits", info.hits);
+	report.AddInt("misses", info.misses);
+	report.EndEntry();
+}
+
+
+static void
+AddIcons(BenchmarkReport& report, const char* operation, int32 addOns,
+	int32 palettes, bigtime_t time, int32 allocations)
+{
+	report.BeginEntry();
+	report.AddString("object", "CustomizableRoster");
+	report.AddString("operation", operation);
+	report.AddInt("addOns", addOns);
+	report.AddFloat("usPerPalette", double(time) / palettes, 3);
+	report.AddFloat("allocationsPerPalette", double(allocations) / palettes,
+		2);
+	report.EndEntry();
+}
+
+
+const int32 kRestoredComponents = 1000;
+
+
+template<int Index>
+class BenchmarkComponent : public Customizable {
+public:
+	static Customizable* InstantiateCustomizable(const BMessage* archive)
+	{
+		return new BenchmarkComponent;
+	}
+};
+
+
+//! Installs the component types Index down to 1 in the default roster.
+template<int Index>
+struct ComponentInstaller {
+	ComponentInstaller()
+	{
+		CustomizableInstaller<BenchmarkComponent<Index> > installer;
+		ComponentInstaller<Index - 1> next;
+	}
+};
+
+
+template<>
+struct ComponentInstaller<0> {
+};
+
+
+//! The name search InstantiateCustomizable() did before the add-on index.
+static BReference<Customizable>
+InstantiateLinear(CustomizableAddOnList& addOns, const char* name)
+{
+	for (int32 i = 0; i < addOns.CountItems(); i++) {
+		CustomizableAddOn* addOn = addOns.ItemAt(i);
+		if (addOn->Name() == name)
+			return addOn->InstantiateCustomizable(NULL);
+	}
+	return NULL;
+}
+
+
+/*! Restores components by name like loading a layout does, from a roster with
+the benchmark's component types installed after the default ones. */
+static void
+RunRestoreBenchmarks(BenchmarkReport& report)
+{
+	CustomizableRoster* roster = CustomizableRoster::DefaultRoster();
+	CustomizableAddOnList addOns;
+	roster->GetInstalledCustomizableList(addOns);
+	int32 defaultAddOns = addOns.CountItems();
+
+	ComponentInstaller<32> installer;
+	roster->GetInstalledCustomizableList(addOns);
+
+	// the default components need the app_server, only the benchmark's own
+	// components are restored
+	std::vector<BString> names;
+	for (int32 i = defaultAddOns; i < addOns.CountItems(); i++)
+		names.push_back(addOns.ItemAt(i)->Name());
+
+	std::vector<BReference<Customizable> > components;
+	components.reserve(kRestoredComponents);
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < kRestoredComponents; i++) {
+		components.push_back(roster->InstantiateCustomizable(
+			names[i % names.size()].String()));
+	}
+	AddRoster(report, "restoreByName", addOns.CountItems(), kRestoredComponents,
+		system_time() - start);
+	components.clear();
+
+	start = system_time();
+	for (int32 i = 0; i < kRestoredComponents; i++) {
+		components.push_back(InstantiateLinear(addOns,
+			names[i % names.size()].String()));
+	}
+	AddRoster(report, "restoreLinearSearch", addOns.CountItems(),
+		kRestoredComponents, system_time() - start);
+	components.clear();
+}
+
+
+const int32 kSocketInterfaces = 16;
+
+
+class SocketComponent : public Customizable {
+public:
+	SocketComponent(const char* interface)
+	{
+		AddInterface(interface);
+	}
+};
+
+
+//! The search GetCompatibleConnections() did before the interface index.
+static void
+GetCompatibleLinear(CustomizableRoster* roster, Customizable::Socket* socket,
+	CustomizableList& list)
+{
+	BArray<BWeakReference<Customizable> > allCustomizable;
+	roster->GetCustomizableList(allCustomizable);
+	for (int32 i = 0; i < allCustomizable.CountItems(); i++) {
+		BReference<Customizable> customizable
+			= allCustomizable.ItemAt(i).GetReference();
+		if (customizable == NULL)
+			continue;
+		if (customizable->UsesInterface(socket->Interface()) == true)
+			list.AddItem(customizable);
+	}
+}
+
+
+/*! Looks up the compatible connections of a socket among nComponents live
+components that implement one of kSocketInterfaces interfaces each. */
+static void
+RunSocketBenchmarks(BenchmarkReport& report, int32 nComponents,
+	int32 iterations)
+{
+	CustomizableRoster* roster = CustomizableRoster::DefaultRoster();
+	std::vector<BReference<Customizable> > components;
+	for (int32 i = 0; i < nComponents; i++) {
+		BString interface;
+		interface << "BenchmarkInterface" << i % kSocketInterfaces;
+		components.push_back(BReference<Customizable>(
+			new SocketComponent(interface), true));
+	}
+
+	SocketComponent parent("BenchmarkParent");
+	Customizable::Socket socket(&parent, "socket", "BenchmarkInterface0", 0,
+		-1);
+
+	const int32 queries = 100 * iterations;
+	CustomizableList list;
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < queries; i++) {
+		list.MakeEmpty();
+		roster->GetCompatibleConnections(&socket, list);
+	}
+	AddSockets(report, "compatibleConnections", nComponents, list.CountItems(),
+		queries, system_time() - start);
+
+	start = system_time();
+	for (int32 i = 0; i < queries; i++) {
+		list.MakeEmpty();
+		GetCompatibleLinear(roster, &socket, list);
+	}
+	AddSockets(report, "compatibleLinearSearch", nComponents,
+		list.CountItems(), queries, system_time() - start);
+}
+
+
+/*! Registers and unregisters nComponents components, oldest first, and
+refreshes a view of the registered components. The "Arrays" operations
+repeat this on the parallel arrays the layer used before its slot map. */
+static void
+RunLayerBenchmarks(BenchmarkReport& report, int32 nComponents,
+	int32 iterations)
+{
+	CustomizableRoster* roster = CustomizableRoster::DefaultRoster();
+	std::vector<Customizable*> components;
+	components.reserve(nComponents);
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < nComponents; i++)
+		components.push_back(new BenchmarkComponent<1>);
+	for (int32 i = 0; i < nComponents; i++)
+		components[i]->ReleaseReference();
+	AddLayer(report, "registerUnregister", nComponents, nComponents,
+		system_time() - start);
+
+	components.clear();
+	for (int32 i = 0; i < nComponents; i++)
+		components.push_back(new BenchmarkComponent<1>);
+
+	CustomizableList list;
+	BArray<BWeakReference<Customizable> > refs;
+	start = system_time();
+	for (int32 i = 0; i < nComponents; i++) {
+		list.AddItem(components[i]);
+		refs.AddItem(components[i]);
+	}
+	for (int32 i = 0; i < nComponents; i++) {
+		int32 index = list.IndexOf(components[i]);
+		list.RemoveItemAt(index);
+		refs.RemoveItemAt(index);
+	}
+	AddLayer(report, "registerUnregisterArrays", nComponents, nComponents,
+		system_time() - start);
+
+	const int32 refreshes = 10 * iterations;
+	int32 live = 0;
+	start = system_time();
+	for (int32 i = 0; i < refreshes; i++) {
+		BReference<CustomizableSnapshot> snapshot
+			= roster->GetCustomizableSnapshot();
+		for (int32 j = 0; j < snapshot->CountItems(); j++) {
+			if (snapshot->ItemAt(j) != NULL)
+				live++;
+		}
+	}
+	AddLayer(report, "refreshSnapshot", nComponents, refreshes,
+		system_time() - start);
+
+	start = system_time();
+	for (int32 i = 0; i < refreshes; i++) {
+		BArray<BWeakReference<Customizable> > all;
+		roster->GetCustomizableList(all);
+		for (int32 j = 0; j < all.CountItems(); j++) {
+			if (all.ItemAt(j).GetReference() != NULL)
+				live++;
+		}
+	}
+	AddLayer(report, "refreshCopy", nComponents, refreshes,
+		system_time() - start);
+
+	for (int32 i = 0; i < nComponents; i++)
+		components[i]->ReleaseReference();
+}
+
+
+class PoolComponent : public Customizable {
+public:
+	static Customizable* InstantiateCustomizable(const BMessage* archive)
+	{
+		return new PoolComponent;
+	}
+
+	virtual status_t Reset()
+	{
+		return B_OK;
+	}
+};
+
+
+/*! Instantiates a component and gives it back, like dragging a new component
+over the editor without dropping it does, once without and once with a
+recycle pool. */
+static void
+RunPoolBenchmarks(BenchmarkReport& report, int32 iterations)
+{
+	CustomizableRoster* roster = CustomizableRoster::DefaultRoster();
+	CustomizableInstaller<PoolComponent> installer;
+	CustomizableAddOnList addOns;
+	roster->GetInstalledCustomizableList(addOns);
+	BString name = addOns.LastItem()->Name();
+
+	const int32 insertions = 100 * iterations;
+	const int32 poolSizes[] = { 0, 8 };
+	for (unsigned int p = 0; p < sizeof(poolSizes) / sizeof(poolSizes[0]);
+		p++) {
+		roster->SetPoolSize(name, poolSizes[p]);
+		customizable_pool_info before;
+		roster->GetPoolInfo(name, &before);
+
+		int32 allocations = CountAllocations();
+		bigtime_t start = system_time();
+		for (int32 i = 0; i < insertions; i++) {
+			BReference<Customizable> component
+				= roster->InstantiateCustomizable(name);
+			roster->RecycleCustomizable(component);
+		}
+		bigtime_t time = system_time() - start;
+		allocations = CountAllocations() - allocations;
+
+		customizable_pool_info info;
+		roster->GetPoolInfo(name, &info);
+		info.hits -= before.hits;
+		info.misses -= before.misses;
+		AddPool(report, "instantiateAndRecycle", insertions, time, allocations,
+			info);
+	}
+	roster->SetPoolSize(name, 0);
+}
+
+
+const int32 kIconSize = 32;
+static unsigned char sIconBits[kIconSize * kIconSize * 4];
+
+
+template<int Index>
+class IconComponent : public Customizable {
+public:
+	static Customizable* InstantiateCustomizable(const BMessage* archive)
+	{
+		return new IconComponent;
+	}
+};
+
+
+//! Installs the component types Index down to 1 with an icon each.
+template<int Index>
+struct IconComponentInstaller {
+	IconComponentInstaller()
+	{
+		CustomizableInstaller<IconComponent<Index> > installer(sIconBits,
+			BRect(0, 0, kIconSize - 1, kIconSize - 1));
+		IconComponentInstaller<Index - 1> next;
+	}
+};
+
+
+template<>
+struct IconComponentInstaller<0> {
+};
+
+
+/*! Gets the icons of all add-ons like building the component palette does.
+Before the icon atlas every palette decoded the icon of each add-on into its
+own bitmap. */
+void
+RunIconBenchmarks(BenchmarkReport& report, int32 iterations)
+{
+	for (int32 i = 0; i < kIconSize * kIconSize * 4; i++)
+		sIconBits[i] = rand() % 256;
+
+	CustomizableRoster* roster = CustomizableRoster::DefaultRoster();
+	IconComponentInstaller<128> installer;
+	CustomizableAddOnList addOns;
+	roster->GetInstalledCustomizableList(addOns);
+
+	const int32 palettes = 10 * iterations;
+	int32 allocations = CountAllocations();
+	bigtime_t start = system_time();
+	for (int32 p = 0; p < palettes; p++) {
+		for (int32 i = 0; i < addOns.CountItems(); i++) {
+			const unsigned char* bits;
+			BRect frame;
+			if (!addOns.ItemAt(i)->IconData(&bits, frame))
+				continue;
+			BBitmap bitmap(frame, B_RGBA32);
+			memcpy(bitmap.Bits(), bits, bitmap.BitsLength());
+		}
+	}
+	AddIcons(report, "decodePerAddOn", addOns.CountItems(), palettes,
+		system_time() - start, CountAllocations() - allocations);
+
+	allocations = CountAllocations();
+	start = system_time();
+	BReference<CustomizableIconAtlas> atlas = roster->GetIconAtlas();
+	AddIcons(report, "decodeAtlas", addOns.CountItems(), 1,
+		system_time() - start, CountAllocations() - allocations);
+	if (atlas.Get() == NULL)
+		return;
+
+	allocations = CountAllocations();
+	start = system_time();
+	for (int32 p = 0; p < palettes; p++) {
+		BReference<CustomizableIconAtlas> shared = roster->GetIconAtlas();
+		for (int32 i = 0; i < addOns.CountItems(); i++) {
+			BRect frame;
+			shared->IconFrame(addOns.ItemAt(i), frame);
+		}
+	}
+	AddIcons(report, "sharedAtlas", addOns.CountItems(), palettes,
+		system_time() - start, CountAllocations() - allocations);
+}
+
+
+//! Counts the roster notifications and the changes they carried.
+class RosterWatcher : public BHandler {
+public:
+	RosterWatcher()
+		:
+		BHandler("roster watcher"),
+		fMessages(0),
+		fAdded(0),
+		fRemoved(0)
+	{
+	}
+
+	virtual void MessageReceived(BMessage* message)
+	{
+		if (message->what != B_CUSTOMIZABLE_LIST_CHANGED) {
+			BHandler::MessageReceived(message);
+			return;
+		}
+		BMessage changes;
+		CustomizableRoster::DefaultRoster()->GetChanges(this, &changes);
+		type_code type;
+		int32 count;
+		atomic_add(&fMessages, 1);
+		if (changes.GetInfo("added", &type, &count) == B_OK)
+			atomic_add(&fAdded, count);
+		if (changes.GetInfo("removed", &type, &count) == B_OK)
+			atomic_add(&fRemoved, count);
+	}
+
+	int32 Messages() { return atomic_get(&fMessages); }
+	int32 Added() { return atomic_get(&fAdded); }
+	int32 Removed() { return atomic_get(&fRemoved); }
+
+private:
+	int32	fMessages;
+	int32	fAdded;
+	int32	fRemoved;
+};
+
+
+/*! Adds and then removes nComponents components like loading and clearing a
+layout does, while a watcher's looper is busy. The watcher should get one
+message for each of both steps. */
+static void
+RunNotificationBenchmarks(BenchmarkReport& report, int32 nComponents)
+{
+	BLooper* looper = new BLooper("roster watcher");
+	RosterWatcher* watcher = new RosterWatcher;
+	looper->AddHandler(watcher);
+	looper->Run();
+	CustomizableRoster* roster = CustomizableRoster::DefaultRoster();
+	roster->StartWatching(watcher);
+
+	std::vector<Customizable*> components;
+	components.reserve(nComponents);
+	looper->Lock();
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < nComponents; i++)
+		components.push_back(new BenchmarkComponent<1>);
+	looper->Unlock();
+	while (watcher->Added() < nComponents)
+		snooze(100);
+	AddNotifications(report, "addComponents", nComponents,
+		watcher->Messages(), system_time() - start);
+
+	int32 messages = watcher->Messages();
+	looper->Lock();
+	start = system_time();
+	for (int32 i = 0; i < nComponents; i++)
+		components[i]->ReleaseReference();
+	looper->Unlock();
+	while (watcher->Removed() < nComponents)
+		snooze(100);
+	AddNotifications(report, "removeComponents", nComponents,
+		watcher->Messages() - messages, system_time() - start);
+
+	roster->StopWatching(watcher);
+	looper->Lock();
+	looper->RemoveHandler(watcher);
+	delete watcher;
+	looper->Quit();
+}
+
+
+void
+RunRosterBenchmarks(BenchmarkReport& report, int32 iterations)
+{
+	RunRestoreBenchmarks(report);
+	for (int32 nComponents = 100; nComponents <= 10000; nComponents *= 10)
+		RunSocketBenchmarks(report, nComponents, iterations);
+	for (int32 nComponents = 100; nComponents <= 10000; nComponents *= 10)
+		RunLayerBenchmarks(report, nComponents, iterations);
+	for (int32 nComponents = 100; nComponents <= 10000; nComponents *= 10)
+		RunNotificationBenchmarks(report, nComponents);
+	RunPoolBenchmarks(report, iterations);
+}
@@ -120,6 +120,69 @@ int32					replace_parg_list(void *args, const char *name, void *list);
 int32					replace_parg_color(void *args, const char *name, unsigned char red,
 										unsigned char green, unsigned char blue,
 										unsigned char alpha);
+
+
+/* -------------------------------------------------------------------------------------
+	Field handles: a field name resolved once with parg_field() can be used in tight
+	loops without looking the name up again. Handles live as long as the program does.
+	The string functions copy the string on add and return a pointer into the
+	arguments on find.
+   ------------------------------------------------------------------------------------- */
+typedef int32 parg_field_handle;
+
+parg_field_handle		parg_field(const char *name);
+
+int32					add_parg_data_field(void *args, parg_field_handle field, int32 type,
+										const void *data, int32 size);
+int32					add_parg_char_field(void *args, parg_field_handle field, char arg);
+int32					add_parg_int8_field(void *args, parg_field_handle field, int8 arg);
+int32					add_parg_int16_field(void *args, parg_field_handle field, int16 arg);
+int32					add_parg_int32_field(void *args, parg_field_handle field, int32 arg);
+int32					add_parg_int64_field(void *args, parg_field_handle field, int64 arg);
+int32					add_parg_bool_field(void *args, parg_field_handle field, bool arg);
+int32					add_parg_float_field(void *args, parg_field_handle field, float arg);
+int32					add_parg_double_field(void *args, parg_field_handle field, double arg);
+int32					add_parg_pointer_field(void *args, parg_field_handle field, void *ptr);
+int32					add_parg_string_field(void *args, parg_field_handle field,
+											const char *arg);
+
+int32					find_parg_data_field(void *args, parg_field_handle field, int32 type,
+										const void **data, int32 *size, int32 index);
+int32					find_parg_char_field(void *args, parg_field_handle field, char *out);
+int32					find_parg_int8_field(void *args, parg_field_handle field, int8 *out);
+int32					find_parg_int16_field(void *args, parg_field_handle field, int16 *out);
+int32					find_parg_int32_field(void *args, parg_field_handle field, int32 *out);
+int32					find_parg_int64_field(void *args, parg_field_handle field, int64 *out);
+int32					find_parg_bool_field(void *args, parg_field_handle field, bool *out);
+int32					find_parg_float_field(void *args, parg_field_handle field, float *out);
+int32					find_parg_double_field(void *args, parg_field_handle field, double *out);
+int32					find_parg_pointer_field(void *args, parg_field_handle field, void **ptr);
+int32					find_parg_string_field(void *args, parg_field_handle field,
+											const char **arg);
+
+int32					replace_parg_data_field(void *args, parg_field_handle field,
+											int32 type, const void *data, int32 size,
+											int32 index);
+
+/*
+	Bulk transfer between the arguments and a C struct. Every descriptor names a field,
+	its type and where the member is in the struct, e.g. offsetof(). B_STRING_TYPE
+	members are const char pointers, all others are copied as size bytes, so rects,
+	points and colors have to be laid out like BRect, BPoint and rgb_color. Stops at
+	the first field that fails and returns its error.
+*/
+typedef struct parg_field_desc
+{
+	parg_field_handle	field;
+	int32				type;
+	int32				offset;
+	int32				size;
+} parg_field_desc;
+
+int32					add_parg_fields(void *args, const parg_field_desc *fields,
+										int32 count, const void *values);
+int32					find_parg_fields(void *args, const parg_field_desc *fields,
+										int32 count, void *values);
 #if defined(__cplusplus)
 	}
 #endif
@@ -8,6 +8,14 @@
 #include <InterfaceDefs.h>
 #include <String.h>
 
+#include "PAtom.h"
+
+/*
+	The arguments are kept in a flat buffer inside the object and the fields are
+	found by name atom, so synchronous calls don't go through BMessage at all.
+	The BMessage backend is only built when it is asked for, e.g. to send the
+	arguments to another looper.
+*/
 class PArgs
 {
 public:
@@ -121,11 +129,80 @@ public:
 									int32 &fieldIndex);
 	status_t			RemoveOrderInfo(const int32 &index);
 	
+	// Fast path for hot callers like the C bindings: intern the field name
+	// once with intern_atom() and use the atom from then on.
+	status_t			AddDataByAtom(const atom_t &name, type_code type,
+									const void *data, int32 numBytes,
+									bool fixedSize = false);
+	status_t			FindDataByAtom(const atom_t &name, type_code type,
+									const void **data, int32 *numBytes,
+									const int32 index = 0) const;
+	status_t			ReplaceDataByAtom(const atom_t &name, type_code type,
+									const void *data, int32 numBytes,
+									int32 index = 0);
+	
 	void				SetBackend(const BMessage &msg);
 	BMessage			GetBackend(void) const;
 	
 private:
-	BMessage			fBackend;
+	struct field
+	{
+		atom_t			name;
+		type_code		type;
+		int32			offset;
+		int32			size;
+		bool			fixedSize;
+	};
+	
+	enum
+	{
+		INLINE_FIELDS = 16,
+		INLINE_DATA = 256
+	};
+	
+	status_t			AddItem(const char *name, type_code type,
+								const void *data, int32 size, bool fixedSize);
+	status_t			AddItemByAtom(const atom_t &name, type_code type,
+								const void *data, int32 size, bool fixedSize);
+	status_t			FindItem(const char *name, type_code type, int32 index,
+								const void **data, int32 *size) const;
+	status_t			FindItemByAtom(const atom_t &name, type_code type,
+								int32 index, const void **data,
+								int32 *size) const;
+	status_t			FindValue(const char *name, type_code type, int32 index,
+								void *value, int32 size) const;
+	status_t			ReplaceItem(const char *name, type_code type,
+								int32 index, const void *data, int32 size);
+	status_t			ReplaceItemByAtom(const atom_t &name, type_code type,
+								int32 index, const void *data, int32 size);
+	status_t			RemoveItem(const char *name, int32 index, bool all);
+	int32				FieldIndex(const atom_t &name, int32 index) const;
+	int32				CountItems(const atom_t &name) const;
+	int32				AppendData(const void *data, int32 size);
+	void				CompactData(int32 reserve);
+	bool				ReserveFields(int32 count);
+	bool				ReserveData(int32 size);
+	
+	field				fInlineFields[INLINE_FIELDS];
+	field				*fFields;
+	int32				fFieldCount,
+						fFieldCapacity;
+	
+	union
+	{
+		char			fInlineData[INLINE_DATA];
+		// Keeps the data aligned for the values in it
+		int64			fAlignment;
+	};
+	char				*fData;
+	int32				fDataSize,
+						fDataCapacity,
+						// Left behind by replaced and removed items
+						fUnusedData;
+	
+	// Only allocated once the backend is asked for
+	mutable BMessage	*fBackend;
+	mutable bool		fBackendValid;
 };
 
 #endif
@@ -0,0 +1,31 @@
+#ifndef PATOM_H
+#define PATOM_H
+
+#include <SupportDefs.h>
+
+/*
+	Atoms are interned strings. Equal strings always get the same atom, so names
+	can be compared as integers. Atoms live as long as the program does.
+*/
+typedef int32 atom_t;
+
+enum
+{
+	ATOM_INVALID = -1
+};
+
+atom_t			intern_atom(const char *string);
+
+// Returns ATOM_INVALID if the string has never been interned
+atom_t			find_atom(const char *string);
+
+const char *	atom_string(const atom_t &atom);
+
+// The atom of the lower case string, for case-insensitive comparisons
+atom_t			fold_atom(const atom_t &atom);
+
+// The folded atom of a string in any case, without interning it. Returns
+// ATOM_INVALID if no case variant of the string has been interned.
+atom_t			find_folded_atom(const char *string);
+
+#endif
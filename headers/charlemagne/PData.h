@@ -3,9 +3,12 @@
 
 
 #include <Handler.h>
+#include <HashMap.h>
 #include <Message.h>
 #include <String.h>
+#include <vector>
 #include "ObjectList.h"
+#include "PAtom.h"
 #include "PProperty.h"
 
 enum
@@ -16,14 +19,24 @@ enum
 };
 
 
+/*
+	A property slot. Duplicates of an object share the slots of the original
+	until one of them changes a property, refCount counts the objects using a
+	slot. Once a pointer to the property has been handed out the slot is
+	exposed: it could be changed behind the object's back, so it is never
+	shared again.
+*/
 class PropertyData
 {
 public:
-	PropertyData(PProperty *p, uint32 f) { value = p; flags = f; }
+	PropertyData(PProperty *p, uint32 f)
+		{ value = p; flags = f; refCount = 1; exposed = false; }
 	~PropertyData(void) { delete value; }
 	
 	PProperty 	*value;
 	uint32 		flags;
+	int32		refCount;
+	bool		exposed;
 };
 
 
@@ -46,12 +59,25 @@ public:
 	static	BArchivable *	Instantiate(BMessage *data);
 	virtual	status_t		Archive(BMessage *data, bool deep = true) const;
 	
+	// Compact form for archives of many objects: only the values are archived,
+	// the property layout goes to schemas once per type. See PPropertySchema.
+	virtual	status_t		ArchiveValues(BMessage *data, BMessage *schemas) const;
+	
 			int32			CountProperties(const char *name = NULL) const;
 			PProperty *		PropertyAt(const int32 &index) const;
 			int32			IndexOfProperty(PProperty *p) const;
 			
 			PProperty *		FindProperty(const BString &name, const int32 &index = 0) const;
 			PProperty *		FindProperty(const char *name, const int32 &index = 0) const;
+			
+			// Fast path for hot callers: intern the name once with intern_atom()
+			// and use the atom from then on.
+			PProperty *		FindPropertyByAtom(const atom_t &name,
+											const int32 &index = 0) const;
+			status_t		SetPropertyByAtom(const atom_t &name, PValue *value,
+											const int32 &index = 0);
+			status_t		GetPropertyByAtom(const atom_t &name, PValue *value,
+											const int32 &index = 0) const;
 	
 	virtual	bool			AddProperty(PProperty *p, uint32 flags = 0,int32 index = -1);
 	virtual PProperty *		RemoveProperty(const int32 &index);
@@ -88,15 +114,46 @@ public:
 	virtual	void			PrintToStream(void);
 	
 protected:
+			int32			FindPropertySlot(const atom_t &name,
+											const int32 &index = 0) const;
+			
+			// Doesn't unshare the property, so it must not be changed
+			PProperty *		SharedPropertyAt(const int32 &index) const;
+			
+			// Puts p in the slot at index, the old property is deleted
+			void			ReplaceProperty(const int32 &index, PProperty *p,
+											uint32 flags = 0);
+			
 	BString					fType;
 	BString					fFriendlyType;
 	
 private:
-#if B_HAIKU_VERSION > B_HAIKU_VERSION_1_BETA_5
-	BObjectList<PropertyData, true>	*fPropertyList;
-#else
-	BObjectList<PropertyData>	*fPropertyList;
-#endif
+	friend class PPropertySchema;
+	friend class PProperty;
+	
+			void			ShareProperties(const PData &from);
+			void			ReleaseProperties(void);
+			// Const readers may call it concurrently
+			PropertyData *	MakePropertyPrivate(const int32 &index,
+												bool expose = false) const;
+			PProperty *		ExposePropertyAt(const int32 &index) const;
+			
+			// Called by a property of this object when it got a new name
+			void			PropertyRenamed(PProperty *p);
+			void			IndexProperty(const int32 &index);
+			void			RebuildIndex(void);
+	
+	// The slots are reference counted, see PropertyData
+	BObjectList<PropertyData>		*fPropertyList;
+	
+	// Property slots by name atom. Every change of the list or of a name
+	// updates them right away, so lookups only read them.
+	typedef BPrivate::HashMap<BPrivate::HashKey32<atom_t>,
+								std::vector<int32> > PropertyIndex;
+	typedef BPrivate::HashMap<BPrivate::HashKey32<atom_t>, int32>
+								FoldedCounts;
+	PropertyIndex					fPropertyIndex;
+	FoldedCounts					fFoldedCounts;
 };
 
 
@@ -7,6 +7,7 @@
 #include "CInterface.h"
 #include "ObjectList.h"
 #include "PArgs.h"
+#include "PAtom.h"
 
 class PObject;
 
@@ -120,6 +121,11 @@ public:
 	virtual	void			SetName(const char *name);
 			void			SetName(const BString &name);
 			BString			GetName(void) const;
+			atom_t			GetNameAtom(void) const;
+			
+	// Bumped whenever a method is renamed, so cached method tables can
+	// detect stale names.
+	static	int32			NameGeneration(void);
 	
 	virtual	void				SetInterface(PMethodInterface &interface);
 			PMethodInterface	GetInterface(void) const;
@@ -145,6 +151,7 @@ private:
 			MethodFunction		fFunction;
 			uint32				fFlags;
 			PMethodInterface	fInterface;
+			atom_t				fNameAtom;
 };
 
 
@@ -40,6 +40,10 @@ public:
 };
 
 
+class PMethodLists;
+class PMethodTable;
+
+
 void InitObjectSystem(void);
 void ShutdownObjectSystem(void);
 
@@ -62,18 +66,26 @@ public:
 	
 	static	BArchivable *	Instantiate(BMessage *data);
 	virtual	status_t		Archive(BMessage *data, bool deep = true) const;
+	virtual	status_t		ArchiveValues(BMessage *data, BMessage *schemas) const;
 	
 			uint64			GetID(void) const;
 	
 	virtual	status_t		RunMethod(const char *name, PArgs &in, PArgs &out,
 										void *extraData = NULL);
 			PMethod *		FindMethod(const char *name);
+			
+			// Resolve a method once with FindMethod() or FindMethodByAtom() and
+			// run it through the returned handle to skip the name lookup.
+			PMethod *		FindMethodByAtom(const atom_t &name);
+			status_t		RunMethod(PMethod *method, PArgs &in, PArgs &out,
+										void *extraData = NULL);
 			PMethod *		MethodAt(const int32 &index) const;
 			int32			CountMethods(void) const;
 			
 	virtual	status_t		RunInheritedMethod(const char *name, PArgs &in, PArgs &out,
 												void *extraData);
 			PMethod *		FindInheritedMethod(const char *name);
+			PMethod *		FindInheritedMethodByAtom(const atom_t &name);
 			PMethod *		InheritedMethodAt(const int32 &index) const;
 			int32			CountInheritedMethods(void) const;
 			
@@ -101,8 +113,11 @@ public:
 			void			ConvertArgsToMsg(PArgs &in, BMessage &out);
 			
 protected:
-			void			AddInterface(const char *name);
-			void			RemoveInterface(const char *name);
+	// Duplicates share the methods, interfaces and inherited methods of the
+	// original until one of them changes them with these functions. Methods
+	// must not be changed in any other way.
+	virtual	void			AddInterface(const char *name);
+	virtual	void			RemoveInterface(const char *name);
 	
 	virtual	status_t		AddMethod(PMethod *method);
 	virtual	status_t		RemoveMethod(const char *name);
@@ -117,21 +132,34 @@ protected:
 	BString					fFriendlyType;
 	
 private:
+			PMethodTable *	GetMethodTable(void);
+			void			InvalidateMethodTable(void);
+			
+			void			SetMethodLists(PMethodLists *lists);
+			void			MakeMethodsPrivate(void);
+			void			SetObjectIDProperty(void);
+			
 	friend class PObjectBroker;
 	uint64						fObjectID;
+	
+	// fMethodList, fInheritedList and fInterfaceList belong to fMethodLists
+	PMethodLists				*fMethodLists;
 #if B_HAIKU_VERSION > B_HAIKU_VERSION_1_BETA_5
-	BObjectList<PropertyData, true>	*fPropertyList;
 	BObjectList<PMethod, true>		*fMethodList;
 	BObjectList<PMethod, true>		*fInheritedList;
 	BObjectList<BString, true>		*fInterfaceList;
 	BObjectList<EventData, true>	*fEventList;
 #else
-	BObjectList<PropertyData>	*fPropertyList;
 	BObjectList<PMethod>		*fMethodList;
 	BObjectList<PMethod>		*fInheritedList;
 	BObjectList<BString>		*fInterfaceList;
 	BObjectList<EventData>		*fEventList;
 #endif
+	
+	// Method slots by name atom, shared with the other objects of the same
+	// type and methods. Tables are never deleted, see PMethodTable.
+	PMethodTable				*fMethodTable;
+	int32						fMethodGeneration;
 };
 
 // Convenience functions
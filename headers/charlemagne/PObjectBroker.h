@@ -1,10 +1,13 @@
 #ifndef POBJECTBROKER_H
 #define POBJECTBROKER_H
 
+#include <HashMap.h>
+#include <Locker.h>
 #include <Looper.h>
 #include <String.h>
 
 #include "ObjectList.h"
+#include "PAtom.h"
 #include "PProperty.h"
 #include "PObject.h"
 
@@ -41,29 +44,68 @@ public:
 						~PObjectBroker(void);
 	
 	PObject *			MakeObject(const char *type, BMessage *msg = NULL);
+	PObject *			MakeObject(const atom_t &type, BMessage *msg = NULL);
+	
+	// Makes count objects of one type with a single type lookup. Returns the
+	// number of objects stored in the objects array.
+	int32				MakeObjects(const char *type, const int32 &count,
+									PObject **objects);
+	int32				MakeObjects(const atom_t &type, const int32 &count,
+									PObject **objects);
+	
+	status_t			AddType(const char *type, const char *friendlyType,
+								MakeFromArchiveFunc arcfunc,
+								MakeObjectFunc createfunc);
 	int32				CountTypes(void) const;
 	BString				TypeAt(const int32 &index) const;
 	BString				FriendlyTypeAt(const int32 &index) const;
 	
+	// Safe to call from any thread, only the shard of the id is locked
 	PObject *			FindObject(const uint64 &id);
+	int32				CountObjects(void) const;
 	
 	static	PObjectBroker *	GetBrokerInstance(void);
+	
+	// Only hands out the id, the constructor of PObject calls it. An object
+	// can't be found until it is published once it is fully constructed.
+	// MakeObject() and MakeObjects() publish the objects they make.
 	static	void		RegisterObject(PObject *obj);
+			void		PublishObject(PObject *obj);
 			void		UnregisterObject(PObject *obj);
+	// Unregisters the object before it is deleted, so no other thread finds
+	// it while its destructors run
+			void		DeleteObject(PObject *obj);
 	
 			void		MessageReceived(BMessage *msg);
 	
 private:
+	class ObjectShard;
+	
+	enum
+	{
+		// Live objects are spread over the shards by id, so threads working
+		// on different objects rarely wait for each other.
+		OBJECT_SHARD_COUNT = 16
+	};
 
 #if B_HAIKU_VERSION > B_HAIKU_VERSION_1_BETA_5
-	BObjectList<PObject, true>		*fObjectList;
 	BObjectList<PObjectInfo, true>	*fObjInfoList;
 #else
-	BObjectList<PObject>		*fObjectList;
 	BObjectList<PObjectInfo>	*fObjInfoList;
 #endif
+	// Types by folded type atom, type names are case-insensitive
+	HashMap<HashKey32<atom_t>, PObjectInfo*>	fTypeIndex;
+	mutable BLocker		fTypeLock;
+	ObjectShard			*fShards;
 	
 	PObjectInfo *		FindObjectInfo(const char *type);
+	PObjectInfo *		FindObjectInfo(const atom_t &type);
+	ObjectShard *		ShardFor(const uint64 &id) const;
+			void		AddObject(PObject *obj, bool owned);
+			void		AddObjects(PObject **objects, const int32 &count,
+								bool owned);
+	static	void		AddLocked(ObjectShard &shard, PObject *obj,
+								bool owned);
 	
 	bool				fQuitting;
 	PObject				*pApp;
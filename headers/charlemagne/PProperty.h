@@ -6,8 +6,10 @@
 #include <String.h>
 
 #include "ObjectList.h"
+#include "PAtom.h"
 #include "PValue.h"
 
+class PData;
 class PObject;
 
 class PProperty : public BArchivable
@@ -28,6 +30,7 @@ public:
 	virtual	void			SetName(const BString &name);
 			void			SetName(const char *name);
 			BString			GetName(void) const;
+			atom_t			GetNameAtom(void) const;
 	
 			bool			IsReadOnly(void) const;
 			void			SetReadOnly(const bool &value);
@@ -48,9 +51,16 @@ public:
 	virtual	BString			GetDescription(void);
 
 private:
+	friend class PData;
+	
 	BString					*fType,
 							*fName,
 							*fDescription;
+	atom_t					fNameAtom;
+	
+	// The object that has this property to itself, it indexes the property by
+	// its name. Shared properties are never renamed, see PropertyData.
+	PData					*fOwner;
 	bool					fReadOnly,
 							fEnabled;
 };
@@ -65,6 +75,7 @@ public:
 							StringProperty(const BString &name, const BString &value);
 							StringProperty(PValue *value);
 							StringProperty(BMessage *msg);
+							StringProperty(const StringProperty &from);
 							~StringProperty(void);
 	
 	static	PProperty *		Create(void);
@@ -92,6 +103,7 @@ public:
 							CharProperty(const char *name, const char &value,
 										const char *desc = NULL);
 							CharProperty(BMessage *msg);
+							CharProperty(const CharProperty &from);
 	virtual					~CharProperty(void);
 	
 	static	PProperty *		Create(void);
@@ -118,6 +130,7 @@ public:
 							BoolProperty(const char *name, const bool &value,
 										const char *desc = NULL);
 							BoolProperty(BMessage *msg);
+							BoolProperty(const BoolProperty &from);
 	virtual					~BoolProperty(void);
 	
 	static	PProperty *		Create(void);
@@ -144,6 +157,7 @@ public:
 							IntProperty(const char *name, const int64 &value,
 										const char *desc = NULL);
 							IntProperty(BMessage *msg);
+							IntProperty(const IntProperty &from);
 	virtual					~IntProperty(void);
 	
 	static	PProperty *		Create(void);
@@ -170,6 +184,7 @@ public:
 							FloatProperty(const char *name, const float &value,
 										const char *desc = NULL);
 							FloatProperty(BMessage *msg);
+							FloatProperty(const FloatProperty &from);
 	virtual					~FloatProperty(void);
 	
 	static	PProperty *		Create(void);
@@ -198,6 +213,7 @@ public:
 							ColorProperty(const char *name, const uint8 &red, const uint8 &green,
 										const uint8 &blue, const char *desc = NULL);
 							ColorProperty(BMessage *msg);
+							ColorProperty(const ColorProperty &from);
 	virtual					~ColorProperty(void);
 	
 	static	PProperty *		Create(void);
@@ -224,6 +240,7 @@ public:
 							RectProperty(const char *name, const BRect &value,
 										const char *desc = NULL);
 							RectProperty(BMessage *msg);
+							RectProperty(const RectProperty &from);
 	virtual					~RectProperty(void);
 	
 	static	PProperty *		Create(void);
@@ -250,6 +267,7 @@ public:
 							PointProperty(const char *name, const BPoint &value,
 										const char *desc = NULL);
 							PointProperty(BMessage *msg);
+							PointProperty(const PointProperty &from);
 	virtual					~PointProperty(void);
 	
 	static	PProperty *		Create(void);
@@ -0,0 +1,68 @@
+#ifndef PPROPERTYSCHEMA_H
+#define PPROPERTYSCHEMA_H
+
+#include <Message.h>
+#include <String.h>
+#include <TypeConstants.h>
+
+#include <vector>
+
+class PData;
+
+/*
+	The property layout of an object type: the class, name, description, flags
+	and value field of every property. When many objects of a type are
+	archived the schema is written only once and every object just stores a
+	row of values that refers to the schema by its ID.
+
+	Schemas of an archive have to be registered with RegisterSchemas() before
+	its rows are instantiated. Registered schemas live as long as the program
+	does.
+*/
+class PPropertySchema
+{
+public:
+							PPropertySchema(const BString &type,
+										const PData *data);
+							PPropertySchema(BMessage *msg);
+
+			status_t		Archive(BMessage *data) const;
+
+			uint64			GetID(void) const;
+			BString			GetType(void) const;
+			int32			CountProperties(void) const;
+
+			// Adds the properties of a row to data
+			status_t		InstantiateValues(BMessage *row, PData *data) const;
+
+	// Archives the values of data to row. The schema is added to schemas if
+	// there isn't one with the same ID yet, so one schemas message can be
+	// shared by all rows of an archive.
+	static	status_t		ArchiveRow(const BString &type, const PData *data,
+										BMessage *row, BMessage *schemas);
+
+	static	status_t		RegisterSchemas(BMessage *schemas);
+	static	PPropertySchema	*FindSchema(const uint64 &id);
+
+private:
+	class property_entry
+	{
+	public:
+		BMessage			archive;
+		BString				type;
+		uint32				flags;
+		BString				field;
+		type_code			code;
+		int32				fieldIndex;
+	};
+
+	static	uint64			SchemaID(const BString &type,
+									const PData *data);
+	static	BString			FieldName(const type_code &code);
+
+	uint64							fID;
+	BString							fType;
+	std::vector<property_entry>		fProperties;
+};
+
+#endif
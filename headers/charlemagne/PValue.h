@@ -25,7 +25,7 @@ public:
 		
 		virtual	PValue *	Duplicate(void) const { return new PValue(); }
 		
-				BString		*type;
+				const BString	*type;
 };
 
 
@@ -53,13 +53,16 @@ public:
 		inline	bool		operator!(void) { return !(*value); }
 		
 				bool		*value;
+
+private:
+				bool		fStorage;
 };
 
 
 class StringValue : public PValue
 {
 public:
-							StringValue(void) { *type = "string"; value = new BString(); }
+							StringValue(void);
 							StringValue(const StringValue &from);
 							StringValue(BString from);
 							StringValue(const char *from);
@@ -91,6 +94,9 @@ public:
 		inline	bool		operator>=(const StringValue &from)  { return *value >= *from.value; }
 				
 				BString		*value;
+
+private:
+				BString		fStorage;
 };
 
 class IntValue : public PValue
@@ -139,6 +145,9 @@ public:
 		inline	bool		operator>=(const IntValue &from)  { return *value >= *from.value; }
 		
 				int64		*value;
+
+private:
+				int64		fStorage;
 };
 
 class CharValue : public PValue
@@ -167,6 +176,9 @@ public:
 		inline	bool 		operator!=(const char &from) { return *value != from; }
 		
 				char		*value;
+
+private:
+				char		fStorage;
 };
 
 class FloatValue : public PValue
@@ -213,6 +225,9 @@ public:
 		inline	bool		operator>=(const FloatValue &from)  { return *value >= *from.value; }
 		
 				float		*value;
+
+private:
+				float		fStorage;
 };
 
 class ColorValue : public PValue
@@ -252,6 +267,9 @@ public:
 		bool 			operator!=(const rgb_color &from);
 		
 		rgb_color		*value;
+
+private:
+		rgb_color		fStorage;
 };
 
 
@@ -278,6 +296,9 @@ public:
 		inline	RectValue &	operator=(const BRect &from) { *value = from; return *this; }
 		
 				BRect		*value;
+
+private:
+				BRect		fStorage;
 };
 
 
@@ -304,6 +325,9 @@ public:
 		inline	PointValue &	operator=(const BPoint &from) { *value = from; return *this; }
 		
 				BPoint		*value;
+
+private:
+				BPoint		fStorage;
 };
 
 
@@ -331,6 +355,9 @@ public:
 		inline	MessageValue &	operator=(const BMessage &from) { *value = from; return *this; }
 		
 				BMessage		*value;
+
+private:
+				BMessage		fStorage;
 };
 
 
@@ -34,6 +34,7 @@ public:
 	}
 
 	static Customizable*	InstantiateCustomizable(const BMessage* archive);
+	virtual	status_t		ResetContent();
 
 };
 
@@ -53,6 +54,9 @@ public:
 			Customizable::SetObjectName(name);
 		}
 	}
+
+	virtual	status_t		Reset();
+	virtual	status_t		ResetContent();
 };
 
 
@@ -66,6 +70,7 @@ public:
 	}
 
 	static Customizable*	InstantiateCustomizable(const BMessage* archive);
+	virtual	status_t		ResetContent();
 
 };
 
@@ -80,6 +85,7 @@ public:
 	}
 
 	static Customizable*	InstantiateCustomizable(const BMessage* archive);
+	virtual	status_t		ResetContent();
 
 };
 
@@ -94,6 +100,7 @@ public:
 	}
 
 	static Customizable*	InstantiateCustomizable(const BMessage* archive);
+	virtual	status_t		ResetContent();
 
 };
 
@@ -108,6 +115,7 @@ public:
 	}
 
 	static Customizable*	InstantiateCustomizable(const BMessage* archive);
+	virtual	status_t		ResetContent();
 
 };
 
@@ -137,6 +145,7 @@ public:
 	}
 
 	static Customizable*	InstantiateCustomizable(const BMessage* archive);
+	virtual	status_t		ResetContent();
 
 };
 
@@ -151,6 +160,7 @@ public:
 	}
 
 	static Customizable*	InstantiateCustomizable(const BMessage* archive);
+	virtual	status_t		ResetContent();
 
 };
 
@@ -165,6 +175,7 @@ public:
 	}
 
 	static Customizable*	InstantiateCustomizable(const BMessage* archive);
+	virtual	status_t		ResetContent();
 
 };
 
@@ -23,9 +23,14 @@ namespace BALM {
 
 class Customizable;
 class CustomizableRoster;
+class Layer;
 
 typedef BObjectList<Customizable> CustomizableList;
 
+/*! Identifies a registered Customizable. Handles of unregistered objects
+are never reused. */
+typedef uint64 customizable_handle;
+
 
 class Customizable : public BObject {
 public:
@@ -71,12 +76,17 @@ public:
 	virtual						~Customizable();
 
 			CustomizableRoster*	Roster() { return fRoster; }
+			customizable_handle	Handle() const { return fHandle; }
 
 	virtual void				Stop();
 	virtual void				Resume();
 
 	virtual status_t			SaveState(BMessage* archive) const;
 	virtual status_t			RestoreState(const BMessage* archive);
+			/*! Brings a recycled Customizable back into the state of a
+			new one. Only Customizables that support it are pooled by the
+			roster. */
+	virtual	status_t			Reset();
 
 			void				SetObjectName(const char* name);
 			BString				ObjectName() const;
@@ -126,11 +136,18 @@ protected:
 									int32 minConnections = 0,
 									int32 maxConnections = 1);
 
+			// overwrite PObject methods to keep the roster's interface index
+	virtual	void				AddInterface(const char* name);
+	virtual	void				RemoveInterface(const char* name);
+
 			bool				Connected(Socket* socket);
 			bool				Disconnected(Socket* socket);
 
 private:
+	friend class Layer;
+
 			CustomizableRoster* fRoster;
+			customizable_handle	fHandle;
 			BString				fObjectName;
 			bool				fExchangeable;
 			bool				fRemovable;
@@ -145,6 +162,7 @@ private:
 
 using BALM::Customizable;
 using BALM::CustomizableList;
+using BALM::customizable_handle;
 
 
 #endif	// CUSTOMIZABLE_H
@@ -8,6 +8,7 @@
 
 #include <Customizable.h>
 
+#include <Autolock.h>
 #include <Bitmap.h>
 #include <Handler.h>
 #include <Locker.h>
@@ -18,17 +19,28 @@
 #include <Mangle.h>
 
 #include <ArrayContainer.h>
+#include <OpenHashTable.h>
+
+#include <map>
+#include <set>
+#include <vector>
 
 
 enum {
 	B_CUSTOMIZABLE_ADDED = '_Cad',
 	B_CUSTOMIZABLE_REMOVED = '_Crm',
+	/*! Sent to a watcher once for all changes it hasn't fetched with
+	CustomizableRoster::GetChanges() yet. */
+	B_CUSTOMIZABLE_LIST_CHANGED = '_Clc',
 
 	B_SOCKET_CONNECTED = '_SCo',
 	B_SOCKET_DISCONNECTED = '_SDi',
 };
 
 
+class IViewContainer;
+
+
 namespace BALM {
 
 
@@ -39,14 +51,62 @@ public:
 	virtual	BReference<Customizable>	InstantiateCustomizable(
 											const BMessage* message) = 0;
 	virtual BString				Name() = 0;
-	virtual bool				IconPicture(BView* view, BPicture** picture,
+	/*! The picture is recorded once and owned by the add-on, it stays
+	valid as long as the add-on, which is never removed. */
+	virtual bool				IconPicture(BView* view,
+									const BPicture** picture, BRect& frame);
+	/*! The raw B_RGBA32 icon, it is decoded into the icon atlas of the
+	roster. */
+	virtual bool				IconData(const unsigned char** bits,
 									BRect& frame);
+	/*! Whether the components can be inserted into a layout. The default
+	makes a component to find out. */
+	virtual bool				Insertable();
 };
 
 
 typedef BObjectList<CustomizableAddOn> CustomizableAddOnList;
 
 
+/*! The icons of the installed add-ons decoded into a single bitmap. An atlas
+never changes, it is shared by all callers until more add-ons are
+installed. */
+class CustomizableIconAtlas : public BReferenceable {
+public:
+								CustomizableIconAtlas();
+								~CustomizableIconAtlas();
+
+			const BBitmap*		Bitmap() const;
+			/*! Gets the frame of the icon in Bitmap(), returns false if the
+			add-on has no icon. */
+			bool				IconFrame(CustomizableAddOn* addOn,
+									BRect& frame) const;
+
+private:
+	friend class CustomizableRoster;
+
+			status_t			_Decode(const CustomizableAddOnList& addOns);
+
+			BBitmap*			fBitmap;
+			std::map<CustomizableAddOn*, BRect>	fFrames;
+};
+
+
+/*! The Customizables registered at one point in time. A snapshot never
+changes, it is shared by all callers until the registrations change. */
+class CustomizableSnapshot : public BReferenceable {
+public:
+			int32				CountItems() const;
+			/*! Returns NULL if the Customizable has been deleted since. */
+			BReference<Customizable>	ItemAt(int32 index);
+
+private:
+	friend class Layer;
+
+			BArray<BWeakReference<Customizable> >	fCustomizables;
+};
+
+
 class Layer {
 public:
 								Layer();
@@ -54,8 +114,12 @@ public:
 			bool				Register(Customizable* customizable);
 			bool				Unregister(Customizable* customizable);
 
+			BReference<Customizable>	FindCustomizable(
+											customizable_handle handle);
+
 			void				GetCustomizableList(
 									BArray<BWeakReference<Customizable> >& list);
+			BReference<CustomizableSnapshot>	Snapshot();
 
 			/*! Hold a strong reference to the Customizable. */
 			bool				AddToShelf(Customizable* customizable);
@@ -63,14 +127,54 @@ public:
 
 			void				GetShelfList(
 									BArray<BReference<Customizable> >& list);
+			/*! Adds the live Customizables that use the interface. */
+			void				GetCompatibleList(const char* interface,
+									BArray<BReference<Customizable> >& list);
+
+			void				AddInterface(Customizable* customizable,
+									const char* interface);
+			void				RemoveInterface(Customizable* customizable,
+									const char* interface);
 private:
-			CustomizableList	fCustomizables;
-			BArray<BWeakReference<Customizable> >	fCustomizableRefs;
+	typedef std::map<Customizable*, BWeakReference<Customizable> >
+		CustomizableRefMap;
+
+	class Slot {
+	public:
+			Customizable*		customizable;
+			BWeakReference<Customizable>	reference;
+			//! Incremented when the slot is freed to invalidate old handles.
+			uint32				generation;
+			int32				nextFree;
+	};
+
+	static	BString				_InterfaceKey(const char* interface);
+			Slot*				_SlotFor(customizable_handle handle);
+
+			//! Registered Customizables, free slots are reused.
+			std::vector<Slot>	fSlots;
+			int32				fFreeSlot;
+			//! Built on demand, released when the registrations change.
+			BReference<CustomizableSnapshot>	fSnapshot;
+			//! Registered Customizables by lower case interface name.
+			std::map<BString, CustomizableRefMap>	fInterfaceIndex;
 
 			BArray<BReference<Customizable> >	fShelf;
 };
 
 
+class customizable_pool_info {
+public:
+			//! Maximum number of pooled objects, 0 disables the pool.
+			int32				size;
+			int32				count;
+			int32				hits;
+			int32				misses;
+			int32				recycled;
+			int32				rejected;
+};
+
+
 class CustomizableRoster {
 public:
 								CustomizableRoster();
@@ -87,9 +191,18 @@ public:
 
 			void				GetCustomizableList(
 									BArray<BWeakReference<Customizable> >& list);
+			/*! Shared list of the registered Customizables, cheaper than
+			GetCustomizableList() which copies it. */
+			BReference<CustomizableSnapshot>	GetCustomizableSnapshot();
+			BReference<Customizable>	FindCustomizable(
+											customizable_handle handle);
 
 			bool				StartWatching(BHandler* target);
 			bool				StopWatching(BHandler* target);
+			/*! Moves the changes collected for the watcher to changes. It
+			gets the handles of the "added", "removed" and "changed"
+			Customizables, an object is only in one of them. */
+			status_t			GetChanges(BHandler* target, BMessage* changes);
 
 			void				GetCompatibleConnections(
 									Customizable::Socket* socket,
@@ -100,6 +213,25 @@ public:
 			void				GetShelfList(
 									BArray<BReference<Customizable> >& list);
 
+			/*! Keeps a removed Customizable to hand it out again from
+			InstantiateCustomizable() without an archive. It is only taken
+			if the caller holds the only reference, it isn't connected and
+			its Reset() succeeds. Pooled objects are unregistered. */
+			bool				RecycleCustomizable(Customizable* customizable);
+			/*! Sets the pool size of one component type, a negative size
+			restores the default. */
+			void				SetPoolSize(const char* name, int32 size);
+			//! Sets the size of the pools without an explicit size.
+			void				SetDefaultPoolSize(int32 size);
+			status_t			GetPoolInfo(const char* name,
+									customizable_pool_info* info);
+			//! Asks the add-on of name without making a component.
+			bool				IsInsertable(const char* name);
+
+			/*! Decodes the icons of the installed add-ons on first use.
+			Returns NULL if there is no app_server connection. */
+			BReference<CustomizableIconAtlas>	GetIconAtlas();
+
 protected:
 	friend class Customizable;
 			bool				Register(Customizable* customizable);
@@ -111,12 +243,81 @@ private:
 
 			Layer*				_Layer(Customizable* customizable);
 
-			void				_NotifyWatchers(BMessage* message);
-			void				_NotifyWatchers(int32 what);
+			void				_InterfaceAdded(Customizable* customizable,
+									const char* interface);
+			void				_InterfaceRemoved(Customizable* customizable,
+									const char* interface);
+
+			void				_NotifyWatchers(int32 what,
+									customizable_handle handle);
 
 			CustomizableAddOnList	fInstalledCustomizables;
 
-			BObjectList<BHandler>	fWatcherList;
+	//! An add-on in the name index, its name and hash are built at install.
+	class addon_entry {
+	public:
+			addon_entry*		next;
+			BString				name;
+			uint32				hash;
+			CustomizableAddOn*	addOn;
+	};
+
+	//! Looks add-ons up by a plain name, a lookup doesn't copy the name.
+	struct AddOnNameDefinition {
+		typedef const char*		KeyType;
+		typedef addon_entry		ValueType;
+
+		size_t HashKey(const char* key) const
+		{
+			return BString::HashValue(key);
+		}
+
+		size_t Hash(addon_entry* value) const
+		{
+			return value->hash;
+		}
+
+		bool Compare(const char* key, addon_entry* value) const
+		{
+			return value->name == key;
+		}
+
+		addon_entry*& GetLink(addon_entry* value) const
+		{
+			return value->next;
+		}
+	};
+
+			BOpenHashTable<AddOnNameDefinition>	fAddOnIndex;
+
+	class watcher_changes {
+	public:
+								watcher_changes();
+
+			std::set<customizable_handle>	added;
+			std::set<customizable_handle>	removed;
+			std::set<customizable_handle>	changed;
+			//! The watcher has been sent a message it didn't answer yet.
+			bool				notified;
+	};
+
+			std::map<BHandler*, watcher_changes>	fWatchers;
+
+	class customizable_pool {
+	public:
+								customizable_pool();
+
+			std::vector<Customizable*>	free;
+			//! -1 if the default size applies
+			int32				size;
+			customizable_pool_info	info;
+	};
+
+			//! Recycled Customizables by name, they hold one reference each.
+			std::map<BString, customizable_pool>	fPools;
+			int32				fDefaultPoolSize;
+
+			BReference<CustomizableIconAtlas>	fIconAtlas;
 
 			BObjectList<Layer>	fLayerList;
 
@@ -133,7 +334,7 @@ public:
 		if (roster == NULL)
 			return;
 		
-		roster->InstallCustomizable(new AddOn<Type>);
+		roster->InstallCustomizable(new AddOn<Type>(roster));
 	}
 
 	CustomizableInstaller(const unsigned char* bits, BRect pictureFrame)
@@ -142,26 +343,39 @@ public:
 		if (roster == NULL)
 			return;
 		
-		roster->InstallCustomizable(new AddOn<Type>(bits, pictureFrame));
+		roster->InstallCustomizable(new AddOn<Type>(roster, bits,
+			pictureFrame));
 	}
 
 private:
 	template<class T>
 	class AddOn : public CustomizableAddOn {
 	public:
-		AddOn()
+		AddOn(CustomizableRoster* roster)
 			:
-			fBitmap(NULL)
+			fRoster(roster),
+			fBitmap(NULL),
+			fPicture(NULL),
+			fPictureLock("icon picture")
 		{	
 		}
 
-		AddOn(const unsigned char* bits, BRect pictureFrame)
+		AddOn(CustomizableRoster* roster, const unsigned char* bits,
+			BRect pictureFrame)
 			:
+			fRoster(roster),
 			fBitmap(bits),
-			fPictureFrame(pictureFrame)
+			fPictureFrame(pictureFrame),
+			fPicture(NULL),
+			fPictureLock("icon picture")
 		{
 		}
 
+		~AddOn()
+		{
+			delete fPicture;
+		}
+
 		BReference<Customizable>
 		InstantiateCustomizable(const BMessage* message)
 		{
@@ -177,24 +391,61 @@ private:
 			return out;
 		}
 
-		bool IconPicture(BView* view, BPicture** picture, BRect& frame)
+		bool IconPicture(BView* view, const BPicture** picture,
+			BRect& frame)
 		{
 			if (fBitmap == NULL)
 				return false;
-			BBitmap bitmap(fPictureFrame, B_RGBA32);
-			memcpy(bitmap.Bits(), (void*)fBitmap, bitmap.BitsLength());
-			view->BeginPicture(new BPicture);
-			view->DrawBitmap(&bitmap);
-			*picture = view->EndPicture();
-			if (*picture == NULL)
+
+			BAutolock _(fPictureLock);
+			if (fPicture == NULL) {
+				// recorded once from the icon atlas of our roster
+				BReference<CustomizableIconAtlas> atlas
+					= fRoster->GetIconAtlas();
+				BRect source;
+				if (atlas.Get() == NULL || !atlas->IconFrame(this, source))
+					return false;
+				view->BeginPicture(new BPicture);
+				view->DrawBitmap(atlas->Bitmap(), source, fPictureFrame);
+				fPicture = view->EndPicture();
+				if (fPicture == NULL)
+					return false;
+			}
+			*picture = fPicture;
+			frame = fPictureFrame;
+			return true;
+		}
+
+		bool IconData(const unsigned char** bits, BRect& frame)
+		{
+			if (fBitmap == NULL)
 				return false;
+			*bits = fBitmap;
 			frame = fPictureFrame;
 			return true;
 		}
 
+		bool Insertable()
+		{
+			return _IsViewContainer((T*)NULL);
+		}
+
 	private:
+		static bool _IsViewContainer(IViewContainer*)
+		{
+			return true;
+		}
+
+		static bool _IsViewContainer(...)
+		{
+			return false;
+		}
+
+		CustomizableRoster*	fRoster;
 		const unsigned char*	fBitmap;
 		BRect		fPictureFrame;
+		BPicture*	fPicture;
+		BLocker		fPictureLock;
 	};
 };
 
@@ -202,8 +453,11 @@ private:
 }	// namespace BALM
 
 
+using BALM::CustomizableIconAtlas;
 using BALM::CustomizableInstaller;
 using BALM::CustomizableRoster;
+using BALM::CustomizableSnapshot;
+using BALM::customizable_pool_info;
 
 
 #endif	// CUSTOMIZABLE_ROSTER_H
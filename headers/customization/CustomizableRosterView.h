@@ -7,6 +7,7 @@
 
 
 #include <Button.h>
+#include <ListItem.h>
 #include <ListView.h>
 
 #include "CustomizableRoster.h"
@@ -38,8 +39,13 @@ public:
 
 private:
 			void				_LoadCustomizableList();
+			void				_UpdateCustomizableList();
+			void				_AddItem(Customizable* customizable);
+			void				_MakeEmpty();
+	static	BString				_Label(Customizable* customizable);
 
 			CustomizableRoster*	fRoster;
+			std::map<customizable_handle, BStringItem*>	fItems;
 
 			BListView*			fCustomizableListView;
 			BButton*			fAddComponent;
@@ -53,6 +53,12 @@ public:
 			BLayoutItemLocalPointer	LayoutItem();
 
 			void				RemoveSelf();
+			/*! Removes the view and drops the name and the event connections
+			it got after it was made, if ResetContent() succeeds. */
+	virtual	status_t			Reset();
+			/*! Restores the content the add-on made the view with. Views that
+			don't support it are not recycled. */
+	virtual	status_t			ResetContent();
 
 			BSize				PreferredSize();
 			BSize				MinSize();
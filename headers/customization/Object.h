@@ -27,10 +27,18 @@ struct connection_data {
 };
 
 
+/*! The connections of an event are never changed once published. Connecting
+or disconnecting replaces the list, so a fired event iterates its snapshot
+while the connections change. */
+struct connection_list : BReferenceable {
+	std::vector<connection_data>	connections;
+};
+
+
 struct event_data {
 	BString				event;
 	PMethodInterface*	interface;
-	std::vector<connection_data>	connections;
+	BReference<connection_list>	connections;
 };
 
 
@@ -64,11 +72,17 @@ public:
 									BObject* target);
 	virtual	status_t			RunMethodAsync(PMethod*, PArgs &in,
 									PArgs &out, async_refs* refs = NULL);
+			//! Targets on the same looper get one message and all targets
+			//! share one copy of the arguments.
 			status_t			FireEventAsync(const char* event, PArgs &in,
 									PArgs &out, async_refs* refs = NULL);
 			status_t			FireEventSync(const char* event, PArgs &in,
 									PArgs &out);
 
+			//! Disconnects the targets of all events of this object and
+			//! this object from the events of others.
+			void				DisconnectAllEvents();
+
 			bool				ConnectedToEvent(BObject* source);
 			bool				DisconnectedFromEvent(BObject* source);
 
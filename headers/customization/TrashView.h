@@ -6,8 +6,11 @@
 #define	TRASH_VIEW_H
 
 
+#include <ListItem.h>
 #include <ListView.h>
 
+#include <map>
+
 #include <ALMEditor.h>
 #include <CustomizableRoster.h>
 
@@ -15,6 +18,7 @@
 class TrashView : public BListView {
 public:
 								TrashView(BALMEditor* editor);
+	virtual						~TrashView();
 
 	virtual bool				InitiateDrag(BPoint point, int32 index,
 									bool wasSelected);
@@ -25,9 +29,13 @@ public:
 
 private:
 			void				_LoadTrash();
+			void				_UpdateTrash();
+			void				_AddItems(
+									BArray<BWeakReference<Customizable> >& list);
+			void				_MakeEmpty();
 
 			BALMEditor*			fEditor;
-			BArray<BWeakReference<Customizable> > fTrashList;
+			std::map<customizable_handle, BStringItem*>	fItems;
 };
 
 
@@ -13,6 +13,8 @@
 #include <ArrayContainer.h>
 #include <Customizable.h>
 
+#include <set>
+
 
 const int32 kMsgLayoutEdited = '&LEd';
 
@@ -86,6 +88,12 @@ public:
 
 			void				GetTrash(
 									BArray<BWeakReference<Customizable> >& l);
+			/*! Moves the changes since the watcher was sent kTrashUpdated to
+			added and removed. The watcher is sent one message for all changes
+			until it fetches them. */
+			void				GetTrashChanges(
+									BArray<BWeakReference<Customizable> >& added,
+									BArray<customizable_handle>& removed);
 			
 			void				SetTrashWatcher(BMessenger target);
 
@@ -97,10 +105,14 @@ private:
 	public:
 								trash_item(Customizable* customizable);
 		Customizable*					raw_pointer;
+		customizable_handle				handle;
 		BReference<Customizable>		trash;
 		BWeakReference<Customizable>	weak_trash;		
 	};
 
+			void				_TrashChanged(customizable_handle handle,
+									bool added);
+
 			BALMLayout*			fLayout;
 			
 			LayoutEditView*		fEditView;
@@ -121,6 +133,9 @@ private:
 
 			BObjectList<trash_item>	fTrash;
 			BMessenger			fTrashWatcher;
+			std::set<customizable_handle>	fTrashAdded;
+			std::set<customizable_handle>	fTrashRemoved;
+			bool				fTrashNotified;
 
 			OverlapManager*		fOverlapManager;
 };
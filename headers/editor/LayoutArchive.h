@@ -28,6 +28,10 @@ public:
 									bool saveComponents) const;
 			status_t			RestoreLayout(const BMessage* archive,
 									bool restoreComponents);
+			/*! Only replaces the tab values in an archive of the same layout,
+			e.g. after the layout has been resized. Fails if an area or tab
+			has been added, removed or exchanged. */
+			status_t			UpdateTabValues(BMessage* archive) const;
 
 			status_t			SaveToFile(BFile* file,
 									const BMessage* message);
@@ -66,6 +70,10 @@ private:
 			bool				_RestoreArea(Area* area, int32 i,
 									const BMessage* archive, XTabList& xTabs,
 									YTabList& yTabs);
+			int32				_TabIndex(XTab* tab,
+									const XTabList& xTabs) const;
+			int32				_TabIndex(YTab* tab,
+									const YTabList& yTabs) const;
 			bool				_SaveComponent(Area* area,
 									BMessage* archive) const;
 			Area*				_CreateComponent(const BMessage* archive);
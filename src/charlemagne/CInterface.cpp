@@ -1,6 +1,8 @@
 #include "CInterface.h"
 #include "PArgs.h"
 
+#include <string.h>
+
 #ifdef __cplusplus
 	extern "C" {
 #endif
@@ -806,7 +808,274 @@ replace_parg_color_index(void *args, const char *name, unsigned char red,
 }
 
 
+#pragma mark - Field handle functions
+
+
+static int32
+AddFieldValue(void *args, parg_field_handle field, type_code type,
+			const void *data, int32 size, bool fixedSize)
+{
+	PArgs *pargs = static_cast<PArgs*>(args);
+	if (!pargs)
+		return B_BAD_DATA;
+	return pargs->AddDataByAtom(field, type, data, size, fixedSize);
+}
+
+
+static int32
+FindFieldValue(void *args, parg_field_handle field, type_code type, void *out,
+			int32 size)
+{
+	const void *data;
+	int32 dataSize;
+	status_t status = find_parg_data_field(args, field, type, &data,
+										&dataSize, 0);
+	if (status != B_OK)
+		return status;
+	if (!out || dataSize != size)
+		return B_BAD_VALUE;
+	
+	memcpy(out, data, size);
+	return B_OK;
+}
+
+
+parg_field_handle
+parg_field(const char *name)
+{
+	if (!name)
+		return ATOM_INVALID;
+	return intern_atom(name);
+}
+
+
+int32
+add_parg_data_field(void *args, parg_field_handle field, int32 type,
+					const void *data, int32 size)
+{
+	return AddFieldValue(args, field, type, data, size, false);
+}
+
+
+int32
+find_parg_data_field(void *args, parg_field_handle field, int32 type,
+					const void **data, int32 *size, int32 index)
+{
+	PArgs *pargs = static_cast<PArgs*>(args);
+	if (!pargs)
+		return B_BAD_DATA;
+	return pargs->FindDataByAtom(field, type, data, size, index);
+}
+
+
+int32
+replace_parg_data_field(void *args, parg_field_handle field, int32 type,
+						const void *data, int32 size, int32 index)
+{
+	PArgs *pargs = static_cast<PArgs*>(args);
+	if (!pargs)
+		return B_BAD_DATA;
+	return pargs->ReplaceDataByAtom(field, type, data, size, index);
+}
+
+
+int32
+add_parg_char_field(void *args, parg_field_handle field, char arg)
+{
+	return AddFieldValue(args, field, B_CHAR_TYPE, &arg, sizeof(arg), true);
+}
+
+
+int32
+add_parg_int8_field(void *args, parg_field_handle field, int8 arg)
+{
+	return AddFieldValue(args, field, B_INT8_TYPE, &arg, sizeof(arg), true);
+}
+
+
+int32
+add_parg_int16_field(void *args, parg_field_handle field, int16 arg)
+{
+	return AddFieldValue(args, field, B_INT16_TYPE, &arg, sizeof(arg), true);
+}
+
+
+int32
+add_parg_int32_field(void *args, parg_field_handle field, int32 arg)
+{
+	return AddFieldValue(args, field, B_INT32_TYPE, &arg, sizeof(arg), true);
+}
+
+
+int32
+add_parg_int64_field(void *args, parg_field_handle field, int64 arg)
+{
+	return AddFieldValue(args, field, B_INT64_TYPE, &arg, sizeof(arg), true);
+}
+
+
+int32
+add_parg_bool_field(void *args, parg_field_handle field, bool arg)
+{
+	return AddFieldValue(args, field, B_BOOL_TYPE, &arg, sizeof(arg), true);
+}
+
+
+int32
+add_parg_float_field(void *args, parg_field_handle field, float arg)
+{
+	return AddFieldValue(args, field, B_FLOAT_TYPE, &arg, sizeof(arg), true);
+}
+
+
+int32
+add_parg_double_field(void *args, parg_field_handle field, double arg)
+{
+	return AddFieldValue(args, field, B_DOUBLE_TYPE, &arg, sizeof(arg), true);
+}
+
+
+int32
+add_parg_pointer_field(void *args, parg_field_handle field, void * ptr)
+{
+	return AddFieldValue(args, field, B_POINTER_TYPE, &ptr, sizeof(ptr), true);
+}
+
+
+int32
+add_parg_string_field(void *args, parg_field_handle field, const char *arg)
+{
+	if (!arg)
+		arg = "";
+	return AddFieldValue(args, field, B_STRING_TYPE, arg, strlen(arg) + 1,
+						false);
+}
+
+
+int32
+find_parg_char_field(void *args, parg_field_handle field, char *out)
+{
+	return FindFieldValue(args, field, B_CHAR_TYPE, out, sizeof(*out));
+}
+
 
+int32
+find_parg_int8_field(void *args, parg_field_handle field, int8 *out)
+{
+	return FindFieldValue(args, field, B_INT8_TYPE, out, sizeof(*out));
+}
+
+
+int32
+find_parg_int16_field(void *args, parg_field_handle field, int16 *out)
+{
+	return FindFieldValue(args, field, B_INT16_TYPE, out, sizeof(*out));
+}
+
+
+int32
+find_parg_int32_field(void *args, parg_field_handle field, int32 *out)
+{
+	return FindFieldValue(args, field, B_INT32_TYPE, out, sizeof(*out));
+}
+
+
+int32
+find_parg_int64_field(void *args, parg_field_handle field, int64 *out)
+{
+	return FindFieldValue(args, field, B_INT64_TYPE, out, sizeof(*out));
+}
+
+
+int32
+find_parg_bool_field(void *args, parg_field_handle field, bool *out)
+{
+	return FindFieldValue(args, field, B_BOOL_TYPE, out, sizeof(*out));
+}
+
+
+int32
+find_parg_float_field(void *args, parg_field_handle field, float *out)
+{
+	return FindFieldValue(args, field, B_FLOAT_TYPE, out, sizeof(*out));
+}
+
+
+int32
+find_parg_double_field(void *args, parg_field_handle field, double *out)
+{
+	return FindFieldValue(args, field, B_DOUBLE_TYPE, out, sizeof(*out));
+}
+
+
+int32
+find_parg_pointer_field(void *args, parg_field_handle field, void * *ptr)
+{
+	return FindFieldValue(args, field, B_POINTER_TYPE, ptr, sizeof(*ptr));
+}
+
+
+int32
+find_parg_string_field(void *args, parg_field_handle field, const char **arg)
+{
+	return find_parg_data_field(args, field, B_STRING_TYPE, (const void **)arg,
+								NULL, 0);
+}
+
+
+#pragma mark - Bulk functions
+
+
+int32
+add_parg_fields(void *args, const parg_field_desc *fields, int32 count,
+				const void *values)
+{
+	if (!fields || !values)
+		return B_BAD_VALUE;
+	
+	const char *base = static_cast<const char*>(values);
+	for (int32 i = 0; i < count; i++)
+	{
+		const parg_field_desc &desc = fields[i];
+		const char *member = base + desc.offset;
+		status_t status;
+		if (desc.type == B_STRING_TYPE)
+			status = add_parg_string_field(args, desc.field,
+										*(const char **)member);
+		else
+			status = AddFieldValue(args, desc.field, desc.type, member,
+								desc.size, true);
+		if (status != B_OK)
+			return status;
+	}
+	return B_OK;
+}
+
+
+int32
+find_parg_fields(void *args, const parg_field_desc *fields, int32 count,
+				void *values)
+{
+	if (!fields || !values)
+		return B_BAD_VALUE;
+	
+	char *base = static_cast<char*>(values);
+	for (int32 i = 0; i < count; i++)
+	{
+		const parg_field_desc &desc = fields[i];
+		char *member = base + desc.offset;
+		status_t status;
+		if (desc.type == B_STRING_TYPE)
+			status = find_parg_string_field(args, desc.field,
+											(const char **)member);
+		else
+			status = FindFieldValue(args, desc.field, desc.type, member,
+								desc.size);
+		if (status != B_OK)
+			return status;
+	}
+	return B_OK;
+}
 
 
 #ifdef __cplusplus
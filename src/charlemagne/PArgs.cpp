@@ -1,11 +1,107 @@
 #include "PArgs.h"
 
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+
+
+enum
+{
+	ORDER_FIELD_NAME = 0,
+	ORDER_TYPE,
+	ORDER_CALL_INDEX,
+	ORDER_FIELD_INDEX
+};
+
+
+// The names of the order info fields, interned once
+static const atom_t *
+OrderInfoAtoms(void)
+{
+	static const atom_t sAtoms[] = {
+		intern_atom("fieldname"),
+		intern_atom("type"),
+		intern_atom("callindex"),
+		intern_atom("fieldindex")
+	};
+	return sAtoms;
+}
+
+
+// Refs are kept flattened the way BMessage flattens them: the device, the
+// directory and the name with its terminating null. The backend can take
+// them as they are.
+enum
+{
+	REF_HEADER_SIZE = sizeof(dev_t) + sizeof(ino_t),
+	FLAT_REF_SIZE = REF_HEADER_SIZE + B_PATH_NAME_LENGTH
+};
+
+
+static status_t
+FlattenRef(const entry_ref &ref, char *buffer, int32 *size)
+{
+	memcpy(buffer, &ref.device, sizeof(ref.device));
+	memcpy(buffer + sizeof(ref.device), &ref.directory,
+			sizeof(ref.directory));
+	
+	int32 nameLength = 0;
+	if (ref.name)
+	{
+		nameLength = strlen(ref.name) + 1;
+		if (nameLength > B_PATH_NAME_LENGTH)
+			return B_BUFFER_OVERFLOW;
+		memcpy(buffer + REF_HEADER_SIZE, ref.name, nameLength);
+	}
+	*size = REF_HEADER_SIZE + nameLength;
+	return B_OK;
+}
+
+
+static status_t
+UnflattenRef(const void *data, int32 size, entry_ref *ref)
+{
+	const char *buffer = (const char *)data;
+	if (size < REF_HEADER_SIZE)
+		return B_BAD_DATA;
+	
+	memcpy(&ref->device, buffer, sizeof(ref->device));
+	memcpy(&ref->directory, buffer + sizeof(ref->device),
+			sizeof(ref->directory));
+	if (size == REF_HEADER_SIZE)
+		return ref->set_name(NULL);
+	
+	// The name has to be terminated within the item
+	if (buffer[size - 1] != '\0')
+		return B_BAD_DATA;
+	return ref->set_name(buffer + REF_HEADER_SIZE);
+}
+
+
 PArgs::PArgs(void)
+	:	fFields(fInlineFields),
+		fFieldCount(0),
+		fFieldCapacity(INLINE_FIELDS),
+		fData(fInlineData),
+		fDataSize(0),
+		fDataCapacity(INLINE_DATA),
+		fUnusedData(0),
+		fBackend(NULL),
+		fBackendValid(false)
 {
 }
 
 
 PArgs::PArgs(PArgs &from)
+	:	fFields(fInlineFields),
+		fFieldCount(0),
+		fFieldCapacity(INLINE_FIELDS),
+		fData(fInlineData),
+		fDataSize(0),
+		fDataCapacity(INLINE_DATA),
+		fUnusedData(0),
+		fBackend(NULL),
+		fBackendValid(false)
 {
 	*this = from;
 }
@@ -13,14 +109,32 @@ PArgs::PArgs(PArgs &from)
 
 PArgs::~PArgs(void)
 {
+	if (fFields != fInlineFields)
+		free(fFields);
+	if (fData != fInlineData)
+		free(fData);
+	delete fBackend;
 }
 
 
 PArgs &
 PArgs::operator=(const PArgs &from)
 {
-	fBackend = from.fBackend;
+	if (&from == this)
+		return *this;
+	
+	MakeEmpty();
+	if (!ReserveFields(from.fFieldCount) || !ReserveData(from.fDataSize))
+		return *this;
 	
+	memcpy(fFields, from.fFields, from.fFieldCount * sizeof(field));
+	memcpy(fData, from.fData, from.fDataSize);
+	fFieldCount = from.fFieldCount;
+	fDataSize = from.fDataSize;
+	fUnusedData = from.fUnusedData;
+	
+	// The backend is rebuilt when it is asked for, copying it would cost
+	// every copy of the arguments a BMessage copy
 	return *this;
 }
 
@@ -35,53 +149,62 @@ PArgs::SetTo(const PArgs &from)
 void
 PArgs::MakeEmpty(void)
 {
-	fBackend.MakeEmpty();
+	fFieldCount = 0;
+	fDataSize = 0;
+	fUnusedData = 0;
+	// Emptying the message would free and allocate its header again
+	fBackendValid = false;
 }
 
 
 void
 PArgs::PrintToStream(void)
 {
-	fBackend.PrintToStream();
+	GetBackend().PrintToStream();
 }
 
 
 status_t
 PArgs::CountFieldItems(const char *name, int32 *count)
 {
-	type_code type;
-	return fBackend.GetInfo(name, &type, count);
+	atom_t atom = find_atom(name);
+	int32 items = atom != ATOM_INVALID ? CountItems(atom) : 0;
+	if (items == 0)
+		return B_NAME_NOT_FOUND;
+	
+	if (count)
+		*count = items;
+	return B_OK;
 }
 
 
 status_t
 PArgs::RemoveData(const char *name, int32 index)
 {
-	return fBackend.RemoveData(name, index);
+	return RemoveItem(name, index, false);
 }
 
 
 status_t
 PArgs::RemoveName(const char *name)
 {
-	return fBackend.RemoveName(name);
+	return RemoveItem(name, 0, true);
 }
 
 
 #pragma mark - Add methods
 
 
-#define ADD_ORDER_INFO(name, type) 			\
-	type_code code;							\
-	int32 count;							\
-	fBackend.GetInfo(name, &code, &count);	\
-	AddOrderInfo(name, type, 0, count);		\
+#define ADD_ORDER_INFO(name, type) 							\
+	atom_t atom = find_atom(name);							\
+	int32 count = atom != ATOM_INVALID ? CountItems(atom) : 0;	\
+	AddOrderInfo(name, type, 0, count);						\
 
 status_t
 PArgs::AddData(const char *name, type_code type, const void *data, int32 numBytes)
 {
 	ADD_ORDER_INFO(name, type);
-	return fBackend.AddData(name, type, data, numBytes, false);
+	return AddItem(name, type, data, numBytes, false);
 }
 
 
@@ -89,7 +212,7 @@ status_t
 PArgs::AddChar(const char *name, char value)
 {
 	ADD_ORDER_INFO(name, B_CHAR_TYPE);
-	return fBackend.AddData(name, B_CHAR_TYPE, &value, sizeof(char));
+	return AddItem(name, B_CHAR_TYPE, &value, sizeof(char), true);
 }
 
 
@@ -97,7 +220,7 @@ status_t
 PArgs::AddRect(const char *name, BRect value)
 {
 	ADD_ORDER_INFO(name, B_RECT_TYPE);
-	return fBackend.AddRect(name, value);
+	return AddItem(name, B_RECT_TYPE, &value, sizeof(BRect), true);
 }
 
 
@@ -105,7 +228,7 @@ status_t
 PArgs::AddPoint(const char *name, BPoint value)
 {
 	ADD_ORDER_INFO(name, B_POINT_TYPE);
-	return fBackend.AddPoint(name, value);
+	return AddItem(name, B_POINT_TYPE, &value, sizeof(BPoint), true);
 }
 
 
@@ -113,15 +236,16 @@ status_t
 PArgs::AddString(const char *name, const char *value)
 {
 	ADD_ORDER_INFO(name, B_STRING_TYPE);
-	return fBackend.AddString(name, value);
+	if (!value)
+		value = "";
+	return AddItem(name, B_STRING_TYPE, value, strlen(value) + 1, false);
 }
 
 
 status_t
 PArgs::AddString(const char *name, const BString &value)
 {
-	ADD_ORDER_INFO(name, B_STRING_TYPE);
-	return fBackend.AddString(name, value);
+	return AddString(name, value.String());
 }
 
 
@@ -129,7 +253,7 @@ status_t
 PArgs::AddInt8(const char *name, int8 value)
 {
 	ADD_ORDER_INFO(name, B_INT8_TYPE);
-	return fBackend.AddInt8(name, value);
+	return AddItem(name, B_INT8_TYPE, &value, sizeof(int8), true);
 }
 
 
@@ -137,7 +261,7 @@ status_t
 PArgs::AddUInt8(const char *name, uint8 value)
 {
 	ADD_ORDER_INFO(name, B_UINT8_TYPE);
-	return fBackend.AddUInt8(name, value);
+	return AddItem(name, B_UINT8_TYPE, &value, sizeof(uint8), true);
 }
 
 
@@ -145,7 +269,7 @@ status_t
 PArgs::AddInt16(const char *name, int16 value)
 {
 	ADD_ORDER_INFO(name, B_INT16_TYPE);
-	return fBackend.AddInt16(name, value);
+	return AddItem(name, B_INT16_TYPE, &value, sizeof(int16), true);
 }
 
 
@@ -153,7 +277,7 @@ status_t
 PArgs::AddUInt16(const char *name, uint16 value)
 {
 	ADD_ORDER_INFO(name, B_UINT16_TYPE);
-	return fBackend.AddUInt16(name, value);
+	return AddItem(name, B_UINT16_TYPE, &value, sizeof(uint16), true);
 }
 
 
@@ -161,7 +285,7 @@ status_t
 PArgs::AddInt32(const char *name, int32 value)
 {
 	ADD_ORDER_INFO(name, B_INT32_TYPE);
-	return fBackend.AddInt32(name, value);
+	return AddItem(name, B_INT32_TYPE, &value, sizeof(int32), true);
 }
 
 
@@ -169,7 +293,7 @@ status_t
 PArgs::AddUInt32(const char *name, uint32 value)
 {
 	ADD_ORDER_INFO(name, B_UINT32_TYPE);
-	return fBackend.AddUInt32(name, value);
+	return AddItem(name, B_UINT32_TYPE, &value, sizeof(uint32), true);
 }
 
 
@@ -177,7 +301,7 @@ status_t
 PArgs::AddInt64(const char *name, int64 value)
 {
 	ADD_ORDER_INFO(name, B_INT64_TYPE);
-	return fBackend.AddInt64(name, value);
+	return AddItem(name, B_INT64_TYPE, &value, sizeof(int64), true);
 }
 
 
@@ -185,7 +309,7 @@ status_t
 PArgs::AddUInt64(const char *name, uint64 value)
 {
 	ADD_ORDER_INFO(name, B_UINT64_TYPE);
-	return fBackend.AddUInt64(name, value);
+	return AddItem(name, B_UINT64_TYPE, &value, sizeof(uint64), true);
 }
 
 
@@ -193,7 +317,7 @@ status_t
 PArgs::AddBool(const char *name, bool value)
 {
 	ADD_ORDER_INFO(name, B_BOOL_TYPE);
-	return fBackend.AddBool(name, value);
+	return AddItem(name, B_BOOL_TYPE, &value, sizeof(bool), true);
 }
 
 
@@ -201,7 +325,7 @@ status_t
 PArgs::AddFloat(const char *name, float value)
 {
 	ADD_ORDER_INFO(name, B_FLOAT_TYPE);
-	return fBackend.AddFloat(name, value);
+	return AddItem(name, B_FLOAT_TYPE, &value, sizeof(float), true);
 }
 
 
@@ -209,7 +333,7 @@ status_t
 PArgs::AddDouble(const char *name, double value)
 {
 	ADD_ORDER_INFO(name, B_DOUBLE_TYPE);
-	return fBackend.AddDouble(name, value);
+	return AddItem(name, B_DOUBLE_TYPE, &value, sizeof(double), true);
 }
 
 
@@ -217,15 +341,28 @@ status_t
 PArgs::AddPointer(const char *name, const void *value)
 {
 	ADD_ORDER_INFO(name, B_POINTER_TYPE);
-	return fBackend.AddPointer(name, value);
+	return AddItem(name, B_POINTER_TYPE, &value, sizeof(void*), true);
 }
 
 
 status_t
 PArgs::AddMessage(const char *name, const BMessage* value)
 {
+	if (!value)
+		return B_BAD_VALUE;
+	
 	ADD_ORDER_INFO(name, B_MESSAGE_TYPE);
-	return fBackend.AddMessage(name, value);
+	
+	// Messages are stored flattened, like BMessage does it
+	ssize_t size = value->FlattenedSize();
+	char *buffer = (char*)malloc(size);
+	if (!buffer)
+		return B_NO_MEMORY;
+	status_t status = value->Flatten(buffer, size);
+	if (status == B_OK)
+		status = AddItem(name, B_MESSAGE_TYPE, buffer, size, false);
+	free(buffer);
+	return status;
 }
 
 
@@ -233,7 +370,7 @@ status_t
 PArgs::AddMessenger(const char *name, const BMessenger &value)
 {
 	ADD_ORDER_INFO(name, B_MESSENGER_TYPE);
-	return fBackend.AddMessenger(name, value);
+	return AddItem(name, B_MESSENGER_TYPE, &value, sizeof(BMessenger), true);
 }
 
 
@@ -241,15 +378,21 @@ status_t
 PArgs::AddRef(const char *name, const entry_ref &value)
 {
 	ADD_ORDER_INFO(name, B_REF_TYPE);
-	return fBackend.AddRef(name, &value);
+	
+	char buffer[FLAT_REF_SIZE];
+	int32 size;
+	status_t status = FlattenRef(value, buffer, &size);
+	if (status == B_OK)
+		status = AddItem(name, B_REF_TYPE, buffer, size, false);
+	return status;
 }
 
 
 status_t
 PArgs::AddPArg(const char *name, const PArgs &value)
 {
-	ADD_ORDER_INFO(name, B_MESSAGE_TYPE);
-	return fBackend.AddMessage(name, &value.fBackend);
+	BMessage message = value.GetBackend();
+	return AddMessage(name, &message);
 }
 
 
@@ -257,7 +400,7 @@ status_t
 PArgs::AddColor(const char *name, const rgb_color &value)
 {
 	ADD_ORDER_INFO(name, B_RGB_COLOR_TYPE);
-	return fBackend.AddData(name, B_RGB_COLOR_TYPE, &value, sizeof(rgb_color));
+	return AddItem(name, B_RGB_COLOR_TYPE, &value, sizeof(rgb_color), true);
 }
 
 
@@ -268,164 +411,191 @@ status_t
 PArgs::FindData(const char *name, type_code type, const void **data,
 				int32 *numBytes, const int32 index) const
 {
-	return fBackend.FindData(name, type, index, data, (ssize_t*)numBytes);
+	return FindItem(name, type, index, data, numBytes);
 }
 
 
 status_t
 PArgs::FindChar(const char *name, char *value, int32 index) const
 {
-	ssize_t size;
-	return fBackend.FindData(name, B_CHAR_TYPE, index, (const void **)&value, &size);
+	return FindValue(name, B_CHAR_TYPE, index, value, sizeof(char));
 }
 
 
 status_t
 PArgs::FindRect(const char *name, BRect *value, int32 index) const
 {
-	return fBackend.FindRect(name, index, value);
+	return FindValue(name, B_RECT_TYPE, index, value, sizeof(BRect));
 }
 
 
 status_t
 PArgs::FindPoint(const char *name, BPoint *value, int32 index) const
 {
-	return fBackend.FindPoint(name, index, value);
+	return FindValue(name, B_POINT_TYPE, index, value, sizeof(BPoint));
 }
 
 
 status_t
 PArgs::FindString(const char *name, const char **value, int32 index) const
 {
-	return fBackend.FindString(name, index, value);
+	int32 size;
+	return FindItem(name, B_STRING_TYPE, index, (const void **)value, &size);
 }
 
 
 status_t
 PArgs::FindString(const char *name, BString *value, int32 index) const
 {
-	return fBackend.FindString(name, index, value);
+	const char *string;
+	status_t status = FindString(name, &string, index);
+	if (status == B_OK && value)
+		value->SetTo(string);
+	return status;
 }
 
 
 status_t
 PArgs::FindInt8(const char *name, int8 *value, int32 index) const
 {
-	return fBackend.FindInt8(name, index, value);
+	return FindValue(name, B_INT8_TYPE, index, value, sizeof(int8));
 }
 
 
 status_t
 PArgs::FindUInt8(const char *name, uint8 *value, int32 index) const
 {
-	return fBackend.FindUInt8(name, index, value);
+	return FindValue(name, B_UINT8_TYPE, index, value, sizeof(uint8));
 }
 
 
 status_t
 PArgs::FindInt16(const char *name, int16 *value, int32 index) const
 {
-	return fBackend.FindInt16(name, index, value);
+	return FindValue(name, B_INT16_TYPE, index, value, sizeof(int16));
 }
 
 
 status_t
 PArgs::FindUInt16(const char *name, uint16 *value, int32 index) const
 {
-	return fBackend.FindUInt16(name, index, value);
+	return FindValue(name, B_UINT16_TYPE, index, value, sizeof(uint16));
 }
 
 
 status_t
 PArgs::FindInt32(const char *name, int32 *value, int32 index) const
 {
-	return fBackend.FindInt32(name, index, value);
+	return FindValue(name, B_INT32_TYPE, index, value, sizeof(int32));
 }
 
 
 status_t
 PArgs::FindUInt32(const char *name, uint32 *value, int32 index) const
 {
-	return fBackend.FindUInt32(name, index, value);
+	return FindValue(name, B_UINT32_TYPE, index, value, sizeof(uint32));
 }
 
 
 status_t
 PArgs::FindInt64(const char *name, int64 *value, int32 index) const
 {
-	return fBackend.FindInt64(name, index, value);
+	return FindValue(name, B_INT64_TYPE, index, value, sizeof(int64));
 }
 
 
 status_t
 PArgs::FindUInt64(const char *name, uint64 *value, int32 index) const
 {
-	return fBackend.FindUInt64(name, index, value);
+	return FindValue(name, B_UINT64_TYPE, index, value, sizeof(uint64));
 }
 
 
 status_t
 PArgs::FindBool(const char *name, bool *value, int32 index) const
 {
-	return fBackend.FindBool(name, index, value);
+	return FindValue(name, B_BOOL_TYPE, index, value, sizeof(bool));
 }
 
 
 status_t
 PArgs::FindFloat(const char *name, float *value, int32 index) const
 {
-	return fBackend.FindFloat(name, index, value);
+	return FindValue(name, B_FLOAT_TYPE, index, value, sizeof(float));
 }
 
 
 status_t
 PArgs::FindDouble(const char *name, double *value, int32 index) const
 {
-	return fBackend.FindDouble(name, index, value);
+	return FindValue(name, B_DOUBLE_TYPE, index, value, sizeof(double));
 }
 
 
 status_t
 PArgs::FindPointer(const char *name,  void **value, int32 index) const
 {
-	return fBackend.FindPointer(name, index, value);
+	return FindValue(name, B_POINTER_TYPE, index, value, sizeof(void*));
 }
 
 
 status_t
 PArgs::FindMessage(const char *name, BMessage* value, int32 index) const
 {
-	return fBackend.FindMessage(name, index, value);
+	const void *data;
+	int32 size;
+	status_t status = FindItem(name, B_MESSAGE_TYPE, index, &data, &size);
+	if (status != B_OK)
+		return status;
+	return value ? value->Unflatten((const char*)data) : B_BAD_VALUE;
 }
 
 
 status_t
 PArgs::FindMessenger(const char *name, BMessenger *value, int32 index) const
 {
-	return fBackend.FindMessenger(name, index, value);
+	const void *data;
+	int32 size;
+	status_t status = FindItem(name, B_MESSENGER_TYPE, index, &data, &size);
+	if (status != B_OK)
+		return status;
+	if (!value || size != sizeof(BMessenger))
+		return B_BAD_VALUE;
+	*value = *(const BMessenger*)data;
+	return B_OK;
 }
 
 
 status_t
 PArgs::FindRef(const char *name, entry_ref *value, int32 index) const
 {
-	return fBackend.FindRef(name, index, value);
+	const void *data;
+	int32 size;
+	status_t status = FindItem(name, B_REF_TYPE, index, &data, &size);
+	if (status != B_OK)
+		return status;
+	if (!value)
+		return B_BAD_VALUE;
+	
+	return UnflattenRef(data, size, value);
 }
 
 
 status_t
 PArgs::FindPArg(const char *name, PArgs *value, int32 index) const
 {
-	return fBackend.FindMessage(name, index, &value->fBackend);
+	BMessage message;
+	status_t status = FindMessage(name, &message, index);
+	if (status == B_OK && value)
+		value->SetBackend(message);
+	return status;
 }
 
 
 status_t
 PArgs::FindColor(const char *name, rgb_color *value, int32 index) const
 {
-	ssize_t size;
-	return fBackend.FindData(name, B_RGB_COLOR_TYPE, index, 
-							(const void **)&value, &size);
+	return FindValue(name, B_RGB_COLOR_TYPE, index, value, sizeof(rgb_color));
 }
 
 
@@ -436,164 +606,184 @@ status_t
 PArgs::ReplaceData(const char *name, type_code type, const void *data,
 				int32 numBytes, int32 index)
 {
-	return fBackend.ReplaceData(name, type, index, data, numBytes);
+	return ReplaceItem(name, type, index, data, numBytes);
 }
 
 
 status_t
 PArgs::ReplaceChar(const char *name, char value, int32 index)
 {
-	return fBackend.ReplaceData(name, B_CHAR_TYPE, index, &value, sizeof(char));
+	return ReplaceItem(name, B_CHAR_TYPE, index, &value, sizeof(char));
 }
 
 
 status_t
 PArgs::ReplaceRect(const char *name, BRect value, int32 index)
 {
-	return fBackend.ReplaceRect(name, index, value);
+	return ReplaceItem(name, B_RECT_TYPE, index, &value, sizeof(BRect));
 }
 
 
 status_t
 PArgs::ReplacePoint(const char *name, BPoint value, int32 index)
 {
-	return fBackend.ReplacePoint(name, index, value);
+	return ReplaceItem(name, B_POINT_TYPE, index, &value, sizeof(BPoint));
 }
 
 
 status_t
 PArgs::ReplaceString(const char *name, const char *value, int32 index)
 {
-	return fBackend.ReplaceString(name, index, value);
+	if (!value)
+		value = "";
+	return ReplaceItem(name, B_STRING_TYPE, index, value, strlen(value) + 1);
 }
 
 
 status_t
 PArgs::ReplaceString(const char *name, const BString &value, int32 index)
 {
-	return fBackend.ReplaceString(name, index, value);
+	return ReplaceString(name, value.String(), index);
 }
 
 
 status_t
 PArgs::ReplaceInt8(const char *name, int8 value, int32 index)
 {
-	return fBackend.ReplaceInt8(name, index, value);
+	return ReplaceItem(name, B_INT8_TYPE, index, &value, sizeof(int8));
 }
 
 
 status_t
 PArgs::ReplaceUInt8(const char *name, uint8 value, int32 index)
 {
-	return fBackend.ReplaceUInt8(name, index, value);
+	return ReplaceItem(name, B_UINT8_TYPE, index, &value, sizeof(uint8));
 }
 
 
 status_t
 PArgs::ReplaceInt16(const char *name, int16 value, int32 index)
 {
-	return fBackend.ReplaceInt16(name, index, value);
+	return ReplaceItem(name, B_INT16_TYPE, index, &value, sizeof(int16));
 }
 
 
 status_t
 PArgs::ReplaceUInt16(const char *name, uint16 value, int32 index)
 {
-	return fBackend.ReplaceUInt16(name, index, value);
+	return ReplaceItem(name, B_UINT16_TYPE, index, &value, sizeof(uint16));
 }
 
 
 status_t
 PArgs::ReplaceInt32(const char *name, int32 value, int32 index)
 {
-	return fBackend.ReplaceInt32(name, index, value);
+	return ReplaceItem(name, B_INT32_TYPE, index, &value, sizeof(int32));
 }
 
 
 status_t
 PArgs::ReplaceUInt32(const char *name, uint32 value, int32 index)
 {
-	return fBackend.ReplaceUInt32(name, index, value);
+	return ReplaceItem(name, B_UINT32_TYPE, index, &value, sizeof(uint32));
 }
 
 
 status_t
 PArgs::ReplaceInt64(const char *name, int64 value, int32 index)
 {
-	return fBackend.ReplaceInt64(name, index, value);
+	return ReplaceItem(name, B_INT64_TYPE, index, &value, sizeof(int64));
 }
 
 
 status_t
 PArgs::ReplaceUInt64(const char *name, uint64 value, int32 index)
 {
-	return fBackend.ReplaceUInt64(name, index, value);
+	return ReplaceItem(name, B_UINT64_TYPE, index, &value, sizeof(uint64));
 }
 
 
 status_t
 PArgs::ReplaceBool(const char *name, bool value, int32 index)
 {
-	return fBackend.ReplaceBool(name, index, value);
+	return ReplaceItem(name, B_BOOL_TYPE, index, &value, sizeof(bool));
 }
 
 
 status_t
 PArgs::ReplaceFloat(const char *name, float value, int32 index)
 {
-	return fBackend.ReplaceFloat(name, index, value);
+	return ReplaceItem(name, B_FLOAT_TYPE, index, &value, sizeof(float));
 }
 
 
 status_t
 PArgs::ReplaceDouble(const char *name, double value, int32 index)
 {
-	return fBackend.ReplaceDouble(name, index, value);
+	return ReplaceItem(name, B_DOUBLE_TYPE, index, &value, sizeof(double));
 }
 
 
 status_t
 PArgs::ReplacePointer(const char *name, const void *value, int32 index)
 {
-	return fBackend.ReplacePointer(name, index, value);
+	return ReplaceItem(name, B_POINTER_TYPE, index, &value, sizeof(void*));
 }
 
 
 status_t
 PArgs::ReplaceMessage(const char *name, BMessage* value, int32 index)
 {
-	return fBackend.ReplaceMessage(name, index, value);
+	if (!value)
+		return B_BAD_VALUE;
+	
+	ssize_t size = value->FlattenedSize();
+	char *buffer = (char*)malloc(size);
+	if (!buffer)
+		return B_NO_MEMORY;
+	status_t status = value->Flatten(buffer, size);
+	if (status == B_OK)
+		status = ReplaceItem(name, B_MESSAGE_TYPE, index, buffer, size);
+	free(buffer);
+	return status;
 }
 
 
 status_t
 PArgs::ReplaceMessenger(const char *name, BMessenger value, int32 index)
 {
-	return fBackend.ReplaceMessenger(name, index, value);
+	return ReplaceItem(name, B_MESSENGER_TYPE, index, &value,
+						sizeof(BMessenger));
 }
 
 
 status_t
 PArgs::ReplaceRef(const char *name, const entry_ref &value, int32 index)
 {
-	return fBackend.ReplaceRef(name, index, &value);
+	char buffer[FLAT_REF_SIZE];
+	int32 size;
+	status_t status = FlattenRef(value, buffer, &size);
+	if (status == B_OK)
+		status = ReplaceItem(name, B_REF_TYPE, index, buffer, size);
+	return status;
 }
 
 
 status_t
 PArgs::ReplacePArg(const char *name, const PArgs &value, int32 index)
 {
-	return fBackend.ReplaceMessage(name, index, &value.fBackend);
+	BMessage message = value.GetBackend();
+	return ReplaceMessage(name, &message, index);
 }
 
 
 status_t
 PArgs::ReplaceColor(const char *name, const rgb_color &value, int32 index)
 {
-	return fBackend.ReplaceData(name, B_RGB_COLOR_TYPE, index, &value, sizeof(rgb_color));
+	return ReplaceItem(name, B_RGB_COLOR_TYPE, index, &value,
+						sizeof(rgb_color));
 }
 
-
 status_t
 PArgs::AddOrderInfo(const char *fieldName, type_code fieldType,
 								int32 callIndex, int32 fieldIndex)
@@ -601,21 +791,26 @@ PArgs::AddOrderInfo(const char *fieldName, type_code fieldType,
 	if (!fieldName)
 		return B_ERROR;
 	
+	const atom_t *atoms = OrderInfoAtoms();
 	status_t status_t;
 	
-	status_t = fBackend.AddString("fieldname", fieldName);
+	status_t = AddItemByAtom(atoms[ORDER_FIELD_NAME], B_STRING_TYPE,
+							fieldName, strlen(fieldName) + 1, false);
 	if (status_t != B_OK)
 		return status_t;
 	
-	status_t = fBackend.AddInt32("type", fieldType);
+	status_t = AddItemByAtom(atoms[ORDER_TYPE], B_INT32_TYPE, &fieldType,
+							sizeof(int32), true);
 	if (status_t != B_OK)
 		return status_t;
 	
-	status_t = fBackend.AddInt32("callindex", callIndex);
+	status_t = AddItemByAtom(atoms[ORDER_CALL_INDEX], B_INT32_TYPE,
+							&callIndex, sizeof(int32), true);
 	if (status_t != B_OK)
 		return status_t;
 	
-	status_t = fBackend.AddInt32("fieldindex", fieldIndex);
+	status_t = AddItemByAtom(atoms[ORDER_FIELD_INDEX], B_INT32_TYPE,
+							&fieldIndex, sizeof(int32), true);
 	
 	return status_t;
 }
@@ -630,19 +825,19 @@ PArgs::SetOrderInfo(int32 &index, const char *fieldName, type_code fieldType,
 	
 	status_t status_t;
 	
-	status_t = fBackend.ReplaceString("fieldname", index, fieldName);
+	status_t = ReplaceString("fieldname", fieldName, index);
 	if (status_t != B_OK)
 		return status_t;
 	
-	status_t = fBackend.ReplaceInt32("type", index, fieldType);
+	status_t = ReplaceInt32("type", fieldType, index);
 	if (status_t != B_OK)
 		return status_t;
 	
-	status_t = fBackend.ReplaceInt32("callindex", index, callIndex);
+	status_t = ReplaceInt32("callindex", callIndex, index);
 	if (status_t != B_OK)
 		return status_t;
 	
-	status_t = fBackend.ReplaceInt32("fieldindex", index, fieldIndex);
+	status_t = ReplaceInt32("fieldindex", fieldIndex, index);
 	
 	return status_t;
 }
@@ -654,19 +849,19 @@ PArgs::FindOrderInfo(int32 index, BString &fieldName, type_code &fieldType,
 {
 	status_t status_t;
 	
-	status_t = fBackend.FindString("fieldname", index, &fieldName);
+	status_t = FindString("fieldname", &fieldName, index);
 	if (status_t != B_OK)
 		return status_t;
 	
-	status_t = fBackend.FindInt32("type", index, (int32*)&fieldType);
+	status_t = FindInt32("type", (int32*)&fieldType, index);
 	if (status_t != B_OK)
 		return status_t;
 	
-	status_t = fBackend.FindInt32("callindex", index, &callIndex);
+	status_t = FindInt32("callindex", &callIndex, index);
 	if (status_t != B_OK)
 		return status_t;
 	
-	status_t = fBackend.FindInt32("fieldindex", index, &fieldIndex);
+	status_t = FindInt32("fieldindex", &fieldIndex, index);
 	
 	return status_t;
 }
@@ -677,34 +872,429 @@ PArgs::RemoveOrderInfo(const int32 &index)
 {
 	status_t status_t;
 	
-	status_t = fBackend.RemoveData("fieldname", index);
+	status_t = RemoveData("fieldname", index);
 	if (status_t != B_OK)
 		return status_t;
 	
-	status_t = fBackend.RemoveData("type", index);
+	status_t = RemoveData("type", index);
 	if (status_t != B_OK)
 		return status_t;
 	
-	status_t = fBackend.RemoveData("callindex", index);
+	status_t = RemoveData("callindex", index);
 	if (status_t != B_OK)
 		return status_t;
 	
-	status_t = fBackend.RemoveData("fieldindex", index);
+	status_t = RemoveData("fieldindex", index);
 	
 	return status_t;
 }
 
 
+status_t
+PArgs::AddDataByAtom(const atom_t &name, type_code type, const void *data,
+					int32 numBytes, bool fixedSize)
+{
+	const char *string = atom_string(name);
+	if (!string)
+		return B_BAD_VALUE;
+	
+	AddOrderInfo(string, type, 0, CountItems(name));
+	return AddItemByAtom(name, type, data, numBytes, fixedSize);
+}
+
+
+status_t
+PArgs::FindDataByAtom(const atom_t &name, type_code type, const void **data,
+					int32 *numBytes, const int32 index) const
+{
+	return FindItemByAtom(name, type, index, data, numBytes);
+}
+
+
+status_t
+PArgs::ReplaceDataByAtom(const atom_t &name, type_code type, const void *data,
+						int32 numBytes, int32 index)
+{
+	return ReplaceItemByAtom(name, type, index, data, numBytes);
+}
+
+
 void
 PArgs::SetBackend(const BMessage &msg)
 {
-	fBackend = msg;
+	MakeEmpty();
+	
+	char *name;
+	type_code type;
+	int32 count;
+	for (int32 i = 0; msg.GetInfo(B_ANY_TYPE, i, &name, &type, &count) == B_OK;
+		i++)
+	{
+		bool fixedSize = false;
+		msg.GetInfo(name, &type, &fixedSize);
+		for (int32 j = 0; j < count; j++)
+		{
+			const void *data;
+			ssize_t size;
+			if (msg.FindData(name, type, j, &data, &size) == B_OK)
+				AddItem(name, type, data, size, fixedSize);
+		}
+	}
+	
+	// The message already is the backend of the new arguments
+	if (fBackend)
+		*fBackend = msg;
+	else
+		fBackend = new(std::nothrow) BMessage(msg);
+	fBackendValid = fBackend != NULL;
 }
 
 
 BMessage
 PArgs::GetBackend(void) const
 {
-	return fBackend;
+	if (!fBackendValid)
+	{
+		if (fBackend)
+			fBackend->MakeEmpty();
+		else
+		{
+			fBackend = new(std::nothrow) BMessage;
+			if (!fBackend)
+				return BMessage();
+		}
+		
+		for (int32 i = 0; i < fFieldCount; i++)
+		{
+			const field &item = fFields[i];
+			fBackend->AddData(atom_string(item.name), item.type,
+							fData + item.offset, item.size, item.fixedSize);
+		}
+		fBackendValid = true;
+	}
+	return *fBackend;
+}
+
+
+#pragma mark - Flat storage
+
+
+status_t
+PArgs::AddItem(const char *name, type_code type, const void *data, int32 size,
+				bool fixedSize)
+{
+	if (!name)
+		return B_BAD_VALUE;
+	
+	return AddItemByAtom(intern_atom(name), type, data, size, fixedSize);
+}
+
+
+status_t
+PArgs::AddItemByAtom(const atom_t &atom, type_code type, const void *data,
+					int32 size, bool fixedSize)
+{
+	if (atom == ATOM_INVALID || (!data && size > 0))
+		return B_BAD_VALUE;
+	
+	// All items of a field have the same type, like in a BMessage
+	int32 first = FieldIndex(atom, 0);
+	if (first >= 0 && fFields[first].type != type)
+		return B_BAD_TYPE;
+	
+	if (!ReserveFields(fFieldCount + 1))
+		return B_NO_MEMORY;
+	int32 offset = AppendData(data, size);
+	if (offset < 0)
+		return B_NO_MEMORY;
+	
+	field &item = fFields[fFieldCount++];
+	item.name = atom;
+	item.type = type;
+	item.offset = offset;
+	item.size = size;
+	item.fixedSize = fixedSize;
+	
+	fBackendValid = false;
+	return B_OK;
 }
 
+
+status_t
+PArgs::FindItem(const char *name, type_code type, int32 index,
+				const void **data, int32 *size) const
+{
+	if (!name)
+		return B_BAD_VALUE;
+	
+	// A name that was never interned can't be the name of a field
+	return FindItemByAtom(find_atom(name), type, index, data, size);
+}
+
+
+status_t
+PArgs::FindItemByAtom(const atom_t &atom, type_code type, int32 index,
+					const void **data, int32 *size) const
+{
+	if (atom == ATOM_INVALID)
+		return B_NAME_NOT_FOUND;
+	
+	int32 first = FieldIndex(atom, 0);
+	if (first < 0)
+		return B_NAME_NOT_FOUND;
+	if (type != B_ANY_TYPE && fFields[first].type != type)
+		return B_BAD_TYPE;
+	
+	int32 position = FieldIndex(atom, index);
+	if (position < 0)
+		return B_BAD_INDEX;
+	
+	const field &item = fFields[position];
+	if (data)
+		*data = fData + item.offset;
+	if (size)
+		*size = item.size;
+	return B_OK;
+}
+
+
+status_t
+PArgs::FindValue(const char *name, type_code type, int32 index, void *value,
+				int32 size) const
+{
+	const void *data;
+	int32 dataSize;
+	status_t status = FindItem(name, type, index, &data, &dataSize);
+	if (status != B_OK)
+		return status;
+	if (!value || dataSize != size)
+		return B_BAD_VALUE;
+	
+	memcpy(value, data, size);
+	return B_OK;
+}
+
+
+status_t
+PArgs::ReplaceItem(const char *name, type_code type, int32 index,
+					const void *data, int32 size)
+{
+	if (!name)
+		return B_BAD_VALUE;
+	
+	return ReplaceItemByAtom(find_atom(name), type, index, data, size);
+}
+
+
+status_t
+PArgs::ReplaceItemByAtom(const atom_t &atom, type_code type, int32 index,
+						const void *data, int32 size)
+{
+	if (!data && size > 0)
+		return B_BAD_VALUE;
+	
+	int32 first = atom != ATOM_INVALID ? FieldIndex(atom, 0) : -1;
+	if (first < 0)
+		return B_NAME_NOT_FOUND;
+	if (fFields[first].type != type)
+		return B_BAD_TYPE;
+	
+	int32 position = FieldIndex(atom, index);
+	if (position < 0)
+		return B_BAD_INDEX;
+	
+	int32 unused;
+	if (size <= fFields[position].size)
+	{
+		memcpy(fData + fFields[position].offset, data, size);
+		unused = fFields[position].size - size;
+	}
+	else
+	{
+		// The old data is left behind until the buffer is compacted
+		int32 offset = AppendData(data, size);
+		if (offset < 0)
+			return B_NO_MEMORY;
+		fFields[position].offset = offset;
+		unused = fFields[position].size;
+	}
+	fFields[position].size = size;
+	fUnusedData += unused;
+	
+	fBackendValid = false;
+	return B_OK;
+}
+
+
+status_t
+PArgs::RemoveItem(const char *name, int32 index, bool all)
+{
+	if (!name)
+		return B_BAD_VALUE;
+	
+	atom_t atom = find_atom(name);
+	int32 position = atom != ATOM_INVALID ? FieldIndex(atom, 0) : -1;
+	if (position < 0)
+		return B_NAME_NOT_FOUND;
+	if (!all)
+	{
+		position = FieldIndex(atom, index);
+		if (position < 0)
+			return B_BAD_INDEX;
+	}
+	
+	int32 kept = position;
+	for (int32 i = position; i < fFieldCount; i++)
+	{
+		if (fFields[i].name == atom && (all || i == position))
+		{
+			fUnusedData += fFields[i].size;
+			continue;
+		}
+		fFields[kept++] = fFields[i];
+	}
+	fFieldCount = kept;
+	
+	fBackendValid = false;
+	return B_OK;
+}
+
+
+int32
+PArgs::FieldIndex(const atom_t &name, int32 index) const
+{
+	for (int32 i = 0; i < fFieldCount; i++)
+	{
+		if (fFields[i].name != name)
+			continue;
+		if (index == 0)
+			return i;
+		index--;
+	}
+	return -1;
+}
+
+
+int32
+PArgs::CountItems(const atom_t &name) const
+{
+	int32 count = 0;
+	for (int32 i = 0; i < fFieldCount; i++)
+	{
+		if (fFields[i].name == name)
+			count++;
+	}
+	return count;
+}
+
+
+int32
+PArgs::AppendData(const void *data, int32 size)
+{
+	int32 offset = (fDataSize + 7) & ~7;
+	// Dropping the unused data is cheaper than growing the buffer if it takes
+	// up half of it, so replacing items doesn't grow the buffer without limit
+	if (offset + size > fDataCapacity && fUnusedData > 0
+		&& fUnusedData >= fDataSize / 2)
+	{
+		CompactData(size);
+		offset = (fDataSize + 7) & ~7;
+	}
+	if (!ReserveData(offset + size))
+		return -1;
+	
+	if (size > 0)
+		memcpy(fData + offset, data, size);
+	fDataSize = offset + size;
+	return offset;
+}
+
+
+void
+PArgs::CompactData(int32 reserve)
+{
+	// The items are copied in field order, into a new buffer or back into
+	// the inline one if they fit together with reserve more bytes
+	int32 size = 0;
+	for (int32 i = 0; i < fFieldCount; i++)
+		size = ((size + 7) & ~7) + fFields[i].size;
+	size = ((size + 7) & ~7) + reserve;
+	
+	char inlineCopy[INLINE_DATA];
+	const char *source = fData;
+	char *data = fInlineData;
+	int32 capacity = INLINE_DATA;
+	if (fData == fInlineData)
+	{
+		memcpy(inlineCopy, fInlineData, fDataSize);
+		source = inlineCopy;
+	}
+	else if (size > INLINE_DATA)
+	{
+		capacity = size > fDataCapacity ? size : fDataCapacity;
+		data = (char*)malloc(capacity);
+		if (!data)
+			return;
+	}
+	
+	int32 offset = 0;
+	for (int32 i = 0; i < fFieldCount; i++)
+	{
+		field &item = fFields[i];
+		offset = (offset + 7) & ~7;
+		memcpy(data + offset, source + item.offset, item.size);
+		item.offset = offset;
+		offset += item.size;
+	}
+	
+	if (fData != fInlineData)
+		free(fData);
+	fData = data;
+	fDataSize = offset;
+	fDataCapacity = capacity;
+	fUnusedData = 0;
+}
+
+
+bool
+PArgs::ReserveFields(int32 count)
+{
+	if (count <= fFieldCapacity)
+		return true;
+	
+	int32 capacity = fFieldCapacity * 2;
+	if (capacity < count)
+		capacity = count;
+	field *fields = (field*)malloc(capacity * sizeof(field));
+	if (!fields)
+		return false;
+	
+	memcpy(fields, fFields, fFieldCount * sizeof(field));
+	if (fFields != fInlineFields)
+		free(fFields);
+	fFields = fields;
+	fFieldCapacity = capacity;
+	return true;
+}
+
+
+bool
+PArgs::ReserveData(int32 size)
+{
+	if (size <= fDataCapacity)
+		return true;
+	
+	int32 capacity = fDataCapacity * 2;
+	if (capacity < size)
+		capacity = size;
+	char *data = (char*)malloc(capacity);
+	if (!data)
+		return false;
+	
+	memcpy(data, fData, fDataSize);
+	if (fData != fInlineData)
+		free(fData);
+	fData = data;
+	fDataCapacity = capacity;
+	return true;
+}
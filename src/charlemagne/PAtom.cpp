@@ -0,0 +1,207 @@
+#include "PAtom.h"
+
+#include <OpenHashTable.h>
+#include <String.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The entries are allocated in blocks that never move, so the string and the
+// folded atom of an atom can be read without any lock once it is published.
+enum
+{
+	ATOM_BLOCK_SIZE		= 1024,
+	ATOM_MAX_BLOCKS		= 4096
+};
+
+struct atom_entry
+{
+	atom_entry		*next;
+	const char		*string;
+	size_t			hash;
+	atom_t			atom;
+	atom_t			folded;
+};
+
+
+static size_t
+hash_atom_string(const char *string)
+{
+	size_t hash = 5381;
+	for (; *string != '\0'; string++)
+		hash = hash * 33 + (uint8)*string;
+	return hash;
+}
+
+
+struct AtomHashDefinition
+{
+	typedef const char *	KeyType;
+	typedef atom_entry		ValueType;
+	
+	size_t HashKey(const char *key) const
+	{
+		return hash_atom_string(key);
+	}
+	
+	size_t Hash(atom_entry *value) const
+	{
+		return value->hash;
+	}
+	
+	bool Compare(const char *key, atom_entry *value) const
+	{
+		return strcmp(key, value->string) == 0;
+	}
+	
+	atom_entry *&GetLink(atom_entry *value) const
+	{
+		return value->next;
+	}
+};
+
+
+class AtomTable
+{
+public:
+	AtomTable(void)
+		:	count(0)
+	{
+		pthread_rwlock_init(&lock, NULL);
+		atoms.Init();
+		memset(blocks, 0, sizeof(blocks));
+	}
+	
+	// Guards atoms, lookups only need a read lock
+	pthread_rwlock_t						lock;
+	BOpenHashTable<AtomHashDefinition>		atoms;
+	atom_entry								*blocks[ATOM_MAX_BLOCKS];
+	int32									count;
+};
+
+
+static AtomTable &
+GetAtomTable(void)
+{
+	// Created on first use because atoms are already interned by static
+	// constructors, e.g. the ones of the property roster.
+	static AtomTable *sTable = new AtomTable;
+	return *sTable;
+}
+
+
+static atom_entry *
+EntryAt(AtomTable &table, const atom_t &atom)
+{
+	if (atom < 0 || atom >= atomic_get(&table.count))
+		return NULL;
+	return &table.blocks[atom / ATOM_BLOCK_SIZE][atom % ATOM_BLOCK_SIZE];
+}
+
+
+static atom_t
+InternLocked(AtomTable &table, const char *string)
+{
+	atom_entry *existing = table.atoms.Lookup(string);
+	if (existing)
+		return existing->atom;
+	
+	BString lower(string);
+	lower.ToLower();
+	atom_t folded = ATOM_INVALID;
+	if (strcmp(lower.String(), string) != 0)
+	{
+		folded = InternLocked(table, lower.String());
+		if (folded == ATOM_INVALID)
+			return ATOM_INVALID;
+	}
+	
+	atom_t atom = table.count;
+	int32 block = atom / ATOM_BLOCK_SIZE;
+	if (block >= ATOM_MAX_BLOCKS)
+		return ATOM_INVALID;
+	if (!table.blocks[block])
+	{
+		table.blocks[block] = (atom_entry *)calloc(ATOM_BLOCK_SIZE,
+													sizeof(atom_entry));
+		if (!table.blocks[block])
+			return ATOM_INVALID;
+	}
+	
+	atom_entry *entry = &table.blocks[block][atom % ATOM_BLOCK_SIZE];
+	entry->string = strdup(string);
+	entry->hash = hash_atom_string(string);
+	entry->atom = atom;
+	entry->folded = folded == ATOM_INVALID ? atom : folded;
+	table.atoms.Insert(entry);
+	
+	// publishes the entry to the lock-free readers
+	atomic_set(&table.count, atom + 1);
+	return atom;
+}
+
+
+atom_t
+intern_atom(const char *string)
+{
+	if (!string)
+		return ATOM_INVALID;
+	
+	atom_t atom = find_atom(string);
+	if (atom != ATOM_INVALID)
+		return atom;
+	
+	AtomTable &table = GetAtomTable();
+	pthread_rwlock_wrlock(&table.lock);
+	atom = InternLocked(table, string);
+	pthread_rwlock_unlock(&table.lock);
+	return atom;
+}
+
+
+atom_t
+find_atom(const char *string)
+{
+	if (!string)
+		return ATOM_INVALID;
+	
+	AtomTable &table = GetAtomTable();
+	pthread_rwlock_rdlock(&table.lock);
+	atom_entry *entry = table.atoms.Lookup(string);
+	atom_t atom = entry ? entry->atom : ATOM_INVALID;
+	pthread_rwlock_unlock(&table.lock);
+	return atom;
+}
+
+
+const char *
+atom_string(const atom_t &atom)
+{
+	atom_entry *entry = EntryAt(GetAtomTable(), atom);
+	return entry ? entry->string : NULL;
+}
+
+
+atom_t
+fold_atom(const atom_t &atom)
+{
+	atom_entry *entry = EntryAt(GetAtomTable(), atom);
+	return entry ? entry->folded : ATOM_INVALID;
+}
+
+
+atom_t
+find_folded_atom(const char *string)
+{
+	if (!string)
+		return ATOM_INVALID;
+	
+	atom_t atom = find_atom(string);
+	if (atom != ATOM_INVALID)
+		return fold_atom(atom);
+	
+	// Every string is interned together with its lower case version
+	BString lower(string);
+	lower.ToLower();
+	return find_atom(lower.String());
+}
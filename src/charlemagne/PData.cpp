@@ -1,41 +1,66 @@
 #include "PData.h"
+#include "PPropertySchema.h"
 #include <stdio.h>
+#include <pthread.h>
 #include <ClassInfo.h>
 
+
+// Serializes un-sharing a slot with sharing it. Const readers un-share the
+// slots they expose, so without it two readers of one object could both
+// replace and release the same slot, and a copy could take a new reference to
+// a slot that is being exposed.
+static pthread_mutex_t sShareLock = PTHREAD_MUTEX_INITIALIZER;
+
+
+static void
+ReleasePropertyData(PropertyData *data)
+{
+	if (atomic_add(&data->refCount, -1) == 1)
+		delete data;
+}
+
+
 PData::PData(void)
 	:	fType("PData"),
 		fFriendlyType("Generic Data Container")
 {
-#if B_HAIKU_VERSION > B_HAIKU_VERSION_1_BETA_5
-	fPropertyList = new BObjectList<PropertyData, true>(20);
-#else
-	fPropertyList = new BObjectList<PropertyData>(20,true);
-#endif
+	fPropertyList = new BObjectList<PropertyData>(20);
 }
 
 
 PData::PData(BMessage *msg)
 	:	fType("PData")
 {
-#if B_HAIKU_VERSION > B_HAIKU_VERSION_1_BETA_5
-	fPropertyList = new BObjectList<PropertyData, true>(20);
-#else
-	fPropertyList = new BObjectList<PropertyData>(20,true);
-#endif
+	fPropertyList = new BObjectList<PropertyData>(20);
 	
 	if (msg->FindString("type",&fType) != B_OK)
 		fType = "PData";
 	
-	int32 i = 0; 
-	BMessage propmsg;
-	while (msg->FindMessage("property",i++,&propmsg) == B_OK)
+	int64 schemaID;
+	if (msg->FindInt64("schema",&schemaID) == B_OK)
 	{
-		BString ptype;
-		if (propmsg.FindString("type",&ptype) != B_OK)
-			continue;
-		PProperty *p = gPropertyRoster.MakeProperty(ptype.String(),&propmsg);
-		if (p)
-			AddProperty(p);
+		// a row of values, the properties are described by its schema
+		PPropertySchema *schema = PPropertySchema::FindSchema(schemaID);
+		if (schema)
+		{
+			fType = schema->GetType();
+			schema->InstantiateValues(msg,this);
+		}
+	}
+	else
+	{
+		int32 i = 0; 
+		BMessage propmsg;
+		while (msg->FindMessage("property",i++,&propmsg) == B_OK)
+		{
+			BString ptype;
+			if (propmsg.FindString("type",&ptype) != B_OK)
+				continue;
+			PProperty *p = gPropertyRoster.MakeProperty(ptype.String(),
+															&propmsg);
+			if (p)
+				AddProperty(p);
+		}
 	}
 }
 
@@ -43,22 +68,14 @@ PData::PData(BMessage *msg)
 PData::PData(const char *name)
 	:	fType("PData")
 {
-#if B_HAIKU_VERSION > B_HAIKU_VERSION_1_BETA_5
-	fPropertyList = new BObjectList<PropertyData, true>(20);
-#else
-	fPropertyList = new BObjectList<PropertyData>(20,true);
-#endif
+	fPropertyList = new BObjectList<PropertyData>(20);
 }
 
 
 PData::PData(const PData &from)
 	:	fType("PData")
 {
-#if B_HAIKU_VERSION > B_HAIKU_VERSION_1_BETA_5
-	fPropertyList = new BObjectList<PropertyData, true>(20);
-#else
-	fPropertyList = new BObjectList<PropertyData>(20,true);
-#endif
+	fPropertyList = new BObjectList<PropertyData>(20);
 	*this = from;
 }
 
@@ -66,9 +83,11 @@ PData::PData(const PData &from)
 PData &
 PData::operator=(const PData &from)
 {
-	fPropertyList->MakeEmpty();
-	for (int32 i = 0; i < from.CountProperties(); i++)
-		AddProperty(from.PropertyAt(i)->Duplicate());
+	if (&from == this)
+		return *this;
+	
+	ReleaseProperties();
+	ShareProperties(from);
 	fType = from.fType;
 	return *this;
 }
@@ -90,6 +109,7 @@ PData::operator[](const BString &name)
 
 PData::~PData(void)
 {
+	ReleaseProperties();
 	delete fPropertyList;
 }
 
@@ -146,6 +166,16 @@ PData::Archive(BMessage *data, bool deep) const
 }
 
 
+status_t
+PData::ArchiveValues(BMessage *data, BMessage *schemas) const
+{
+	status_t status = BArchivable::Archive(data, false);
+	if (status == B_OK)
+		status = PPropertySchema::ArchiveRow(fType, this, data, schemas);
+	return status;
+}
+
+
 int32
 PData::CountProperties(const char *name) const
 {
@@ -153,26 +183,22 @@ PData::CountProperties(const char *name) const
 	if (!name)
 		return count;
 	
-	int32 propertyCount = 0;
-	for (int32 i = 0; i < count; i++)
-	{
-		PProperty *p = PropertyAt(i);
-		if (p->GetName().ICompare(name) == 0)
-			propertyCount++;
-	}
+	// Every property name is interned together with its lower case version
+	atom_t folded = find_folded_atom(name);
+	if (folded == ATOM_INVALID)
+		return 0;
 	
-	return propertyCount;
+	int32 *foldedCount;
+	if (!fFoldedCounts.Get(folded, foldedCount))
+		return 0;
+	return *foldedCount;
 }
 
 
 PProperty *
 PData::PropertyAt(const int32 &index) const
 {
-	if (index < 0 || index > fPropertyList->CountItems() - 1)
-		return NULL;
-	
-	PropertyData *d = fPropertyList->ItemAt(index);
-	return d ? d->value : NULL;
+	return ExposePropertyAt(index);
 }
 
 
@@ -184,8 +210,7 @@ PData::IndexOfProperty(PProperty *p) const
 	
 	for (int32 i = 0; i < fPropertyList->CountItems(); i++)
 	{
-		PProperty *item = PropertyAt(i);
-		if (item == p)
+		if (fPropertyList->ItemAt(i)->value == p)
 			return i;
 	}
 	
@@ -196,30 +221,29 @@ PData::IndexOfProperty(PProperty *p) const
 PProperty *
 PData::FindProperty(const BString &name, const int32 &index) const
 {
-	if (name.CountChars() < 1)
+	return FindProperty(name.String(),index);
+}
+
+
+PProperty *
+PData::FindProperty(const char *name, const int32 &index) const
+{
+	if (!name || name[0] == '\0')
 		return NULL;
 	
-	int32 current = 0;
-	for (int32 i = 0; i < fPropertyList->CountItems(); i++)
-	{
-		PProperty *p = PropertyAt(i);
-		if (p->GetName().Compare(name) == 0)
-		{
-			if (current == index)
-				return p;
-			else
-				current++;
-		}
-	}
+	// A name that was never interned can't belong to a property
+	atom_t atom = find_atom(name);
+	if (atom == ATOM_INVALID)
+		return NULL;
 	
-	return NULL;
+	return FindPropertyByAtom(atom,index);
 }
 
 
 PProperty *
-PData::FindProperty(const char *name, const int32 &index) const
+PData::FindPropertyByAtom(const atom_t &name, const int32 &index) const
 {
-	return FindProperty(BString(name),index);
+	return ExposePropertyAt(FindPropertySlot(name,index));
 }
 
 
@@ -229,13 +253,21 @@ PData::AddProperty(PProperty *p, uint32 flags, int32 index)
 	if (!p)
 		return false;
 	
-	if (FindProperty(p->GetName()) && ((FlagsForProperty(p) & PROPERTY_ALLOW_MULTIPLE) == 0))
+	if (p->GetName().CountChars() > 0 && FindPropertySlot(p->GetNameAtom()) >= 0
+		&& ((FlagsForProperty(p) & PROPERTY_ALLOW_MULTIPLE) == 0))
 		return false;
 	
-	if (index >= 0)
+	p->fOwner = this;
+	if (index >= 0 && index < fPropertyList->CountItems())
+	{
 		fPropertyList->AddItem(new PropertyData(p,flags),index);
+		RebuildIndex();
+	}
 	else
+	{
 		fPropertyList->AddItem(new PropertyData(p,flags));
+		IndexProperty(fPropertyList->CountItems() - 1);
+	}
 	return true;
 }
 
@@ -243,16 +275,18 @@ PData::AddProperty(PProperty *p, uint32 flags, int32 index)
 PProperty *
 PData::RemoveProperty(const int32 &index)
 {
-	PropertyData *d = fPropertyList->RemoveItemAt(index);
-	if (d)
-	{
-		PProperty *p = d->value;
-		d->value = NULL;
-		delete d;
-		return p;
-	}
+	// the caller gets the property, so it has to be a private one
+	PropertyData *d = MakePropertyPrivate(index);
+	if (!d)
+		return NULL;
 	
-	return NULL;
+	fPropertyList->RemoveItemAt(index);
+	RebuildIndex();
+	PProperty *p = d->value;
+	p->fOwner = NULL;
+	d->value = NULL;
+	delete d;
+	return p;
 }
 
 
@@ -262,7 +296,20 @@ PData::RemoveProperty(PProperty *p)
 	int32 index = IndexOfProperty(p);
 	if (index < 0)
 		return;
-	fPropertyList->RemoveItemAt(index);
+	
+	// p stays alive, it belongs to the caller now unless other objects still
+	// share it
+	PropertyData *d = fPropertyList->RemoveItemAt(index);
+	if (p->fOwner == this)
+		p->fOwner = NULL;
+	if (atomic_get(&d->refCount) > 1)
+		ReleasePropertyData(d);
+	else
+	{
+		d->value = NULL;
+		delete d;
+	}
+	RebuildIndex();
 }
 
 
@@ -277,8 +324,9 @@ PData::PropertyFlagsAt(const int32 &index) const
 void
 PData::SetFlagsForProperty(PProperty *p, const int32 &flags)
 {
-	PropertyData *pdata = fPropertyList->ItemAt(IndexOfProperty(p));
-	pdata->flags = flags;
+	PropertyData *pdata = MakePropertyPrivate(IndexOfProperty(p));
+	if (pdata)
+		pdata->flags = flags;
 }
 
 
@@ -295,11 +343,7 @@ PData::SetProperty(const char *name, PValue *value, const int32 &index)
 	if (!name || !value)
 		return B_ERROR;
 	
-	PProperty *p = FindProperty(name,index);
-	if (!p)
-		return B_NAME_NOT_FOUND;
-	
-	return p->SetValue(value);
+	return SetPropertyByAtom(find_atom(name),value,index);
 }
 
 
@@ -309,7 +353,31 @@ PData::GetProperty(const char *name, PValue *value, const int32 &index) const
 	if (!name || !value)
 		return B_ERROR;
 	
-	PProperty *p = FindProperty(name,index);
+	return GetPropertyByAtom(find_atom(name),value,index);
+}
+
+
+status_t
+PData::SetPropertyByAtom(const atom_t &name, PValue *value, const int32 &index)
+{
+	if (!value)
+		return B_ERROR;
+	
+	PropertyData *d = MakePropertyPrivate(FindPropertySlot(name,index));
+	if (!d)
+		return B_NAME_NOT_FOUND;
+	
+	return d->value->SetValue(value);
+}
+
+
+status_t
+PData::GetPropertyByAtom(const atom_t &name, PValue *value, const int32 &index) const
+{
+	if (!value)
+		return B_ERROR;
+	
+	PProperty *p = SharedPropertyAt(FindPropertySlot(name,index));
 	if (!p)
 		return B_NAME_NOT_FOUND;
 	
@@ -478,8 +546,156 @@ PData::PrintToStream(void)
 {
 	for (int32 i = 0; i < fPropertyList->CountItems(); i++)
 	{
-		PProperty *p = PropertyAt(i);
+		PProperty *p = SharedPropertyAt(i);
 		printf("Property: Name is %s, Type is %s, Value is %s\n",p->GetName().String(),
 				p->GetType().String(), p->GetValueAsString().String());
 	}
 }
+
+
+int32
+PData::FindPropertySlot(const atom_t &name, const int32 &index) const
+{
+	if (name == ATOM_INVALID || index < 0)
+		return -1;
+	
+	std::vector<int32> *slots;
+	if (!fPropertyIndex.Get(name, slots) || index >= (int32)slots->size())
+		return -1;
+	return (*slots)[index];
+}
+
+
+PProperty *
+PData::SharedPropertyAt(const int32 &index) const
+{
+	PropertyData *d = fPropertyList->ItemAt(index);
+	return d ? d->value : NULL;
+}
+
+
+void
+PData::ReplaceProperty(const int32 &index, PProperty *p, uint32 flags)
+{
+	PropertyData *d = fPropertyList->ItemAt(index);
+	if (!d || !p)
+		return;
+	
+	if (d->value->fOwner == this)
+		d->value->fOwner = NULL;
+	p->fOwner = this;
+	fPropertyList->ReplaceItem(index, new PropertyData(p,flags));
+	ReleasePropertyData(d);
+	RebuildIndex();
+}
+
+
+void
+PData::ShareProperties(const PData &from)
+{
+	pthread_mutex_lock(&sShareLock);
+	for (int32 i = 0; i < from.fPropertyList->CountItems(); i++)
+	{
+		PropertyData *d = from.fPropertyList->ItemAt(i);
+		if (d->exposed)
+		{
+			PProperty *copy = d->value->Duplicate();
+			copy->fOwner = this;
+			fPropertyList->AddItem(new PropertyData(copy, d->flags));
+			continue;
+		}
+		
+		atomic_add(&d->refCount, 1);
+		fPropertyList->AddItem(d);
+	}
+	pthread_mutex_unlock(&sShareLock);
+	RebuildIndex();
+}
+
+
+void
+PData::ReleaseProperties(void)
+{
+	for (int32 i = 0; i < fPropertyList->CountItems(); i++)
+	{
+		// a slot that is still shared gets a new owner once it is private
+		PropertyData *d = fPropertyList->ItemAt(i);
+		if (d->value->fOwner == this)
+			d->value->fOwner = NULL;
+		ReleasePropertyData(d);
+	}
+	fPropertyList->MakeEmpty();
+	fPropertyIndex.Clear();
+	fFoldedCounts.Clear();
+}
+
+
+PropertyData *
+PData::MakePropertyPrivate(const int32 &index, bool expose) const
+{
+	pthread_mutex_lock(&sShareLock);
+	
+	// Read under the lock, another reader may have replaced the slot already
+	PropertyData *d = fPropertyList->ItemAt(index);
+	if (d && atomic_get(&d->refCount) > 1)
+	{
+		// The slot positions and names don't change, so the index stays valid
+		PropertyData *copy = new PropertyData(d->value->Duplicate(), d->flags);
+		fPropertyList->ReplaceItem(index, copy);
+		ReleasePropertyData(d);
+		d = copy;
+	}
+	if (d)
+	{
+		d->value->fOwner = const_cast<PData *>(this);
+		if (expose)
+			d->exposed = true;
+	}
+	
+	pthread_mutex_unlock(&sShareLock);
+	return d;
+}
+
+
+PProperty *
+PData::ExposePropertyAt(const int32 &index) const
+{
+	PropertyData *d = MakePropertyPrivate(index, true);
+	return d ? d->value : NULL;
+}
+
+
+void
+PData::PropertyRenamed(PProperty *p)
+{
+	RebuildIndex();
+}
+
+
+void
+PData::IndexProperty(const int32 &index)
+{
+	atom_t atom = fPropertyList->ItemAt(index)->value->GetNameAtom();
+	std::vector<int32> *slots;
+	if (fPropertyIndex.Get(atom, slots))
+		slots->push_back(index);
+	else
+		fPropertyIndex.Put(atom, std::vector<int32>(1, index));
+	
+	atom_t folded = fold_atom(atom);
+	int32 *count;
+	if (fFoldedCounts.Get(folded, count))
+		(*count)++;
+	else
+		fFoldedCounts.Put(folded, 1);
+}
+
+
+void
+PData::RebuildIndex(void)
+{
+	fPropertyIndex.Clear();
+	fFoldedCounts.Clear();
+	for (int32 i = 0; i < fPropertyList->CountItems(); i++)
+		IndexProperty(i);
+}
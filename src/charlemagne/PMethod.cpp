@@ -1,12 +1,15 @@
 #include "PMethod.h"
 #include <Errors.h>
 
+static int32 sNameGeneration = 0;
+
 PMethod::PMethod(const char *name, MethodFunction func, PMethodInterface *interface,
 				const int32 &flags)
 	:	fName(name),
 		fFlags(flags)
 {
 	fFunction = func;
+	fNameAtom = intern_atom(fName.String());
 	if (interface)
 		fInterface = *interface;
 }
@@ -32,6 +35,7 @@ PMethod::operator=(const PMethod &from)
 	fFunction = from.fFunction;
 	fFlags = from.fFlags;
 	fInterface = from.fInterface;
+	fNameAtom = from.fNameAtom;
 	
 	return *this;
 }
@@ -40,7 +44,13 @@ PMethod::operator=(const PMethod &from)
 void
 PMethod::SetName(const char *name)
 {
-	fName = name;
+	BString newName(name);
+	if (fName == newName)
+		return;
+	
+	atomic_add(&sNameGeneration, 1);
+	fName = newName;
+	fNameAtom = intern_atom(fName.String());
 }
 
 
@@ -58,6 +68,20 @@ PMethod::GetName(void) const
 }
 
 
+atom_t
+PMethod::GetNameAtom(void) const
+{
+	return fNameAtom;
+}
+
+
+int32
+PMethod::NameGeneration(void)
+{
+	return atomic_get(&sNameGeneration);
+}
+
+
 void
 PMethod::SetInterface(PMethodInterface &interface)
 {
@@ -1,27 +1,262 @@
 #include "PObject.h"
 #include "PArgs.h"
 #include "PObjectBroker.h"
+#include "PPropertySchema.h"
 
+#include <Autolock.h>
 #include <ClassInfo.h>
+#include <HashMap.h>
+#include <Locker.h>
+#include <OpenHashTable.h>
 #include <stdio.h>
 
+#include <vector>
+
+// What a method table is looked up by: the object's type and method names
+struct method_table_key
+{
+	PObject			*object;
+	atom_t			type;
+	size_t			hash;
+};
+
+
+/*
+	The method slots of a type. There is one table for every type and set of
+	method names, it is shared by all objects that have them. Tables are never
+	changed or deleted once they are built, so an object can switch to another
+	table while a different thread still looks up a method in the old one.
+*/
+class PMethodTable
+{
+public:
+							PMethodTable(const method_table_key &key);
+			
+			bool			Matches(const method_table_key &key) const;
+			int32			FindMethod(const atom_t &folded) const;
+			int32			FindInheritedMethod(const atom_t &folded) const;
+	
+	static	size_t			HashMethods(PObject *object,
+										const atom_t &type);
+	
+			size_t			Hash(void) const { return fHash; }
+	
+			PMethodTable	*fNext;
+	
+private:
+	typedef BPrivate::HashMap<BPrivate::HashKey32<atom_t>, int32> SlotMap;
+	
+			void			AddSlots(std::vector<atom_t> &atoms, SlotMap &slots,
+									PMethod *method);
+			int32			FindSlot(const SlotMap &slots,
+									const atom_t &folded) const;
+	
+	atom_t					fType;
+	size_t					fHash;
+	std::vector<atom_t>		fMethods,
+							fInherited;
+	SlotMap					fMethodSlots,
+							fInheritedSlots;
+};
+
+
+struct MethodTableDefinition
+{
+	typedef method_table_key	KeyType;
+	typedef PMethodTable		ValueType;
+	
+	size_t HashKey(const method_table_key &key) const
+	{
+		return key.hash;
+	}
+	
+	size_t Hash(PMethodTable *value) const
+	{
+		return value->Hash();
+	}
+	
+	bool Compare(const method_table_key &key, PMethodTable *value) const
+	{
+		return value->Matches(key);
+	}
+	
+	PMethodTable *&GetLink(PMethodTable *value) const
+	{
+		return value->fNext;
+	}
+};
+
+
+/*
+	The methods, inherited methods and interfaces of an object. Duplicates of
+	an object share its lists, a private copy is made by the first object that
+	changes them.
+*/
+class PMethodLists
+{
+public:
+							PMethodLists(void);
+							~PMethodLists(void);
+	
+	int32					refCount;
+#if B_HAIKU_VERSION > B_HAIKU_VERSION_1_BETA_5
+	BObjectList<PMethod, true>		*methods;
+	BObjectList<PMethod, true>		*inherited;
+	BObjectList<BString, true>		*interfaces;
+#else
+	BObjectList<PMethod>	*methods;
+	BObjectList<PMethod>	*inherited;
+	BObjectList<BString>	*interfaces;
+#endif
+};
+
+
+typedef BOpenHashTable<MethodTableDefinition> MethodTableMap;
+
+// Only needed to find or add a table, lookups in a table don't lock
+static BLocker sMethodTableLock;
+static MethodTableMap sMethodTables;
+
+
+// Used while the methods are set up, looking them up through the method table
+// would publish a table of a half constructed object.
+template<class List>
+static PMethod *
+FindMethodInList(List *list, const BString &name)
+{
+	for (int32 i = 0; i < list->CountItems(); i++)
+	{
+		PMethod *item = list->ItemAt(i);
+		if (item->GetName().ICompare(name) == 0)
+			return item;
+	}
+	return NULL;
+}
+
+
+PMethodLists::PMethodLists(void)
+	:	refCount(1)
+{
+#if B_HAIKU_VERSION > B_HAIKU_VERSION_1_BETA_5
+	methods = new BObjectList<PMethod, true>(20);
+	inherited = new BObjectList<PMethod, true>(20);
+	interfaces = new BObjectList<BString, true>(20);
+#else
+	methods = new BObjectList<PMethod>(20,true);
+	inherited = new BObjectList<PMethod>(20,true);
+	interfaces = new BObjectList<BString>(20,true);
+#endif
+}
+
+
+PMethodLists::~PMethodLists(void)
+{
+	delete methods;
+	delete inherited;
+	delete interfaces;
+}
+
+
+PMethodTable::PMethodTable(const method_table_key &key)
+	:	fNext(NULL),
+		fType(key.type),
+		fHash(key.hash)
+{
+	PObject *object = key.object;
+	for (int32 i = 0; i < object->CountMethods(); i++)
+		AddSlots(fMethods, fMethodSlots, object->MethodAt(i));
+	for (int32 i = 0; i < object->CountInheritedMethods(); i++)
+		AddSlots(fInherited, fInheritedSlots, object->InheritedMethodAt(i));
+}
+
+
+bool
+PMethodTable::Matches(const method_table_key &key) const
+{
+	PObject *object = key.object;
+	if (key.type != fType || key.hash != fHash
+		|| (int32)fMethods.size() != object->CountMethods()
+		|| (int32)fInherited.size() != object->CountInheritedMethods())
+		return false;
+	
+	for (int32 i = 0; i < object->CountMethods(); i++)
+	{
+		if (object->MethodAt(i)->GetNameAtom() != fMethods[i])
+			return false;
+	}
+	for (int32 i = 0; i < object->CountInheritedMethods(); i++)
+	{
+		if (object->InheritedMethodAt(i)->GetNameAtom() != fInherited[i])
+			return false;
+	}
+	return true;
+}
+
+
+int32
+PMethodTable::FindMethod(const atom_t &folded) const
+{
+	return FindSlot(fMethodSlots, folded);
+}
+
+
+int32
+PMethodTable::FindInheritedMethod(const atom_t &folded) const
+{
+	return FindSlot(fInheritedSlots, folded);
+}
+
+
+size_t
+PMethodTable::HashMethods(PObject *object, const atom_t &type)
+{
+	size_t hash = type;
+	for (int32 i = 0; i < object->CountMethods(); i++)
+		hash = hash * 31 + object->MethodAt(i)->GetNameAtom();
+	// keeps a method from hashing like an inherited one
+	hash = hash * 31 + object->CountMethods();
+	for (int32 i = 0; i < object->CountInheritedMethods(); i++)
+		hash = hash * 31 + object->InheritedMethodAt(i)->GetNameAtom();
+	return hash;
+}
+
+
+void
+PMethodTable::AddSlots(std::vector<atom_t> &atoms, SlotMap &slots,
+						PMethod *method)
+{
+	atom_t atom = method->GetNameAtom();
+	
+	// Names are matched case-insensitively and the first method of a name
+	// wins, like the linear search did.
+	atom_t folded = fold_atom(atom);
+	if (!slots.ContainsKey(folded))
+		slots.Put(folded, atoms.size());
+	atoms.push_back(atom);
+}
+
+
+int32
+PMethodTable::FindSlot(const SlotMap &slots, const atom_t &folded) const
+{
+	int32 *slot;
+	return slots.Get(folded, slot) ? *slot : -1;
+}
+
+
 PObject::PObject(void)
 	:	fType("PObject"),
 		fFriendlyType("Generic Object")
 {
 #if B_HAIKU_VERSION > B_HAIKU_VERSION_1_BETA_5
-	fPropertyList = new BObjectList<PropertyData, true>(20);
-	fInheritedList = new BObjectList<PMethod, true>(20);
-	fInterfaceList = new BObjectList<BString, true>(20);
-	fMethodList = new BObjectList<PMethod, true>(20);
 	fEventList = new BObjectList<EventData, true>(20);
 #else
-	fPropertyList = new BObjectList<PropertyData>(20,true);
-	fInheritedList = new BObjectList<PMethod>(20,true);
-	fInterfaceList = new BObjectList<BString>(20,true);
-	fMethodList = new BObjectList<PMethod>(20,true);
 	fEventList = new BObjectList<EventData>(20,true);
 #endif
+	fMethodLists = NULL;
+	SetMethodLists(new PMethodLists);
+	fMethodTable = NULL;
+	fMethodGeneration = 0;
 	
 	PObjectBroker::RegisterObject(this);
 	
@@ -34,38 +269,47 @@ PObject::PObject(BMessage *msg)
 	:	fType("PObject")
 {
 #if B_HAIKU_VERSION > B_HAIKU_VERSION_1_BETA_5
-	fPropertyList = new BObjectList<PropertyData, true>(20);
-	fInheritedList = new BObjectList<PMethod, true>(20);
-	fInterfaceList = new BObjectList<BString, true>(20);
-	fMethodList = new BObjectList<PMethod, true>(20);
 	fEventList = new BObjectList<EventData, true>(20);
 #else
-	fPropertyList = new BObjectList<PropertyData>(20,true);
-	fInheritedList = new BObjectList<PMethod>(20,true);
-	fInterfaceList = new BObjectList<BString>(20,true);
-	fMethodList = new BObjectList<PMethod>(20,true);
 	fEventList = new BObjectList<EventData>(20,true);
 #endif
+	fMethodLists = NULL;
+	SetMethodLists(new PMethodLists);
+	fMethodTable = NULL;
+	fMethodGeneration = 0;
 
 	PObjectBroker::RegisterObject(this);
 	if (msg->FindString("type",&fType) != B_OK)
 		fType = "PObject";
 	
-	int32 i = 0; 
-	BMessage propmsg;
-	while (msg->FindMessage("property",i++,&propmsg) == B_OK)
+	int64 schemaID;
+	if (msg->FindInt64("schema",&schemaID) == B_OK)
 	{
-		BString ptype;
-		if (propmsg.FindString("type",&ptype) != B_OK)
-			continue;
-		PProperty *p = gPropertyRoster.MakeProperty(ptype.String(),&propmsg);
-		if (p)
-			AddProperty(p);
+		// a row of values, the properties are described by its schema
+		PPropertySchema *schema = PPropertySchema::FindSchema(schemaID);
+		if (schema)
+		{
+			fType = schema->GetType();
+			schema->InstantiateValues(msg,this);
+		}
+	}
+	else
+	{
+		int32 i = 0; 
+		BMessage propmsg;
+		while (msg->FindMessage("property",i++,&propmsg) == B_OK)
+		{
+			BString ptype;
+			if (propmsg.FindString("type",&ptype) != B_OK)
+				continue;
+			PProperty *p = gPropertyRoster.MakeProperty(ptype.String(),
+															&propmsg);
+			if (p)
+				AddProperty(p);
+		}
 	}
 	
-	RemoveProperty(FindProperty("ObjectID"));
-	AddProperty(new IntProperty("ObjectID", GetID(), "Unique identifier of the object"),
-				PROPERTY_READ_ONLY);
+	SetObjectIDProperty();
 }
 
 
@@ -73,18 +317,14 @@ PObject::PObject(const char *name)
 	:	fType("PObject")
 {
 #if B_HAIKU_VERSION > B_HAIKU_VERSION_1_BETA_5
-	fPropertyList = new BObjectList<PropertyData, true>(20);
-	fInheritedList = new BObjectList<PMethod, true>(20);
-	fInterfaceList = new BObjectList<BString, true>(20);
-	fMethodList = new BObjectList<PMethod, true>(20);
 	fEventList = new BObjectList<EventData, true>(20);
 #else
-	fPropertyList = new BObjectList<PropertyData>(20,true);
-	fInheritedList = new BObjectList<PMethod>(20,true);
-	fInterfaceList = new BObjectList<BString>(20,true);
-	fMethodList = new BObjectList<PMethod>(20,true);
 	fEventList = new BObjectList<EventData>(20,true);
 #endif
+	fMethodLists = NULL;
+	SetMethodLists(new PMethodLists);
+	fMethodTable = NULL;
+	fMethodGeneration = 0;
 
 	PObjectBroker::RegisterObject(this);
 	AddProperty(new IntProperty("ObjectID", GetID(), "Unique identifier of the object"),
@@ -97,18 +337,15 @@ PObject::PObject(const PObject &from)
 	:	fType("PObject")
 {
 #if B_HAIKU_VERSION > B_HAIKU_VERSION_1_BETA_5
-	fPropertyList = new BObjectList<PropertyData, true>(20);
-	fInheritedList = new BObjectList<PMethod, true>(20);
-	fInterfaceList = new BObjectList<BString, true>(20);
-	fMethodList = new BObjectList<PMethod, true>(20);
 	fEventList = new BObjectList<EventData, true>(20);
 #else
-	fPropertyList = new BObjectList<PropertyData>(20,true);
-	fInheritedList = new BObjectList<PMethod>(20,true);
-	fInterfaceList = new BObjectList<BString>(20,true);
-	fMethodList = new BObjectList<PMethod>(20,true);
 	fEventList = new BObjectList<EventData>(20,true);
 #endif
+	// operator= shares the method lists of from
+	fMethodLists = NULL;
+	SetMethodLists(NULL);
+	fMethodTable = NULL;
+	fMethodGeneration = 0;
 
 	PObjectBroker::RegisterObject(this);
 	*this = from;
@@ -118,25 +355,19 @@ PObject::PObject(const PObject &from)
 PObject &
 PObject::operator=(const PObject &from)
 {
-	fPropertyList->MakeEmpty();
-	for (int32 i = 0; i < from.CountProperties(); i++)
-		AddProperty(from.PropertyAt(i)->Duplicate());
-	fType = from.fType;
-	RemoveProperty(FindProperty("ObjectID"));
-	AddProperty(new IntProperty("ObjectID", GetID(), "Unique identifier of the object"),
-				PROPERTY_READ_ONLY);
+	if (&from == this)
+		return *this;
 	
-	fInheritedList->MakeEmpty();
-	for (int32 i = 0; i < from.CountInheritedMethods(); i++)
-		AddInheritedMethod(new PMethod(*from.MethodAt(i)));
+	InvalidateMethodTable();
 	
-	fInterfaceList->MakeEmpty();
-	for (int32 i = 0; i < from.CountInterfaces(); i++)
-		AddInterface(from.InterfaceAt(i));
+	// The properties and methods are shared with from until either side
+	// changes them
+	PData::operator=(from);
+	fType = from.fType;
+	SetObjectIDProperty();
 	
-	fMethodList->MakeEmpty();
-	for (int32 i = 0; i < from.CountMethods(); i++)
-		AddMethod(new PMethod(*from.MethodAt(i)));
+	atomic_add(&from.fMethodLists->refCount, 1);
+	SetMethodLists(from.fMethodLists);
 	
 	fEventList->MakeEmpty();
 	
@@ -160,15 +391,17 @@ PObject::operator[](const BString &name)
 
 PObject::~PObject(void)
 {
+	// Objects deleted through PObjectBroker::DeleteObject() are already gone
+	// from the registry, all others leave it as early as possible
+	PObjectBroker *broker = PObjectBroker::GetBrokerInstance();
+	broker->UnregisterObject(this);
+	
 	PArgs in, out;
 	RunEvent("Destroy", in, out);
 	
-	PObjectBroker *broker = PObjectBroker::GetBrokerInstance();
-	broker->UnregisterObject(this);
+	InvalidateMethodTable();
 	
-	delete fPropertyList;
-	delete fInterfaceList;
-	delete fMethodList;
+	SetMethodLists(NULL);
 	delete fEventList;
 }
 
@@ -207,15 +440,12 @@ PObject::Archive(BMessage *data, bool deep) const
 	
 	for (int32 i = 0; i < CountProperties(); i++)
 	{
-		PropertyData *d = fPropertyList->ItemAt(i);
-		if (d == NULL)
-			continue;
 		BMessage msg;
-		d->value->Archive(&msg);
+		SharedPropertyAt(i)->Archive(&msg);
 		status = data->AddMessage("property",&msg);
 		if (status != B_OK)
 			return status;
-		status = data->AddInt32("propertyflags",d->flags);
+		status = data->AddInt32("propertyflags",PropertyFlagsAt(i));
 		if (status != B_OK)
 			return status;
 	}
@@ -227,6 +457,16 @@ PObject::Archive(BMessage *data, bool deep) const
 }
 
 
+status_t
+PObject::ArchiveValues(BMessage *data, BMessage *schemas) const
+{
+	status_t status = BArchivable::Archive(data, false);
+	if (status == B_OK)
+		status = PPropertySchema::ArchiveRow(fType, this, data, schemas);
+	return status;
+}
+
+
 uint64
 PObject::GetID(void) const
 {
@@ -237,7 +477,13 @@ PObject::GetID(void) const
 status_t
 PObject::RunMethod(const char *name, PArgs &in, PArgs &out, void *extraData)
 {
-	PMethod *method = FindMethod(name);
+	return RunMethod(FindMethod(name), in, out, extraData);
+}
+
+
+status_t
+PObject::RunMethod(PMethod *method, PArgs &in, PArgs &out, void *extraData)
+{
 	if (!method)
 		return B_NAME_NOT_FOUND;
 	
@@ -252,13 +498,20 @@ PObject::FindMethod(const char *name)
 	if (!name)
 		return NULL;
 	
-	for (int32 i = 0; i < fMethodList->CountItems(); i++)
-	{
-		PMethod *item = fMethodList->ItemAt(i);
-		if (item->GetName().ICompare(name) == 0)
-			return item;
-	}
-	return NULL;
+	// Method names are matched case-insensitively
+	return FindMethodByAtom(find_folded_atom(name));
+}
+
+
+PMethod *
+PObject::FindMethodByAtom(const atom_t &name)
+{
+	atom_t folded = fold_atom(name);
+	if (folded == ATOM_INVALID)
+		return NULL;
+	
+	int32 slot = GetMethodTable()->FindMethod(folded);
+	return slot >= 0 ? fMethodList->ItemAt(slot) : NULL;
 }
 
 
@@ -280,12 +533,7 @@ status_t
 PObject::RunInheritedMethod(const char *name, PArgs &in, PArgs &out,
 							void *extraData)
 {
-	PMethod *method = FindInheritedMethod(name);
-	if (!method)
-		return B_NAME_NOT_FOUND;
-	
-	method->Run(this, in, out, extraData);
-	return B_OK;
+	return RunMethod(FindInheritedMethod(name), in, out, extraData);
 }
 
 
@@ -295,13 +543,19 @@ PObject::FindInheritedMethod(const char *name)
 	if (!name)
 		return NULL;
 	
-	for (int32 i = 0; i < fInheritedList->CountItems(); i++)
-	{
-		PMethod *item = fInheritedList->ItemAt(i);
-		if (item->GetName().ICompare(name) == 0)
-			return item;
-	}
-	return NULL;
+	return FindInheritedMethodByAtom(find_folded_atom(name));
+}
+
+
+PMethod *
+PObject::FindInheritedMethodByAtom(const atom_t &name)
+{
+	atom_t folded = fold_atom(name);
+	if (folded == ATOM_INVALID)
+		return NULL;
+	
+	int32 slot = GetMethodTable()->FindInheritedMethod(folded);
+	return slot >= 0 ? fInheritedList->ItemAt(slot) : NULL;
 }
 
 
@@ -397,7 +651,7 @@ PObject::PrintToStream(void)
 		printf("\tNone\n");
 	for (int32 i = 0; i < CountProperties(); i++)
 	{
-		PProperty *p = PropertyAt(i);
+		PProperty *p = SharedPropertyAt(i);
 		printf("\t%s (%s): %s\n",p->GetName().String(),
 				p->GetType().String(), p->GetValueAsString().String());
 	}
@@ -595,6 +849,7 @@ PObject::AddInterface(const char *name)
 	if (!name || UsesInterface(name))
 		return;
 	
+	MakeMethodsPrivate();
 	fInterfaceList->AddItem(new BString(name));
 }
 
@@ -610,7 +865,8 @@ PObject::RemoveInterface(const char *name)
 		BString *str = fInterfaceList->ItemAt(i);
 		if (str && str->ICompare(name) == 0)
 		{
-			fInterfaceList->RemoveItemAt(i);
+			MakeMethodsPrivate();
+			str = fInterfaceList->RemoveItemAt(i);
 			delete str;
 			return;
 		}
@@ -624,9 +880,11 @@ PObject::AddMethod(PMethod *method)
 	if (!method)
 		return B_ERROR;
 	
-	if (FindMethod(method->GetName().String()))
+	if (FindMethodInList(fMethodList, method->GetName()))
 		return B_NAME_IN_USE;
 	
+	InvalidateMethodTable();
+	MakeMethodsPrivate();
 	fMethodList->AddItem(method);
 	
 	return B_OK;
@@ -644,6 +902,8 @@ PObject::RemoveMethod(const char *name)
 		PMethod *item = fMethodList->ItemAt(i);
 		if (item->GetName().ICompare(name) == 0)
 		{
+			InvalidateMethodTable();
+			MakeMethodsPrivate();
 			fMethodList->RemoveItemAt(i);
 			return B_OK;
 		}
@@ -662,7 +922,11 @@ PObject::ReplaceMethod(const char *old, PMethod *newMethod)
 	RemoveMethod(old);
 	
 	if (newMethod)
+	{
+		InvalidateMethodTable();
+		MakeMethodsPrivate();
 		fMethodList->AddItem(newMethod);
+	}
 	return B_OK;
 }
 
@@ -673,9 +937,11 @@ PObject::AddInheritedMethod(PMethod *method)
 	if (!method)
 		return B_ERROR;
 	
-	if (FindInheritedMethod(method->GetName().String()))
+	if (FindMethodInList(fInheritedList, method->GetName()))
 		return B_NAME_IN_USE;
 	
+	InvalidateMethodTable();
+	MakeMethodsPrivate();
 	fInheritedList->AddItem(method);
 	
 	return B_OK;
@@ -769,6 +1035,86 @@ PObject::ConnectEvent(const char *name, MethodFunction func, void *extraData)
 }
 
 
+PMethodTable *
+PObject::GetMethodTable(void)
+{
+	int32 generation = PMethod::NameGeneration();
+	PMethodTable *table = fMethodTable;
+	if (table && fMethodGeneration == generation)
+		return table;
+	
+	method_table_key key;
+	key.object = this;
+	key.type = intern_atom(fType.String());
+	key.hash = PMethodTable::HashMethods(this, key.type);
+	
+	BAutolock locker(sMethodTableLock);
+	if (sMethodTables.TableSize() == 0)
+		sMethodTables.Init();
+	table = sMethodTables.Lookup(key);
+	if (!table)
+	{
+		table = new PMethodTable(key);
+		sMethodTables.Insert(table);
+	}
+	
+	fMethodTable = table;
+	fMethodGeneration = generation;
+	return table;
+}
+
+
+void
+PObject::InvalidateMethodTable(void)
+{
+	// the table itself stays, other objects or threads may still use it
+	fMethodTable = NULL;
+}
+
+
+void
+PObject::SetMethodLists(PMethodLists *lists)
+{
+	if (fMethodLists && atomic_add(&fMethodLists->refCount, -1) == 1)
+		delete fMethodLists;
+	
+	fMethodLists = lists;
+	fMethodList = lists ? lists->methods : NULL;
+	fInheritedList = lists ? lists->inherited : NULL;
+	fInterfaceList = lists ? lists->interfaces : NULL;
+}
+
+
+void
+PObject::MakeMethodsPrivate(void)
+{
+	if (atomic_get(&fMethodLists->refCount) == 1)
+		return;
+	
+	PMethodLists *lists = new PMethodLists;
+	for (int32 i = 0; i < fMethodList->CountItems(); i++)
+		lists->methods->AddItem(new PMethod(*fMethodList->ItemAt(i)));
+	for (int32 i = 0; i < fInheritedList->CountItems(); i++)
+		lists->inherited->AddItem(new PMethod(*fInheritedList->ItemAt(i)));
+	for (int32 i = 0; i < fInterfaceList->CountItems(); i++)
+		lists->interfaces->AddItem(new BString(*fInterfaceList->ItemAt(i)));
+	SetMethodLists(lists);
+}
+
+
+void
+PObject::SetObjectIDProperty(void)
+{
+	PProperty *id = new IntProperty("ObjectID", GetID(),
+									"Unique identifier of the object");
+	int32 slot = FindPropertySlot(id->GetNameAtom());
+	if (slot >= 0)
+		ReplaceProperty(slot, id, PROPERTY_READ_ONLY);
+	else
+		AddProperty(id, PROPERTY_READ_ONLY);
+}
+
+
 PObject *
 MakeObject(const char *type)
 {
@@ -1,8 +1,12 @@
 #include "PObjectBroker.h"
 #include "PProperty.h"
 
+#include <Autolock.h>
+#include <HashMap.h>
 #include <Locker.h>
 #include <stdio.h>
+
+#include <vector>
 /*
 #include "PApplication.h"
 #include "PControl.h"
@@ -23,8 +27,26 @@
 #include "PWindow.h"
 */
 static PObjectBroker *sBroker = NULL;
-static uint64 sNextID = 1;
-BLocker sIDLock;
+static int64 sNextID = 1;
+static atom_t sApplicationType = fold_atom(intern_atom("PApplication"));
+
+
+class PObjectBroker::ObjectShard
+{
+public:
+	struct object_entry
+	{
+		PObject	*object;
+		// Owned objects were made by the broker and are deleted with it
+		bool	owned;
+	};
+	
+	typedef HashMap<HashKey64<uint64>, object_entry> ObjectMap;
+	
+	BLocker		lock;
+	ObjectMap	objects;
+};
+
 
 void
 InitObjectSystem(void)
@@ -49,12 +71,11 @@ PObjectBroker::PObjectBroker(void)
 		pApp(NULL)
 {
 #if B_HAIKU_VERSION > B_HAIKU_VERSION_1_BETA_5
-	fObjectList = new BObjectList<PObject, true>(20);
 	fObjInfoList = new BObjectList<PObjectInfo, true>(20);
 #else
-	fObjectList = new BObjectList<PObject>(20,true);
 	fObjInfoList = new BObjectList<PObjectInfo>(20,true);
 #endif
+	fShards = new ObjectShard[OBJECT_SHARD_COUNT];
 	
 /*	fObjInfoList->AddItem(new PObjectInfo("PObject","Generic Object",PObject::Instantiate,
 											PObject::Create));
@@ -96,11 +117,28 @@ PObjectBroker::~PObjectBroker(void)
 {
 	fQuitting = true;
 	
-	if (pApp)
-		fObjectList->RemoveItem(pApp, false);
+	std::vector<PObject*> owned;
+	for (int32 i = 0; i < OBJECT_SHARD_COUNT; i++)
+	{
+		ObjectShard &shard = fShards[i];
+		BAutolock locker(shard.lock);
+		ObjectShard::ObjectMap::Iterator it = shard.objects.GetIterator();
+		while (it.HasNext())
+		{
+			ObjectShard::object_entry entry = it.Next().value;
+			if (entry.owned && entry.object != pApp)
+				owned.push_back(entry.object);
+		}
+		shard.objects.Clear();
+	}
+	
+	// Deleted outside of the shard locks, the destructors call back into the
+	// broker
+	for (unsigned int i = 0; i < owned.size(); i++)
+		delete owned[i];
 	
-	delete fObjectList;
 	delete fObjInfoList;
+	delete[] fShards;
 	
 	delete pApp;
 }
@@ -112,38 +150,106 @@ PObjectBroker::MakeObject(const char *type, BMessage *msg)
 	if (!type)
 		return NULL;
 	
-	if (pApp && BString(type).ICompare("PApplication") == 0)
+	return MakeObject(find_folded_atom(type), msg);
+}
+
+
+PObject *
+PObjectBroker::MakeObject(const atom_t &type, BMessage *msg)
+{
+	atom_t folded = fold_atom(type);
+	if (pApp && folded == sApplicationType)
 		return pApp;
 	
-	PObjectInfo *info = NULL;
-	for (int32 i = 0; i < fObjInfoList->CountItems(); i++)
+	PObjectInfo *info = FindObjectInfo(folded);
+	if (!info)
+		return NULL;
+	
+	PObject *obj = msg ? (PObject*)info->arcfunc(msg) : info->createfunc();
+	if (!obj)
+		return NULL;
+	AddObject(obj, true);
+	
+	if (!pApp && obj->GetType().Compare("PApplication") == 0)
+		pApp = obj;
+	
+	return obj;
+}
+
+
+int32
+PObjectBroker::MakeObjects(const char *type, const int32 &count,
+							PObject **objects)
+{
+	if (!type)
+		return 0;
+	
+	return MakeObjects(find_folded_atom(type), count, objects);
+}
+
+
+int32
+PObjectBroker::MakeObjects(const atom_t &type, const int32 &count,
+							PObject **objects)
+{
+	if (!objects || count <= 0)
+		return 0;
+	
+	atom_t folded = fold_atom(type);
+	if (folded == sApplicationType)
 	{
-		PObjectInfo *temp = fObjInfoList->ItemAt(i);
-		if (temp->type.ICompare(type) == 0)
-		{
-			info = temp;
-			break;
-		}
+		// There is only one application object
+		objects[0] = MakeObject(folded);
+		return objects[0] ? 1 : 0;
 	}
 	
-	if (info)
+	PObjectInfo *info = FindObjectInfo(folded);
+	if (!info)
+		return 0;
+	
+	int32 made = 0;
+	for (int32 i = 0; i < count; i++)
 	{
-		PObject *obj = msg ? (PObject*)info->arcfunc(msg) : info->createfunc();
-		fObjectList->AddItem(obj);
-		
-		if (!pApp && obj->GetType().Compare("PApplication") == 0)
-			pApp = obj;
-		
-		return obj;
+		PObject *obj = info->createfunc();
+		if (obj)
+			objects[made++] = obj;
+	}
+	AddObjects(objects, made, true);
+	
+	return made;
+}
+
+
+status_t
+PObjectBroker::AddType(const char *type, const char *friendlyType,
+						MakeFromArchiveFunc arcfunc, MakeObjectFunc createfunc)
+{
+	if (!type || !createfunc)
+		return B_BAD_VALUE;
+	
+	atom_t folded = fold_atom(intern_atom(type));
+	
+	BAutolock locker(fTypeLock);
+	if (fTypeIndex.ContainsKey(folded))
+		return B_NAME_IN_USE;
+	
+	PObjectInfo *info = new PObjectInfo(type, friendlyType, arcfunc,
+										createfunc);
+	fObjInfoList->AddItem(info);
+	if (fTypeIndex.Put(folded, info) != B_OK)
+	{
+		fObjInfoList->RemoveItem(info);
+		return B_NO_MEMORY;
 	}
 	
-	return NULL;
+	return B_OK;
 }
 
 
 int32
 PObjectBroker::CountTypes(void) const
 {
+	BAutolock locker(fTypeLock);
 	return fObjInfoList->CountItems();
 }
 
@@ -151,6 +257,7 @@ PObjectBroker::CountTypes(void) const
 BString
 PObjectBroker::TypeAt(const int32 &index) const
 {
+	BAutolock locker(fTypeLock);
 	PObjectInfo *info = fObjInfoList->ItemAt(index);
 	BString str;
 	if (info)
@@ -163,6 +270,7 @@ PObjectBroker::TypeAt(const int32 &index) const
 BString
 PObjectBroker::FriendlyTypeAt(const int32 &index) const
 {
+	BAutolock locker(fTypeLock);
 	PObjectInfo *info = fObjInfoList->ItemAt(index);
 	BString str;
 	if (info)
@@ -179,14 +287,24 @@ PObjectBroker::FindObject(const uint64 &id)
 	if (!id)
 		return NULL;
 	
-	for (int32 i = 0; i < fObjectList->CountItems(); i++)
+	ObjectShard *shard = ShardFor(id);
+	BAutolock locker(shard->lock);
+	ObjectShard::object_entry *entry;
+	return shard->objects.Get(id, entry) ? entry->object : NULL;
+}
+
+
+int32
+PObjectBroker::CountObjects(void) const
+{
+	int32 count = 0;
+	for (int32 i = 0; i < OBJECT_SHARD_COUNT; i++)
 	{
-		PObject *obj = fObjectList->ItemAt(i);
-		if (obj && obj->GetID() == id)
-			return obj;
+		ObjectShard &shard = fShards[i];
+		BAutolock locker(shard.lock);
+		count += shard.objects.Size();
 	}
-	
-	return NULL;
+	return count;
 }
 
 
@@ -203,12 +321,17 @@ PObjectBroker::GetBrokerInstance(void)
 void
 PObjectBroker::RegisterObject(PObject *obj)
 {
+	// atomic_add64() returns the previous value
 	if (obj)
-	{
-		sIDLock.Lock();
-		obj->fObjectID = sNextID++;
-		sIDLock.Unlock();
-	}
+		obj->fObjectID = atomic_add64(&sNextID, 1);
+}
+
+
+void
+PObjectBroker::PublishObject(PObject *obj)
+{
+	if (obj)
+		AddObject(obj, false);
 }
 
 
@@ -217,13 +340,24 @@ PObjectBroker::UnregisterObject(PObject *obj)
 {
 	if (obj && !fQuitting)
 	{
-		sIDLock.Lock();
-		fObjectList->RemoveItem(obj,false);
-		sIDLock.Unlock();
+		ObjectShard *shard = ShardFor(obj->GetID());
+		BAutolock locker(shard->lock);
+		shard->objects.Remove(obj->GetID());
 	}
 }
 
 
+void
+PObjectBroker::DeleteObject(PObject *obj)
+{
+	if (!obj)
+		return;
+	
+	UnregisterObject(obj);
+	delete obj;
+}
+
+
 void
 PObjectBroker::MessageReceived(BMessage *msg)
 {
@@ -234,8 +368,7 @@ PObjectBroker::MessageReceived(BMessage *msg)
 			int64 id;
 			if (msg->FindInt64("id", &id) == B_OK)
 			{
-				PObject *obj = FindObject(id);
-				delete obj;
+				DeleteObject(FindObject(id));
 			}
 			break;
 		}
@@ -248,14 +381,80 @@ PObjectBroker::MessageReceived(BMessage *msg)
 PObjectInfo *
 PObjectBroker::FindObjectInfo(const char *type)
 {
-	for (int32 i = 0; i < fObjInfoList->CountItems(); i++)
+	if (!type)
+		return NULL;
+	
+	// Unlike the type atom lookups, a type string has to match exactly
+	PObjectInfo *info = FindObjectInfo(find_folded_atom(type));
+	return info && info->type == type ? info : NULL;
+}
+
+
+PObjectInfo *
+PObjectBroker::FindObjectInfo(const atom_t &type)
+{
+	if (type == ATOM_INVALID)
+		return NULL;
+	
+	BAutolock locker(fTypeLock);
+	PObjectInfo **info;
+	return fTypeIndex.Get(fold_atom(type), info) ? *info : NULL;
+}
+
+
+PObjectBroker::ObjectShard *
+PObjectBroker::ShardFor(const uint64 &id) const
+{
+	// ids are handed out in sequence, so consecutive objects land in
+	// different shards
+	return &fShards[id % OBJECT_SHARD_COUNT];
+}
+
+
+void
+PObjectBroker::AddObject(PObject *obj, bool owned)
+{
+	ObjectShard *shard = ShardFor(obj->GetID());
+	BAutolock locker(shard->lock);
+	AddLocked(*shard, obj, owned);
+}
+
+
+void
+PObjectBroker::AddObjects(PObject **objects, const int32 &count, bool owned)
+{
+	// Sort the objects by shard first so that every shard is locked only once
+	std::vector<int32> shardObjects[OBJECT_SHARD_COUNT];
+	for (int32 i = 0; i < count; i++)
+		shardObjects[objects[i]->GetID() % OBJECT_SHARD_COUNT].push_back(i);
+	
+	for (int32 i = 0; i < OBJECT_SHARD_COUNT; i++)
+	{
+		if (shardObjects[i].empty())
+			continue;
+		
+		ObjectShard &shard = fShards[i];
+		BAutolock locker(shard.lock);
+		for (unsigned int j = 0; j < shardObjects[i].size(); j++)
+			AddLocked(shard, objects[shardObjects[i][j]], owned);
+	}
+}
+
+
+void
+PObjectBroker::AddLocked(ObjectShard &shard, PObject *obj, bool owned)
+{
+	ObjectShard::object_entry *existing;
+	if (shard.objects.Get(obj->GetID(), existing))
 	{
-		PObjectInfo *oinfo = fObjInfoList->ItemAt(i);
-		if (oinfo->type == type)
-			return oinfo;
+		existing->owned = existing->owned || owned;
+		return;
 	}
 	
-	return NULL;
+	ObjectShard::object_entry entry;
+	entry.object = obj;
+	entry.owned = owned;
+	shard.objects.Put(obj->GetID(), entry);
 }
 
 
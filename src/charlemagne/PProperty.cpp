@@ -1,31 +1,37 @@
 #include "PProperty.h"
 #include <ClassInfo.h>
+#include "PData.h"
 #include "PObject.h"
 #include "PObjectBroker.h"
 
 PropertyRoster gPropertyRoster;
 
 PProperty::PProperty(void)
-	:	fReadOnly(false),
+	:	fOwner(NULL),
+		fReadOnly(false),
 		fEnabled(true)
 {
 	fType = new BString();
 	fName = new BString();
 	fDescription = new BString();
+	fNameAtom = intern_atom("");
 }
 
 
 PProperty::PProperty(const char *name)
-	:	fReadOnly(false)
+	:	fOwner(NULL),
+		fReadOnly(false)
 {
 	fType = new BString();
 	fName = new BString(name);
 	fDescription = new BString();
+	fNameAtom = intern_atom(fName->String());
 }
 
 
 PProperty::PProperty(BMessage *msg)
-	:	BArchivable(msg)
+	:	BArchivable(msg),
+		fOwner(NULL)
 {
 	fType = new BString();
 	fName = new BString();
@@ -44,20 +50,20 @@ PProperty::PProperty(BMessage *msg)
 	bool b;
 	if (msg->FindBool("readonly",&b) == B_OK)
 		fReadOnly = b;
+	
+	fNameAtom = intern_atom(fName->String());
 }
 
 
 PProperty::PProperty(const PProperty &from)
+	:	fNameAtom(from.fNameAtom),
+		fOwner(NULL),
+		fReadOnly(from.fReadOnly),
+		fEnabled(from.fEnabled)
 {
-	fType = new BString();
-	fName = new BString();
-	fDescription = new BString();
-	
-	if (!fReadOnly)
-	{
-		*fName = *from.fName;
-		*fType = *from.fType;
-	}
+	fType = new BString(*from.fType);
+	fName = new BString(*from.fName);
+	fDescription = new BString(*from.fDescription);
 }
 
 
@@ -117,7 +123,13 @@ PProperty::Archive(BMessage *data, bool deep) const
 void
 PProperty::SetName(const BString &name)
 {
+	if (*fName == name)
+		return;
+	
 	*fName = name;
+	fNameAtom = intern_atom(fName->String());
+	if (fOwner)
+		fOwner->PropertyRenamed(this);
 }
 
 
@@ -135,6 +147,13 @@ PProperty::GetName(void) const
 }
 
 
+atom_t
+PProperty::GetNameAtom(void) const
+{
+	return fNameAtom;
+}
+
+
 bool
 PProperty::IsReadOnly(void) const
 {
@@ -278,6 +297,13 @@ StringProperty::StringProperty(BMessage *msg)
 }
 
 	
+StringProperty::StringProperty(const StringProperty &from)
+	:	PProperty(from)
+{
+	fStringValue = new StringValue(*from.fStringValue);
+}
+
+
 StringProperty::~StringProperty(void)
 {
 	delete fStringValue;
@@ -405,6 +431,13 @@ CharProperty::CharProperty(BMessage *msg)
 }
 
 	
+CharProperty::CharProperty(const CharProperty &from)
+	:	PProperty(from)
+{
+	fCharValue = new CharValue(*from.fCharValue);
+}
+
+
 CharProperty::~CharProperty(void)
 {
 	delete fCharValue;
@@ -519,6 +552,13 @@ BoolProperty::BoolProperty(BMessage *msg)
 }
 
 	
+BoolProperty::BoolProperty(const BoolProperty &from)
+	:	PProperty(from)
+{
+	fBoolValue = new BoolValue(*from.fBoolValue);
+}
+
+
 BoolProperty::~BoolProperty(void)
 {
 	delete fBoolValue;
@@ -630,6 +670,13 @@ IntProperty::IntProperty(BMessage *msg)
 }
 
 	
+IntProperty::IntProperty(const IntProperty &from)
+	:	PProperty(from)
+{
+	fIntValue = new IntValue(*from.fIntValue);
+}
+
+
 IntProperty::~IntProperty(void)
 {
 	delete fIntValue;
@@ -744,6 +791,13 @@ FloatProperty::FloatProperty(BMessage *msg)
 }
 
 	
+FloatProperty::FloatProperty(const FloatProperty &from)
+	:	PProperty(from)
+{
+	fFloatValue = new FloatValue(*from.fFloatValue);
+}
+
+
 FloatProperty::~FloatProperty(void)
 {
 	delete fFloatValue;
@@ -872,6 +926,13 @@ ColorProperty::ColorProperty(BMessage *msg)
 }
 
 	
+ColorProperty::ColorProperty(const ColorProperty &from)
+	:	PProperty(from)
+{
+	fColorValue = new ColorValue(*from.fColorValue);
+}
+
+
 ColorProperty::~ColorProperty(void)
 {
 	delete fColorValue;
@@ -988,6 +1049,13 @@ RectProperty::RectProperty(BMessage *msg)
 }
 
 	
+RectProperty::RectProperty(const RectProperty &from)
+	:	PProperty(from)
+{
+	fRectValue = new RectValue(*from.fRectValue);
+}
+
+
 RectProperty::~RectProperty(void)
 {
 	delete fRectValue;
@@ -1103,6 +1171,13 @@ PointProperty::PointProperty(BMessage *msg)
 }
 
 	
+PointProperty::PointProperty(const PointProperty &from)
+	:	PProperty(from)
+{
+	fPointValue = new PointValue(*from.fPointValue);
+}
+
+
 PointProperty::~PointProperty(void)
 {
 	delete fPointValue;
@@ -0,0 +1,269 @@
+#include "PPropertySchema.h"
+
+#include <Autolock.h>
+#include <Locker.h>
+#include <stdio.h>
+
+#include <map>
+
+#include "PData.h"
+
+class SchemaTable
+{
+public:
+	BLocker								lock;
+	std::map<uint64, PPropertySchema*>	schemas;
+};
+
+
+static SchemaTable &
+GetSchemaTable(void)
+{
+	static SchemaTable *sTable = new SchemaTable;
+	return *sTable;
+}
+
+
+static uint64
+HashBytes(uint64 hash, const void *data, size_t size)
+{
+	// FNV-1a
+	const uint8 *bytes = (const uint8 *)data;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+
+static uint64
+HashString(uint64 hash, const BString &string)
+{
+	// include the terminating null, so "ab" + "c" differs from "a" + "bc"
+	return HashBytes(hash, string.String(), string.Length() + 1);
+}
+
+
+PPropertySchema::PPropertySchema(const BString &type, const PData *data)
+	:	fID(SchemaID(type, data)),
+		fType(type)
+{
+	std::map<BString, int32> fieldCounts;
+	for (int32 i = 0; i < data->CountProperties(); i++)
+	{
+		PProperty *p = data->SharedPropertyAt(i);
+		property_entry entry;
+		p->Archive(&entry.archive);
+		entry.type = p->GetType();
+		entry.flags = data->PropertyFlagsAt(i);
+		entry.code = B_ANY_TYPE;
+		entry.archive.GetInfo("value", &entry.code);
+		entry.archive.RemoveName("value");
+		entry.field = FieldName(entry.code);
+		entry.fieldIndex = fieldCounts[entry.field]++;
+		fProperties.push_back(entry);
+	}
+}
+
+
+PPropertySchema::PPropertySchema(BMessage *msg)
+	:	fID(0)
+{
+	int64 id;
+	if (msg->FindInt64("schemaid", &id) == B_OK)
+		fID = id;
+	msg->FindString("type", &fType);
+
+	std::map<BString, int32> fieldCounts;
+	int32 i = 0;
+	property_entry entry;
+	while (msg->FindMessage("property", i, &entry.archive) == B_OK)
+	{
+		int32 flags = 0;
+		int32 code = B_ANY_TYPE;
+		msg->FindInt32("propertyflags", i, &flags);
+		msg->FindInt32("fieldtype", i, &code);
+		entry.archive.FindString("type", &entry.type);
+		entry.flags = flags;
+		entry.code = code;
+		entry.field = FieldName(entry.code);
+		entry.fieldIndex = fieldCounts[entry.field]++;
+		fProperties.push_back(entry);
+		i++;
+	}
+}
+
+
+status_t
+PPropertySchema::Archive(BMessage *data) const
+{
+	status_t status = data->AddString("type", fType);
+	if (status == B_OK)
+		status = data->AddInt64("schemaid", fID);
+
+	for (uint32 i = 0; i < fProperties.size() && status == B_OK; i++)
+	{
+		const property_entry &entry = fProperties[i];
+		status = data->AddMessage("property", &entry.archive);
+		if (status == B_OK)
+			status = data->AddInt32("propertyflags", entry.flags);
+		if (status == B_OK)
+			status = data->AddInt32("fieldtype", entry.code);
+	}
+	return status;
+}
+
+
+uint64
+PPropertySchema::GetID(void) const
+{
+	return fID;
+}
+
+
+BString
+PPropertySchema::GetType(void) const
+{
+	return fType;
+}
+
+
+int32
+PPropertySchema::CountProperties(void) const
+{
+	return fProperties.size();
+}
+
+
+status_t
+PPropertySchema::InstantiateValues(BMessage *row, PData *data) const
+{
+	for (uint32 i = 0; i < fProperties.size(); i++)
+	{
+		const property_entry &entry = fProperties[i];
+
+		// the constructors of the properties read the legacy form
+		BMessage msg(entry.archive);
+		const void *buffer;
+		ssize_t size;
+		if (row->FindData(entry.field.String(), entry.code, entry.fieldIndex,
+				&buffer, &size) == B_OK)
+			msg.AddData("value", entry.code, buffer, size, false);
+
+		PProperty *p = gPropertyRoster.MakeProperty(entry.type.String(), &msg);
+		if (p)
+			data->AddProperty(p, entry.flags);
+	}
+	return B_OK;
+}
+
+
+status_t
+PPropertySchema::ArchiveRow(const BString &type, const PData *data,
+							BMessage *row, BMessage *schemas)
+{
+	uint64 id = SchemaID(type, data);
+
+	bool known = false;
+	int64 schemaID;
+	for (int32 i = 0; schemas->FindInt64("schemaid", i, &schemaID) == B_OK; i++)
+	{
+		if ((uint64)schemaID == id)
+		{
+			known = true;
+			break;
+		}
+	}
+
+	status_t status = B_OK;
+	if (!known)
+	{
+		PPropertySchema schema(type, data);
+		BMessage msg;
+		status = schema.Archive(&msg);
+		if (status == B_OK)
+			status = schemas->AddMessage("schema", &msg);
+		if (status == B_OK)
+			status = schemas->AddInt64("schemaid", id);
+		if (status != B_OK)
+			return status;
+	}
+
+	status = row->AddInt64("schema", id);
+	for (int32 i = 0; i < data->CountProperties() && status == B_OK; i++)
+	{
+		BMessage msg;
+		data->SharedPropertyAt(i)->Archive(&msg);
+
+		type_code code = B_ANY_TYPE;
+		const void *buffer;
+		ssize_t size;
+		if (msg.GetInfo("value", &code) != B_OK
+			|| msg.FindData("value", code, &buffer, &size) != B_OK)
+			continue;
+		status = row->AddData(FieldName(code).String(), code, buffer, size,
+							false);
+	}
+	return status;
+}
+
+
+status_t
+PPropertySchema::RegisterSchemas(BMessage *schemas)
+{
+	SchemaTable &table = GetSchemaTable();
+	BMessage msg;
+	for (int32 i = 0; schemas->FindMessage("schema", i, &msg) == B_OK; i++)
+	{
+		PPropertySchema *schema = new PPropertySchema(&msg);
+
+		BAutolock locker(table.lock);
+		if (table.schemas.find(schema->GetID()) != table.schemas.end())
+			delete schema;
+		else
+			table.schemas[schema->GetID()] = schema;
+	}
+	return B_OK;
+}
+
+
+PPropertySchema *
+PPropertySchema::FindSchema(const uint64 &id)
+{
+	SchemaTable &table = GetSchemaTable();
+	BAutolock locker(table.lock);
+	std::map<uint64, PPropertySchema*>::iterator it = table.schemas.find(id);
+	return it != table.schemas.end() ? it->second : NULL;
+}
+
+
+uint64
+PPropertySchema::SchemaID(const BString &type, const PData *data)
+{
+	uint64 hash = HashString(14695981039346656037ULL, type);
+	for (int32 i = 0; i < data->CountProperties(); i++)
+	{
+		PProperty *p = data->SharedPropertyAt(i);
+		hash = HashString(hash, p->GetType());
+		hash = HashString(hash, p->GetName());
+		hash = HashString(hash, p->GetDescription());
+
+		bool readOnly = p->IsReadOnly();
+		uint32 flags = data->PropertyFlagsAt(i);
+		hash = HashBytes(hash, &readOnly, sizeof(readOnly));
+		hash = HashBytes(hash, &flags, sizeof(flags));
+	}
+	return hash;
+}
+
+
+BString
+PPropertySchema::FieldName(const type_code &code)
+{
+	// one field per value type, rows don't repeat the property names
+	char name[16];
+	sprintf(name, "_%08lx", (unsigned long)code);
+	return BString(name);
+}
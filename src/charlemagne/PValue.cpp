@@ -3,42 +3,93 @@
 #include <ClassInfo.h>
 #include "PObjectBroker.h"
 
+enum
+{
+	TAG_NONE = 0,
+	TAG_BOOL,
+	TAG_STRING,
+	TAG_INT,
+	TAG_CHAR,
+	TAG_FLOAT,
+	TAG_COLOR,
+	TAG_RECT,
+	TAG_POINT,
+	TAG_MESSAGE,
+	TAG_LIST,
+	TAG_COUNT
+};
+
+static const char *kTypeNames[TAG_COUNT] =
+{
+	"",
+	"bool",
+	"string",
+	"int",
+	"char",
+	"float",
+	"color",
+	"rect",
+	"point",
+	"message",
+	"list"
+};
+
+
+static const BString *
+TypeTag(const int32 &tag)
+{
+	// The type names are shared by all values of a type, so making a value
+	// doesn't allocate its type. Never freed, values are made by static
+	// constructors too.
+	static BString *sTags = NULL;
+	if (!sTags)
+	{
+		BString *tags = new BString[TAG_COUNT];
+		for (int32 i = 0; i < TAG_COUNT; i++)
+			tags[i] = kTypeNames[i];
+		sTags = tags;
+	}
+	return &sTags[tag];
+}
+
+
 PValue::PValue(void)
 {
-	type = new BString();
+	type = TypeTag(TAG_NONE);
 }
 
 
 PValue::~PValue(void)
 {
-	delete type;
 }
 
 
 BoolValue::BoolValue(void)
+	:	fStorage(false)
 {
-	value = new bool(false);
-	*type = "bool";
+	value = &fStorage;
+	type = TypeTag(TAG_BOOL);
 }
 
 
 BoolValue::BoolValue(const BoolValue &from)
+	:	fStorage(*from.value)
 {
-	value =  new bool(*from.value);
-	*type = "bool";
+	value = &fStorage;
+	type = TypeTag(TAG_BOOL);
 }
 
 
 BoolValue::BoolValue(bool from)
+	:	fStorage(from)
 {
-	value = new bool(from);
-	*type = "bool";
+	value = &fStorage;
+	type = TypeTag(TAG_BOOL);
 }
 
 
 BoolValue::~BoolValue(void)
 {
-	delete value;
 }
 
 
@@ -139,30 +190,39 @@ BoolValue::Duplicate(void) const
 }
 
 
+StringValue::StringValue(void)
+{
+	value = &fStorage;
+	type = TypeTag(TAG_STRING);
+}
+
+
 StringValue::StringValue(const StringValue &from)
+	:	fStorage(*from.value)
 {
-	value = new BString(*from.value);
-	*type = "string";
+	value = &fStorage;
+	type = TypeTag(TAG_STRING);
 }
 
 
 StringValue::StringValue(BString from)
+	:	fStorage(from)
 {
-	value = new BString(from);
-	*type = "string";
+	value = &fStorage;
+	type = TypeTag(TAG_STRING);
 }
 
 
 StringValue::StringValue(const char *from)
+	:	fStorage(from)
 {
-	value = new BString(from);
-	*type = "string";
+	value = &fStorage;
+	type = TypeTag(TAG_STRING);
 }
 
 
 StringValue::~StringValue(void)
 {
-	delete value;
 }
 
 
@@ -289,29 +349,31 @@ StringValue::Duplicate(void) const
 
 
 IntValue::IntValue(void)
+	:	fStorage(0LL)
 {
-	value = new int64(0LL);
-	*type = "int";
+	value = &fStorage;
+	type = TypeTag(TAG_INT);
 }
 
 
 IntValue::IntValue(const IntValue &from)
+	:	fStorage(*from.value)
 {
-	value = new int64(*from.value);
-	*type = "int";
+	value = &fStorage;
+	type = TypeTag(TAG_INT);
 }
 
 
 IntValue::IntValue(int64 from)
+	:	fStorage(from)
 {
-	value = new int64(from);
-	*type = "int";
+	value = &fStorage;
+	type = TypeTag(TAG_INT);
 }
 
 
 IntValue::~IntValue(void)
 {
-	delete value;
 }
 
 
@@ -414,29 +476,31 @@ IntValue::Duplicate(void) const
 
 
 CharValue::CharValue(void)
+	:	fStorage(0LL)
 {
-	value = new char(0LL);
-	*type = "char";
+	value = &fStorage;
+	type = TypeTag(TAG_CHAR);
 }
 
 
 CharValue::CharValue(const CharValue &from)
+	:	fStorage(*from.value)
 {
-	value = new char(*from.value);
-	*type = "char";
+	value = &fStorage;
+	type = TypeTag(TAG_CHAR);
 }
 
 
 CharValue::CharValue(char from)
+	:	fStorage(from)
 {
-	value = new char(from);
-	*type = "char";
+	value = &fStorage;
+	type = TypeTag(TAG_CHAR);
 }
 
 
 CharValue::~CharValue(void)
 {
-	delete value;
 }
 
 
@@ -549,29 +613,31 @@ CharValue::Duplicate(void) const
 
 
 FloatValue::FloatValue(void)
+	:	fStorage()
 {
-	value = new float();
-	*type = "float";
+	value = &fStorage;
+	type = TypeTag(TAG_FLOAT);
 }
 
 
 FloatValue::FloatValue(const FloatValue &from)
+	:	fStorage(*from.value)
 {
-	value =  new float(*from.value);
-	*type = "float";
+	value = &fStorage;
+	type = TypeTag(TAG_FLOAT);
 }
 
 
 FloatValue::FloatValue(float from)
+	:	fStorage(from)
 {
-	value = new float(from);
-	*type = "float";
+	value = &fStorage;
+	type = TypeTag(TAG_FLOAT);
 }
 
 
 FloatValue::~FloatValue(void)
 {
-	delete value;
 }
 
 
@@ -674,10 +740,11 @@ FloatValue::Duplicate(void) const
 
 
 ColorValue::ColorValue(void)
+	:	fStorage()
 {
-	value = new rgb_color;
+	value = &fStorage;
 	
-	*type = "color";
+	type = TypeTag(TAG_COLOR);
 	value->red = 0;
 	value->green = 0;
 	value->blue = 0;
@@ -686,30 +753,32 @@ ColorValue::ColorValue(void)
 
 
 ColorValue::ColorValue(const ColorValue &from)
+	:	fStorage()
 {
-	value = new rgb_color;
+	value = &fStorage;
 	*this = from;
 }
 
 
 ColorValue::ColorValue(rgb_color from)
+	:	fStorage()
 {
-	value = new rgb_color;
+	value = &fStorage;
 	*this = from;
 }
 
 
 ColorValue::ColorValue(uint8 red, uint8 green, uint8 blue, uint8 alpha)
+	:	fStorage()
 {
-	value = new rgb_color;
-	*type = "color";
+	value = &fStorage;
+	type = TypeTag(TAG_COLOR);
 	SetValue(red,green,blue,alpha);
 }
 
 
 ColorValue::~ColorValue(void)
 {
-	delete value;
 }
 
 
@@ -805,7 +874,7 @@ ColorValue::operator=(const ColorValue &from)
 ColorValue &
 ColorValue::operator=(const rgb_color &from)
 {
-	*type = "color";
+	type = TypeTag(TAG_COLOR);
 	value->red = from.red;
 	value->green = from.green;
 	value->blue = from.blue;
@@ -959,29 +1028,31 @@ ColorValue::operator!=(const rgb_color &from)
 
 
 RectValue::RectValue(void)
+	:	fStorage(0,0,0,0)
 {
-	value = new BRect(0,0,0,0);
-	*type = "rect";
+	value = &fStorage;
+	type = TypeTag(TAG_RECT);
 }
 
 
 RectValue::RectValue(const RectValue &from)
+	:	fStorage(*from.value)
 {
-	value =  new BRect(*from.value);
-	*type = "rect";
+	value = &fStorage;
+	type = TypeTag(TAG_RECT);
 }
 
 
 RectValue::RectValue(BRect from)
+	:	fStorage(from)
 {
-	value = new BRect(from);
-	*type = "rect";
+	value = &fStorage;
+	type = TypeTag(TAG_RECT);
 }
 
 
 RectValue::~RectValue(void)
 {
-	delete value;
 }
 
 
@@ -1054,28 +1125,30 @@ RectValue::Duplicate(void) const
 
 
 PointValue::PointValue(void)
+	:	fStorage(0,0)
 {
-	value = new BPoint(0,0);
-	*type = "point";
+	value = &fStorage;
+	type = TypeTag(TAG_POINT);
 }
 
 PointValue::PointValue(const PointValue &from)
+	:	fStorage(*from.value)
 {
-	value =  new BPoint(*from.value);
-	*type = "point";
+	value = &fStorage;
+	type = TypeTag(TAG_POINT);
 }
 
 
 PointValue::PointValue(BPoint from)
+	:	fStorage(from)
 {
-	value = new BPoint(from);
-	*type = "point";
+	value = &fStorage;
+	type = TypeTag(TAG_POINT);
 }
 
 
 PointValue::~PointValue(void)
 {
-	delete value;
 }
 
 
@@ -1147,36 +1220,39 @@ PointValue::Duplicate(void) const
 
 
 MessageValue::MessageValue(void)
+	:	fStorage()
 {
-	value = new BMessage;
-	*type = "message";
+	value = &fStorage;
+	type = TypeTag(TAG_MESSAGE);
 }
 
 
 MessageValue::MessageValue(const MessageValue &from)
+	:	fStorage(*from.value)
 {
-	value = new BMessage(*from.value);
-	*type = "message";
+	value = &fStorage;
+	type = TypeTag(TAG_MESSAGE);
 }
 
 
 MessageValue::MessageValue(const int32 &what)
+	:	fStorage(what)
 {
-	value = new BMessage(what);
-	*type = "message";
+	value = &fStorage;
+	type = TypeTag(TAG_MESSAGE);
 }
 
 
 MessageValue::MessageValue(BMessage from)
+	:	fStorage(from)
 {
-	value = new BMessage(from);
-	*type = "message";
+	value = &fStorage;
+	type = TypeTag(TAG_MESSAGE);
 }
 
 
 MessageValue::~MessageValue(void)
 {
-	delete value;
 }
 
 
@@ -1247,7 +1323,7 @@ ListValue::ListValue(void)
 #else
 	value = new BObjectList<PValue>(20, true);
 #endif
-	*type = "list";
+	type = TypeTag(TAG_LIST);
 }
 
 ListValue::ListValue(const ListValue &from)
@@ -1257,7 +1333,7 @@ ListValue::ListValue(const ListValue &from)
 #else
 	value = new BObjectList<PValue>(20, true);
 #endif
-	*type = "list";
+	type = TypeTag(TAG_LIST);
 	*this = from;
 }
 
@@ -1266,13 +1342,13 @@ ListValue::ListValue(const ListValue &from)
 ListValue::ListValue(BObjectList<PValue, true> from)
 {
 	value = new BObjectList<PValue, true>(20);
-	*type = "list";
+	type = TypeTag(TAG_LIST);
 }
 #else
 ListValue::ListValue(BObjectList<PValue> from)
 {
 	value = new BObjectList<PValue>(20, true);
-	*type = "list";
+	type = TypeTag(TAG_LIST);
 }
 #endif
 
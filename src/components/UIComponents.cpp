@@ -3,10 +3,90 @@
 #include "IconData.h"
 
 
+// The content the add-ons make the components with. A recycled component gets
+// it back in ResetContent().
+static const char* kButtonLabel = "Button";
+static const char* kTextViewText = "Haiku is a new open-source operating "
+	"system that specifically targets personal computing. Inspired by the "
+	"BeOS, Haiku is fast, simple to use, easy to learn and yet very powerful.";
+static const char* kRadioButtonLabel = "Radio Button";
+static const char* kCheckBoxLabel = "Check Box";
+static const char* kProgressBarLabel = "0";
+static const char* kProgressBarTrailingLabel = "100";
+static const char* kStringViewText = "String View";
+static const int32 kListViewItems = 9;
+
+
+static void
+AddListViewItems(BListView* view)
+{
+	for (int32 i = 1; i <= kListViewItems; i++) {
+		BString label("Item ");
+		label << i;
+		view->AddItem(new BStringItem(label));
+	}
+}
+
+
+//! Brings a control back to the state of a new one.
+static void
+ResetControl(BControl* control, const char* label)
+{
+	control->SetLabel(label);
+	control->SetMessage(NULL);
+	control->SetTarget(NULL);
+	control->SetValue(B_CONTROL_OFF);
+	control->SetEnabled(true);
+}
+
+
 Customizable*
 Button::InstantiateCustomizable(const BMessage* archive)
 {
-	return new Button("Button", NULL);
+	return new Button(kButtonLabel, NULL);
+}
+
+
+status_t
+Button::ResetContent()
+{
+	ResetControl(this, kButtonLabel);
+	return B_OK;
+}
+
+
+status_t
+ScrollView::Reset()
+{
+	status_t status = CustomizableView::Reset();
+	if (status != B_OK)
+		return status;
+
+	// named after its target like in the constructor
+	Customizable* target = dynamic_cast<Customizable*>(Target());
+	BString name = target->ObjectName();
+	Customizable::SetObjectName(name);
+	return B_OK;
+}
+
+
+status_t
+ScrollView::ResetContent()
+{
+	CustomizableView* target = dynamic_cast<CustomizableView*>(Target());
+	if (target == NULL)
+		return B_NOT_SUPPORTED;
+	if (!target->Orphan())
+		return B_BUSY;
+
+	// the target stays in the scroll view
+	status_t status = target->ResetContent();
+	if (status != B_OK)
+		return status;
+	target->SetObjectName(NULL);
+	target->DisconnectAllEvents();
+	Target()->ScrollTo(B_ORIGIN);
+	return B_OK;
 }
 
 
@@ -17,46 +97,101 @@ TextControl::InstantiateCustomizable(const BMessage* archive)
 }
 
 
+status_t
+TextControl::ResetContent()
+{
+	ResetControl(this, NULL);
+	// like the constructor
+	SetText("Text Control");
+	SetModificationMessage(NULL);
+	return B_OK;
+}
+
+
 Customizable*
 TextView::InstantiateCustomizable(const BMessage* archive)
 {
 	TextView* view = new TextView();
-	view->SetText("Haiku is a new open-source operating system that specifically targets personal computing. Inspired by the BeOS, Haiku is fast, simple to use, easy to learn and yet very powerful.");
+	view->SetText(kTextViewText);
 	ScrollView* scrollView = new ScrollView(view, true, true);
 	scrollView->SetExplicitPreferredSize(BSize(220, 280));
 	return scrollView;
 }
 
 
+status_t
+TextView::ResetContent()
+{
+	SetText(kTextViewText);
+	Select(0, 0);
+	return B_OK;
+}
+
+
 Customizable*
 RadioButton::InstantiateCustomizable(const BMessage* archive)
 {
-	RadioButton* view = new RadioButton("Radio Button");
+	RadioButton* view = new RadioButton(kRadioButtonLabel);
 	return view;
 }
 
 
+status_t
+RadioButton::ResetContent()
+{
+	ResetControl(this, kRadioButtonLabel);
+	return B_OK;
+}
+
+
 Customizable*
 CheckBox::InstantiateCustomizable(const BMessage* archive)
 {
-	CheckBox* view = new CheckBox("Check Box");
+	CheckBox* view = new CheckBox(kCheckBoxLabel);
 	return view;
 }
 
 
+status_t
+CheckBox::ResetContent()
+{
+	ResetControl(this, kCheckBoxLabel);
+	return B_OK;
+}
+
+
 Customizable*
 ProgressBar::InstantiateCustomizable(const BMessage* archive)
 {
-	ProgressBar* progressBar = new ProgressBar("0", "100");
+	ProgressBar* progressBar = new ProgressBar(kProgressBarLabel,
+		kProgressBarTrailingLabel);
 	progressBar->SetExplicitPreferredSize(BSize(350, B_SIZE_UNSET));
 	return progressBar;
 }
 
 
+status_t
+ProgressBar::ResetContent()
+{
+	BStatusBar::Reset(kProgressBarLabel, kProgressBarTrailingLabel);
+	// like the constructor
+	Update(60);
+	return B_OK;
+}
+
+
 Customizable*
 StringView::InstantiateCustomizable(const BMessage* archive)
 {
-	return new StringView("String View");
+	return new StringView(kStringViewText);
+}
+
+
+status_t
+StringView::ResetContent()
+{
+	SetText(kStringViewText);
+	return B_OK;
 }
 
 
@@ -77,15 +212,7 @@ Customizable*
 ListView::InstantiateCustomizable(const BMessage* archive)
 {
 	ListView* view = new ListView();
-	view->AddItem(new BStringItem("Item 1"));
-	view->AddItem(new BStringItem("Item 2"));
-	view->AddItem(new BStringItem("Item 3"));
-	view->AddItem(new BStringItem("Item 4"));
-	view->AddItem(new BStringItem("Item 5"));
-	view->AddItem(new BStringItem("Item 6"));
-	view->AddItem(new BStringItem("Item 7"));
-	view->AddItem(new BStringItem("Item 8"));
-	view->AddItem(new BStringItem("Item 9"));
+	AddListViewItems(view);
 	
 	ScrollView* scrollView = new ScrollView(view, true, true);
 	scrollView->SetExplicitPreferredSize(BSize(220, 280));
@@ -93,6 +220,19 @@ ListView::InstantiateCustomizable(const BMessage* archive)
 }
 
 
+status_t
+ListView::ResetContent()
+{
+	for (int32 i = CountItems() - 1; i >= 0; i--)
+		delete RemoveItem(i);
+	AddListViewItems(this);
+	SetSelectionMessage(NULL);
+	SetInvocationMessage(NULL);
+	SetTarget(NULL);
+	return B_OK;
+}
+
+
 Customizable*
 Spacer::InstantiateCustomizable(const BMessage* archive)
 {
@@ -117,6 +117,7 @@ Customizable::Socket::_Disconnect(Customizable* interface)
 Customizable::Customizable(CustomizableRoster* roster, const char* name)
 	:
 	fRoster(roster),
+	fHandle(0),
 	fObjectName(name)
 {
 	if (fRoster == NULL)
@@ -157,6 +158,13 @@ Customizable::RestoreState(const BMessage* archive)
 }
 
 
+status_t
+Customizable::Reset()
+{
+	return B_NOT_SUPPORTED;
+}
+
+
 void
 Customizable::SetObjectName(const char* name)
 {
@@ -328,7 +336,7 @@ Customizable::ConnectEvent(const char* event, BObject* target,
 	if (status != B_OK)
 		return status;
 	if (fRoster)
-		fRoster->_NotifyWatchers(B_OBJECT_EVENT_CONNECTED);
+		fRoster->_NotifyWatchers(B_OBJECT_EVENT_CONNECTED, fHandle);
 	return status;
 }
 
@@ -340,7 +348,7 @@ Customizable::DisconnectEvent(const char* event, BObject* target)
 	if (status != B_OK)
 		return status;
 	if (fRoster)
-		fRoster->_NotifyWatchers(B_OBJECT_EVENT_DISCONNECTED);
+		fRoster->_NotifyWatchers(B_OBJECT_EVENT_DISCONNECTED, fHandle);
 	return status;
 }
 
@@ -362,11 +370,29 @@ Customizable::AddSocket(const char* socket, const char* interface,
 }
 
 
+void
+Customizable::AddInterface(const char* name)
+{
+	BObject::AddInterface(name);
+	if (fRoster != NULL && name != NULL && UsesInterface(name))
+		fRoster->_InterfaceAdded(this, name);
+}
+
+
+void
+Customizable::RemoveInterface(const char* name)
+{
+	BObject::RemoveInterface(name);
+	if (fRoster != NULL && name != NULL)
+		fRoster->_InterfaceRemoved(this, name);
+}
+
+
 bool
 Customizable::Connected(Socket* socket)
 {
 	if (fRoster)
-		fRoster->_NotifyWatchers(B_SOCKET_CONNECTED);
+		fRoster->_NotifyWatchers(B_SOCKET_CONNECTED, fHandle);
 
 	return fConnectedToList.AddItem(socket);
 }
@@ -376,6 +402,6 @@ bool
 Customizable::Disconnected(Socket* socket)
 {
 	if (fRoster)
-		fRoster->_NotifyWatchers(B_SOCKET_DISCONNECTED);
+		fRoster->_NotifyWatchers(B_SOCKET_DISCONNECTED, fHandle);
 	return fConnectedToList.RemoveItem(socket);
 }
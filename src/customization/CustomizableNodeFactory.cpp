@@ -6,7 +6,7 @@
 
 #include <CustomizableNodeFactory.h>
 
-#include <Picture.h>
+#include <Bitmap.h>
 #include <StringItem.h>
 
 #include <Misc.h>
@@ -20,7 +20,8 @@ static const float kLeftInset = 4;
 class BIconItem : public BStringItem{
 public:
 								BIconItem(const char* text,
-									const BPicture& picture, BRect iconFrame);
+									CustomizableIconAtlas* atlas,
+									BRect iconFrame);
 
 	virtual void				Update(BView* owner, const BFont* font);
 
@@ -33,15 +34,17 @@ protected:
 									float textOffset);
 
 private:
-			BPicture			fPicture;
+			//! Shared by all items, fFrame is the icon in it.
+			BReference<CustomizableIconAtlas>	fAtlas;
 			BRect				fFrame;
 };
 
 
-BIconItem::BIconItem(const char* text, const BPicture& picture, BRect iconFrame)
+BIconItem::BIconItem(const char* text, CustomizableIconAtlas* atlas,
+	BRect iconFrame)
 	:
 	BStringItem(text),
-	fPicture(picture),
+	fAtlas(atlas),
 	fFrame(iconFrame)
 {
 }
@@ -66,9 +69,10 @@ BIconItem::DrawItem(BView* owner, BRect frame, bool complete)
 	DrawItemWithTextOffset(owner, frame, complete, iconSize + 4);
 
 	BRect iconFrame(frame.left + kLeftInset, frame.top,
-		frame.left + kLeftInset + iconSize - 1, frame.top + iconSize - 1);
+		frame.left + kLeftInset + fFrame.Width(),
+		frame.top + fFrame.Height());
 	owner->SetDrawingMode(B_OP_OVER);
-	owner->DrawPicture(&fPicture, iconFrame.LeftTop());
+	owner->DrawBitmap(fAtlas->Bitmap(), fFrame, iconFrame);
 	owner->SetDrawingMode(B_OP_COPY);
 }
 
@@ -112,12 +116,13 @@ void
 FactoryDragListView::AttachedToWindow()
 {
 	fRoster->GetInstalledCustomizableList(fInstalledComponents);
+	// the icons are only decoded once, all items draw from the atlas
+	BReference<CustomizableIconAtlas> atlas = fRoster->GetIconAtlas();
 	for (int32 i = 0; i < fInstalledComponents.CountItems(); i++) {
 		BALM::CustomizableAddOn* addOn = fInstalledComponents.ItemAt(i);
-		BPicture* picture;
-		BRect pictureFrame;
-		if (addOn->IconPicture(this, &picture, pictureFrame))
-			AddItem(new BIconItem(addOn->Name(), *picture, pictureFrame));
+		BRect iconFrame;
+		if (atlas.Get() != NULL && atlas->IconFrame(addOn, iconFrame))
+			AddItem(new BIconItem(addOn->Name(), atlas, iconFrame));
 		else
 			AddItem(new BStringItem(addOn->Name()));
 	}
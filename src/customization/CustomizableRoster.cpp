@@ -6,43 +6,182 @@
 
 #include "CustomizableRoster.h"
 
+#include <CustomizableView.h>
+
 #include <AutoLocker.h>
 #include <Messenger.h>
 
+#include <new>
+
 
 using BALM::Layer;
 
 
 const char* B_CLASS_FIELD = "class";
 
+static const int32 kDefaultPoolSize = 8;
+
 
 static CustomizableRoster* gCustomizableRoster = NULL;
 
 
+int32
+BALM::CustomizableSnapshot::CountItems() const
+{
+	return fCustomizables.CountItems();
+}
+
+
+BReference<Customizable>
+BALM::CustomizableSnapshot::ItemAt(int32 index)
+{
+	if (index < 0 || index >= fCustomizables.CountItems())
+		return NULL;
+	return fCustomizables.ItemAt(index).GetReference();
+}
+
+
 bool
-BALM::CustomizableAddOn::IconPicture(BView* view, BPicture** picture,
+BALM::CustomizableAddOn::IconPicture(BView* view, const BPicture** picture,
 	BRect& frame)
 {
 	return false;
 }
 
 
-Layer::Layer()
+bool
+BALM::CustomizableAddOn::IconData(const unsigned char** bits, BRect& frame)
 {
+	return false;
 }
 
 
 bool
-Layer::Register(Customizable* customizable)
+BALM::CustomizableAddOn::Insertable()
 {
-	bool result = fCustomizables.AddItem(customizable);
-	if (result == false)
+	BReference<Customizable> customizable = InstantiateCustomizable(NULL);
+	return dynamic_cast<IViewContainer*>(customizable.Get()) != NULL;
+}
+
+
+BALM::CustomizableIconAtlas::CustomizableIconAtlas()
+	:
+	fBitmap(NULL)
+{
+}
+
+
+BALM::CustomizableIconAtlas::~CustomizableIconAtlas()
+{
+	delete fBitmap;
+}
+
+
+const BBitmap*
+BALM::CustomizableIconAtlas::Bitmap() const
+{
+	return fBitmap;
+}
+
+
+bool
+BALM::CustomizableIconAtlas::IconFrame(CustomizableAddOn* addOn,
+	BRect& frame) const
+{
+	std::map<CustomizableAddOn*, BRect>::const_iterator it
+		= fFrames.find(addOn);
+	if (it == fFrames.end())
 		return false;
+	frame = it->second;
+	return true;
+}
+
+
+status_t
+BALM::CustomizableIconAtlas::_Decode(const CustomizableAddOnList& addOns)
+{
+	// the icons are placed side by side in a single row
+	std::vector<const unsigned char*> bits;
+	float width = 0;
+	float height = 0;
+	for (int32 i = 0; i < addOns.CountItems(); i++) {
+		CustomizableAddOn* addOn = addOns.ItemAt(i);
+		const unsigned char* data;
+		BRect frame;
+		if (!addOn->IconData(&data, frame) || !frame.IsValid())
+			continue;
+		BRect source(0, 0, frame.Width(), frame.Height());
+		source.OffsetTo(width, 0);
+		fFrames[addOn] = source;
+		bits.push_back(data);
+		width += source.Width() + 1;
+		if (source.Height() + 1 > height)
+			height = source.Height() + 1;
+	}
+	if (bits.empty())
+		return B_OK;
+
+	fBitmap = new(std::nothrow) BBitmap(BRect(0, 0, width - 1, height - 1),
+		B_RGBA32);
+	if (fBitmap == NULL)
+		return B_NO_MEMORY;
+	status_t status = fBitmap->InitCheck();
+	if (status != B_OK)
+		return status;
+	memset(fBitmap->Bits(), 0, fBitmap->BitsLength());
+
+	uint8* target = (uint8*)fBitmap->Bits();
+	int32 bytesPerRow = fBitmap->BytesPerRow();
+	int32 index = 0;
+	for (int32 i = 0; i < addOns.CountItems(); i++) {
+		std::map<CustomizableAddOn*, BRect>::const_iterator it
+			= fFrames.find(addOns.ItemAt(i));
+		if (it == fFrames.end())
+			continue;
+		const BRect& source = it->second;
+		int32 rowLength = ((int32)source.Width() + 1) * 4;
+		const unsigned char* row = bits[index++];
+		for (int32 y = 0; y <= (int32)source.Height(); y++) {
+			memcpy(target + y * bytesPerRow + (int32)source.left * 4, row,
+				rowLength);
+			row += rowLength;
+		}
+	}
+	return B_OK;
+}
 
-	if (fCustomizableRefs.AddItem(customizable) == false) {
-		fCustomizables.RemoveItem(customizable);
-		return false;	
+
+Layer::Layer()
+	:
+	fFreeSlot(-1)
+{
+}
+
+
+bool
+Layer::Register(Customizable* customizable)
+{
+	int32 index = fFreeSlot;
+	if (index >= 0)
+		fFreeSlot = fSlots[index].nextFree;
+	else {
+		Slot slot;
+		slot.customizable = NULL;
+		slot.generation = 1;
+		slot.nextFree = -1;
+		fSlots.push_back(slot);
+		index = fSlots.size() - 1;
 	}
+
+	Slot& slot = fSlots[index];
+	slot.customizable = customizable;
+	slot.reference = BWeakReference<Customizable>(customizable);
+	slot.nextFree = -1;
+	customizable->fHandle = (customizable_handle)slot.generation << 32 | index;
+	fSnapshot.Unset();
+
+	for (int32 i = 0; i < customizable->CountInterfaces(); i++)
+		AddInterface(customizable, customizable->InterfaceAt(i));
 	return true;
 }
 
@@ -50,19 +189,125 @@ Layer::Register(Customizable* customizable)
 bool
 Layer::Unregister(Customizable* customizable)
 {
-	int32 index = fCustomizables.IndexOf(customizable);
-	if (index < 0)
+	for (int32 i = 0; i < customizable->CountInterfaces(); i++)
+		RemoveInterface(customizable, customizable->InterfaceAt(i));
+
+	Slot* slot = _SlotFor(customizable->fHandle);
+	if (slot == NULL || slot->customizable != customizable)
 		return false;
-	fCustomizables.RemoveItemAt(index);
 
-	return fCustomizableRefs.RemoveItemAt(index);
+	slot->customizable = NULL;
+	slot->reference = BWeakReference<Customizable>();
+	// 0 is never a valid handle
+	if (++slot->generation == 0)
+		slot->generation = 1;
+	slot->nextFree = fFreeSlot;
+	fFreeSlot = slot - &fSlots[0];
+	customizable->fHandle = 0;
+	fSnapshot.Unset();
+	return true;
+}
+
+
+BReference<Customizable>
+Layer::FindCustomizable(customizable_handle handle)
+{
+	Slot* slot = _SlotFor(handle);
+	if (slot == NULL)
+		return NULL;
+	return slot->reference.GetReference();
 }
 
 
 void
 Layer::GetCustomizableList(BArray<BWeakReference<Customizable> >& list)
 {
-	list = fCustomizableRefs;
+	BReference<CustomizableSnapshot> snapshot = Snapshot();
+	if (snapshot.Get() != NULL)
+		list = snapshot->fCustomizables;
+}
+
+
+BReference<CustomizableSnapshot>
+Layer::Snapshot()
+{
+	if (fSnapshot.Get() != NULL)
+		return fSnapshot;
+
+	CustomizableSnapshot* snapshot = new(std::nothrow) CustomizableSnapshot;
+	if (snapshot == NULL)
+		return NULL;
+	for (uint32 i = 0; i < fSlots.size(); i++) {
+		if (fSlots[i].customizable != NULL)
+			snapshot->fCustomizables.AddItem(fSlots[i].reference);
+	}
+	fSnapshot.SetTo(snapshot, true);
+	return fSnapshot;
+}
+
+
+void
+Layer::GetCompatibleList(const char* interface,
+	BArray<BReference<Customizable> >& list)
+{
+	std::map<BString, CustomizableRefMap>::iterator it
+		= fInterfaceIndex.find(_InterfaceKey(interface));
+	if (it == fInterfaceIndex.end())
+		return;
+
+	CustomizableRefMap& customizables = it->second;
+	for (CustomizableRefMap::iterator ref = customizables.begin();
+		ref != customizables.end(); ref++) {
+		// skip objects that are already being deleted
+		BReference<Customizable> customizable = ref->second.GetReference();
+		if (customizable != NULL)
+			list.AddItem(customizable);
+	}
+}
+
+
+void
+Layer::AddInterface(Customizable* customizable, const char* interface)
+{
+	fInterfaceIndex[_InterfaceKey(interface)].insert(
+		std::make_pair(customizable,
+			BWeakReference<Customizable>(customizable)));
+}
+
+
+void
+Layer::RemoveInterface(Customizable* customizable, const char* interface)
+{
+	std::map<BString, CustomizableRefMap>::iterator it
+		= fInterfaceIndex.find(_InterfaceKey(interface));
+	if (it == fInterfaceIndex.end())
+		return;
+	it->second.erase(customizable);
+	if (it->second.empty())
+		fInterfaceIndex.erase(it);
+}
+
+
+BString
+Layer::_InterfaceKey(const char* interface)
+{
+	// UsesInterface() ignores the case
+	BString key(interface);
+	return key.ToLower();
+}
+
+
+Layer::Slot*
+Layer::_SlotFor(customizable_handle handle)
+{
+	uint32 index = handle & 0xffffffff;
+	uint32 generation = handle >> 32;
+	if (index >= fSlots.size())
+		return NULL;
+	Slot& slot = fSlots[index];
+	if (slot.generation != generation || slot.customizable == NULL)
+		return NULL;
+	return &slot;
 }
 									
 
@@ -88,13 +333,29 @@ Layer::GetShelfList(BArray<BReference<Customizable> >& list)
 
 
 CustomizableRoster::CustomizableRoster()
+	:
+	fDefaultPoolSize(kDefaultPoolSize)
 {
+	fAddOnIndex.Init();
 	fLayerList.AddItem(new Layer);
 }
 
 
 CustomizableRoster::~CustomizableRoster()
 {
+	for (std::map<BString, customizable_pool>::iterator it = fPools.begin();
+		it != fPools.end(); it++) {
+		for (uint32 i = 0; i < it->second.free.size(); i++)
+			it->second.free[i]->ReleaseReference();
+	}
+	fPools.clear();
+
+	addon_entry* entry = fAddOnIndex.Clear(true);
+	while (entry != NULL) {
+		addon_entry* next = entry->next;
+		delete entry;
+		entry = next;
+	}
 	for (int32 i = 0; i < fInstalledCustomizables.CountItems(); i++)
 		delete fInstalledCustomizables.ItemAt(i);
 
@@ -116,25 +377,67 @@ BReference<Customizable>
 CustomizableRoster::InstantiateCustomizable(const char* name,
 	const BMessage* archive)
 {
-	BReference<Customizable> customizable;
-
-	AutoLocker<BLocker> _(fListLocker);
-	for (int32 i = 0; i < fInstalledCustomizables.CountItems(); i++) {
-		CustomizableAddOn* addOn = fInstalledCustomizables.ItemAt(i);
-		if (BString(addOn->Name()) == name) {
-			return addOn->InstantiateCustomizable(archive);
+	if (name == NULL)
+		return NULL;
+
+	CustomizableAddOn* addOn = NULL;
+	Customizable* recycled = NULL;
+	{
+		AutoLocker<BLocker> _(fListLocker);
+		addon_entry* entry = fAddOnIndex.Lookup(name);
+		if (entry == NULL)
+			return NULL;
+		addOn = entry->addOn;
+
+		// an archive may configure the new object differently
+		if (archive == NULL) {
+			customizable_pool& pool = fPools[name];
+			if (pool.free.empty())
+				pool.info.misses++;
+			else {
+				recycled = pool.free.back();
+				pool.free.pop_back();
+				pool.info.hits++;
+			}
 		}
 	}
 
-	return NULL;
+	if (recycled != NULL) {
+		Register(recycled);
+		return BReference<Customizable>(recycled, true);
+	}
+
+	// Add-ons are never removed, so components can be instantiated without
+	// holding the roster lock.
+	return addOn->InstantiateCustomizable(archive);
 }
 
 
 bool
 CustomizableRoster::InstallCustomizable(CustomizableAddOn* addOn)
 {
+	addon_entry* entry = new(std::nothrow) addon_entry;
+	if (entry == NULL)
+		return false;
+	entry->name = addOn->Name();
+	entry->hash = BString::HashValue(entry->name.String());
+	entry->addOn = addOn;
+
 	AutoLocker<BLocker> _(fListLocker);
-	fInstalledCustomizables.AddItem(addOn);
+	if (!fInstalledCustomizables.AddItem(addOn)) {
+		delete entry;
+		return false;
+	}
+	// like the list search did, the first add-on of a name wins
+	if (fAddOnIndex.Lookup(entry->name.String()) != NULL)
+		delete entry;
+	else if (fAddOnIndex.Insert(entry) != B_OK) {
+		fInstalledCustomizables.RemoveItem(addOn);
+		delete entry;
+		return false;
+	}
+	// decoded again on the next request, holders keep the old atlas
+	fIconAtlas.Unset();
 	return true;
 }
 
@@ -159,13 +462,34 @@ CustomizableRoster::GetCustomizableList(
 }
 
 
+BReference<BALM::CustomizableSnapshot>
+CustomizableRoster::GetCustomizableSnapshot()
+{
+	AutoLocker<BLocker> _(fListLocker);
+	Layer* layer = _Layer(NULL);
+	if (layer == NULL)
+		return NULL;
+	return layer->Snapshot();
+}
+
+
+BReference<Customizable>
+CustomizableRoster::FindCustomizable(customizable_handle handle)
+{
+	AutoLocker<BLocker> _(fListLocker);
+	Layer* layer = _Layer(NULL);
+	if (layer == NULL)
+		return NULL;
+	return layer->FindCustomizable(handle);
+}
+
+
 bool
 CustomizableRoster::StartWatching(BHandler* target)
 {
 	AutoLocker<BLocker> _(fListLocker);
-	if (fWatcherList.HasItem(target) == true)
-		return true;
-	return fWatcherList.AddItem(target);
+	fWatchers[target];
+	return true;
 }
 
 
@@ -173,7 +497,40 @@ bool
 CustomizableRoster::StopWatching(BHandler* target)
 {
 	AutoLocker<BLocker> _(fListLocker);
-	return fWatcherList.RemoveItem(target);
+	return fWatchers.erase(target) > 0;
+}
+
+
+static void
+AddHandles(BMessage* message, const char* name,
+	const std::set<customizable_handle>& handles)
+{
+	for (std::set<customizable_handle>::const_iterator it = handles.begin();
+		it != handles.end(); it++)
+		message->AddInt64(name, *it);
+}
+
+
+status_t
+CustomizableRoster::GetChanges(BHandler* target, BMessage* changes)
+{
+	AutoLocker<BLocker> _(fListLocker);
+	std::map<BHandler*, watcher_changes>::iterator it = fWatchers.find(target);
+	if (it == fWatchers.end())
+		return B_BAD_VALUE;
+
+	watcher_changes& watcher = it->second;
+	changes->MakeEmpty();
+	changes->what = B_CUSTOMIZABLE_LIST_CHANGED;
+	AddHandles(changes, "added", watcher.added);
+	AddHandles(changes, "removed", watcher.removed);
+	AddHandles(changes, "changed", watcher.changed);
+
+	watcher.added.clear();
+	watcher.removed.clear();
+	watcher.changed.clear();
+	watcher.notified = false;
+	return B_OK;
 }
 
 
@@ -181,16 +538,18 @@ void
 CustomizableRoster::GetCompatibleConnections(Customizable::Socket* socket,
 	CustomizableList& list)
 {
-	BArray<BWeakReference<Customizable> > allCustomizable;
-	GetCustomizableList(allCustomizable);
-	for (int32 i = 0; i < allCustomizable.CountItems(); i++) {
-		BReference<Customizable> customizable
-			= allCustomizable.ItemAt(i).GetReference();
-		if (customizable == NULL)
-			continue;
-		if (customizable->UsesInterface(socket->Interface()) == true)
-			list.AddItem(customizable);
+	BArray<BReference<Customizable> > compatible;
+	{
+		AutoLocker<BLocker> _(fListLocker);
+		Layer* layer = _Layer(NULL);
+		if (layer != NULL)
+			layer->GetCompatibleList(socket->Interface(), compatible);
 	}
+
+	// The references are released without the lock, the last one unregisters
+	// its Customizable.
+	for (int32 i = 0; i < compatible.CountItems(); i++)
+		list.AddItem(compatible.ItemAt(i).Get());
 }
 
 
@@ -230,6 +589,157 @@ CustomizableRoster::GetShelfList(BArray<BReference<Customizable> >& list)
 }
 
 
+bool
+CustomizableRoster::RecycleCustomizable(Customizable* customizable)
+{
+	if (customizable == NULL || customizable->Roster() != this)
+		return false;
+
+	BString name = customizable->ObjectName();
+	{
+		AutoLocker<BLocker> _(fListLocker);
+		if (fAddOnIndex.Lookup(name.String()) == NULL)
+			return false;
+		customizable_pool& pool = fPools[name];
+		int32 size = pool.size >= 0 ? pool.size : fDefaultPoolSize;
+		if ((int32)pool.free.size() >= size) {
+			pool.info.rejected++;
+			return false;
+		}
+	}
+
+	// Reset() may have to lock the window of the view, so it is called
+	// without the roster lock. The caller's reference has to be the only
+	// one, nobody else may use the object afterwards.
+	bool reusable = customizable->CountReferences() == 1
+		&& customizable->Orphan() && customizable->Reset() == B_OK;
+
+	AutoLocker<BLocker> _(fListLocker);
+	customizable_pool& pool = fPools[name];
+	int32 size = pool.size >= 0 ? pool.size : fDefaultPoolSize;
+	if (!reusable || (int32)pool.free.size() >= size) {
+		pool.info.rejected++;
+		return false;
+	}
+
+	Unregister(customizable);
+	customizable->AcquireReference();
+	pool.free.push_back(customizable);
+	pool.info.recycled++;
+	return true;
+}
+
+
+void
+CustomizableRoster::SetPoolSize(const char* name, int32 size)
+{
+	std::vector<Customizable*> released;
+	{
+		AutoLocker<BLocker> _(fListLocker);
+		customizable_pool& pool = fPools[name];
+		pool.size = size < 0 ? -1 : size;
+		size = pool.size >= 0 ? pool.size : fDefaultPoolSize;
+		while ((int32)pool.free.size() > size) {
+			released.push_back(pool.free.back());
+			pool.free.pop_back();
+		}
+	}
+
+	for (uint32 i = 0; i < released.size(); i++)
+		released[i]->ReleaseReference();
+}
+
+
+void
+CustomizableRoster::SetDefaultPoolSize(int32 size)
+{
+	std::vector<Customizable*> released;
+	{
+		AutoLocker<BLocker> _(fListLocker);
+		fDefaultPoolSize = size < 0 ? 0 : size;
+		for (std::map<BString, customizable_pool>::iterator it
+			= fPools.begin(); it != fPools.end(); it++) {
+			customizable_pool& pool = it->second;
+			while (pool.size < 0
+				&& (int32)pool.free.size() > fDefaultPoolSize) {
+				released.push_back(pool.free.back());
+				pool.free.pop_back();
+			}
+		}
+	}
+
+	for (uint32 i = 0; i < released.size(); i++)
+		released[i]->ReleaseReference();
+}
+
+
+status_t
+CustomizableRoster::GetPoolInfo(const char* name,
+	customizable_pool_info* info)
+{
+	if (name == NULL)
+		return B_BAD_VALUE;
+
+	AutoLocker<BLocker> _(fListLocker);
+	if (fAddOnIndex.Lookup(name) == NULL)
+		return B_NAME_NOT_FOUND;
+
+	customizable_pool& pool = fPools[name];
+	*info = pool.info;
+	info->size = pool.size >= 0 ? pool.size : fDefaultPoolSize;
+	info->count = pool.free.size();
+	return B_OK;
+}
+
+
+bool
+CustomizableRoster::IsInsertable(const char* name)
+{
+	if (name == NULL)
+		return false;
+
+	CustomizableAddOn* addOn = NULL;
+	{
+		AutoLocker<BLocker> _(fListLocker);
+		addon_entry* entry = fAddOnIndex.Lookup(name);
+		if (entry == NULL)
+			return false;
+		addOn = entry->addOn;
+	}
+	// add-ons are never removed
+	return addOn->Insertable();
+}
+
+
+BReference<CustomizableIconAtlas>
+CustomizableRoster::GetIconAtlas()
+{
+	CustomizableAddOnList addOns;
+	{
+		AutoLocker<BLocker> _(fListLocker);
+		if (fIconAtlas.Get() != NULL)
+			return fIconAtlas;
+		addOns.AddList(&fInstalledCustomizables);
+	}
+
+	// decoding doesn't need the lock, add-ons are never removed
+	CustomizableIconAtlas* atlas = new(std::nothrow) CustomizableIconAtlas;
+	if (atlas == NULL)
+		return NULL;
+	BReference<CustomizableIconAtlas> reference(atlas, true);
+	if (atlas->_Decode(addOns) != B_OK)
+		return NULL;
+
+	AutoLocker<BLocker> _(fListLocker);
+	if (fIconAtlas.Get() != NULL)
+		return fIconAtlas;
+	// only cache it if no add-on has been installed in the meantime
+	if (addOns.CountItems() == fInstalledCustomizables.CountItems())
+		fIconAtlas = reference;
+	return reference;
+}
+
+
 bool
 CustomizableRoster::Register(Customizable* customizable)
 {
@@ -238,11 +748,8 @@ CustomizableRoster::Register(Customizable* customizable)
 	bool status = false;
 	if (layer != NULL) {
 		status = layer->Register(customizable);
-		if (status) {
-			BMessage message(B_CUSTOMIZABLE_ADDED);
-			message.AddPointer("customizable", customizable);
-			_NotifyWatchers(&message);
-		}
+		if (status)
+			_NotifyWatchers(B_CUSTOMIZABLE_ADDED, customizable->Handle());
 	}
 	return status;
 }
@@ -255,9 +762,10 @@ CustomizableRoster::Unregister(Customizable* customizable)
 	Layer* layer = _Layer(customizable);
 	bool status = false;
 	if (layer != NULL) {
+		customizable_handle handle = customizable->Handle();
 		status = layer->Unregister(customizable);
 		if (status)
-			_NotifyWatchers(B_CUSTOMIZABLE_REMOVED);
+			_NotifyWatchers(B_CUSTOMIZABLE_REMOVED, handle);
 	}
 	return status;
 }
@@ -271,20 +779,72 @@ CustomizableRoster::_Layer(Customizable* customizable)
 
 
 void
-CustomizableRoster::_NotifyWatchers(BMessage* message)
+CustomizableRoster::_InterfaceAdded(Customizable* customizable,
+	const char* interface)
 {
-	for (int32 i = 0; i < fWatcherList.CountItems(); i++) {
-		BMessenger messenger(fWatcherList.ItemAt(i));
-		messenger.SendMessage(message);
-	}
+	AutoLocker<BLocker> _(fListLocker);
+	Layer* layer = _Layer(customizable);
+	if (layer != NULL)
+		layer->AddInterface(customizable, interface);
+}
+
+
+void
+CustomizableRoster::_InterfaceRemoved(Customizable* customizable,
+	const char* interface)
+{
+	AutoLocker<BLocker> _(fListLocker);
+	Layer* layer = _Layer(customizable);
+	if (layer != NULL)
+		layer->RemoveInterface(customizable, interface);
 }
 
 
+/*! Collects the change for every watcher. Watchers that have fetched all
+earlier changes are sent a B_CUSTOMIZABLE_LIST_CHANGED message, the others
+still have one in their queue. Other what values than B_CUSTOMIZABLE_ADDED
+and B_CUSTOMIZABLE_REMOVED mark the Customizable as changed. */
 void
-CustomizableRoster::_NotifyWatchers(int32 what)
+CustomizableRoster::_NotifyWatchers(int32 what, customizable_handle handle)
 {
-	for (int32 i = 0; i < fWatcherList.CountItems(); i++) {
-		BMessenger messenger(fWatcherList.ItemAt(i));
-		messenger.SendMessage(what);
+	AutoLocker<BLocker> _(fListLocker);
+	for (std::map<BHandler*, watcher_changes>::iterator it = fWatchers.begin();
+		it != fWatchers.end(); it++) {
+		watcher_changes& watcher = it->second;
+		if (what == B_CUSTOMIZABLE_ADDED)
+			watcher.added.insert(handle);
+		else if (what == B_CUSTOMIZABLE_REMOVED) {
+			// the watcher never has to know about objects that came and went
+			watcher.changed.erase(handle);
+			if (watcher.added.erase(handle) == 0)
+				watcher.removed.insert(handle);
+		} else if (watcher.added.find(handle) == watcher.added.end())
+			watcher.changed.insert(handle);
+
+		if (watcher.notified)
+			continue;
+		BMessenger messenger(it->first);
+		if (messenger.SendMessage(B_CUSTOMIZABLE_LIST_CHANGED) == B_OK)
+			watcher.notified = true;
 	}
 }
+
+
+CustomizableRoster::watcher_changes::watcher_changes()
+	:
+	notified(false)
+{
+}
+
+
+CustomizableRoster::customizable_pool::customizable_pool()
+	:
+	size(-1)
+{
+	info.size = 0;
+	info.count = 0;
+	info.hits = 0;
+	info.misses = 0;
+	info.recycled = 0;
+	info.rejected = 0;
+}
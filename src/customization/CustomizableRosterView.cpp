@@ -80,6 +80,25 @@ InstalledCustomizableView::AttachedToWindow()
 }
 
 
+class CustomizableItem : public BStringItem {
+public:
+	CustomizableItem(const char* label, customizable_handle handle)
+		:
+		BStringItem(label),
+		fHandle(handle)
+	{
+	}
+
+	customizable_handle Handle() const
+	{
+		return fHandle;
+	}
+
+private:
+	customizable_handle	fHandle;
+};
+
+
 const uint32 kMsgComponentSelected = '&cse';
 const uint32 kMsgAddComponent = '&aco';
 const uint32 kMsgRemoveComponent = '&rco';
@@ -125,6 +144,7 @@ CustomizableRosterView::CustomizableRosterView()
 CustomizableRosterView::~CustomizableRosterView()
 {
 	fRoster->StopWatching(this);
+	_MakeEmpty();
 }
 
 
@@ -141,11 +161,8 @@ void
 CustomizableRosterView::MessageReceived(BMessage* message)
 {
 	switch (message->what) {
-		case B_CUSTOMIZABLE_ADDED:
-		case B_CUSTOMIZABLE_REMOVED:
-		case B_SOCKET_CONNECTED:
-		case B_SOCKET_DISCONNECTED:
-			_LoadCustomizableList();
+		case B_CUSTOMIZABLE_LIST_CHANGED:
+			_UpdateCustomizableList();
 			break;
 
 		case kMsgComponentSelected:
@@ -169,13 +186,13 @@ CustomizableRosterView::MessageReceived(BMessage* message)
 
 		case kMsgRemoveComponent:
 		{
-			BArray<BWeakReference<Customizable> > allCustomizable;
-			fRoster->GetCustomizableList(allCustomizable);
-			int32 index = fCustomizableListView->CurrentSelection();
-			if (index < 0 || index >= (int32)allCustomizable.CountItems())
+			CustomizableItem* item = dynamic_cast<CustomizableItem*>(
+				fCustomizableListView->ItemAt(
+					fCustomizableListView->CurrentSelection()));
+			if (item == NULL)
 				break;
 			BReference<Customizable> customizable
-				= allCustomizable.ItemAt(index).GetReference();
+				= fRoster->FindCustomizable(item->Handle());
 			if (customizable == NULL)
 				break;
 
@@ -194,18 +211,90 @@ CustomizableRosterView::MessageReceived(BMessage* message)
 void
 CustomizableRosterView::_LoadCustomizableList()
 {
-	fCustomizableListView->MakeEmpty();
+	_MakeEmpty();
+
+	BReference<CustomizableSnapshot> snapshot
+		= fRoster->GetCustomizableSnapshot();
+	if (snapshot.Get() == NULL)
+		return;
+	for (int32 i = 0; i < snapshot->CountItems(); i++) {
+		BReference<Customizable> customizable = snapshot->ItemAt(i);
+		if (customizable == NULL)
+			continue;
+		_AddItem(customizable);
+	}
+}
+
 
-	BArray<BWeakReference<Customizable> > allCustomizable;
-	fRoster->GetCustomizableList(allCustomizable);
-	for (int32 i = 0; i < allCustomizable.CountItems(); i++) {
+/*! Applies the changes collected by the roster since the last update. */
+void
+CustomizableRosterView::_UpdateCustomizableList()
+{
+	BMessage changes;
+	if (fRoster->GetChanges(this, &changes) != B_OK)
+		return;
+
+	int64 handle;
+	for (int32 i = 0; changes.FindInt64("removed", i, &handle) == B_OK; i++) {
+		std::map<customizable_handle, BStringItem*>::iterator it
+			= fItems.find(handle);
+		if (it == fItems.end())
+			continue;
+		fCustomizableListView->RemoveItem(it->second);
+		delete it->second;
+		fItems.erase(it);
+	}
+
+	for (int32 i = 0; changes.FindInt64("added", i, &handle) == B_OK; i++) {
+		// the list may have been loaded after the object was added
+		if (fItems.find(handle) != fItems.end())
+			continue;
 		BReference<Customizable> customizable
-			= allCustomizable.ItemAt(i).GetReference();
-		if (customizable == NULL)
+			= fRoster->FindCustomizable(handle);
+		if (customizable != NULL)
+			_AddItem(customizable);
+	}
+
+	for (int32 i = 0; changes.FindInt64("changed", i, &handle) == B_OK; i++) {
+		std::map<customizable_handle, BStringItem*>::iterator it
+			= fItems.find(handle);
+		BReference<Customizable> customizable
+			= fRoster->FindCustomizable(handle);
+		if (it == fItems.end() || customizable == NULL)
 			continue;
-		BString label = customizable->ObjectName();
-		if (customizable->CountOwnConnections() == 0)
-			label += " NC";
-		fCustomizableListView->AddItem(new BStringItem(label));
+		it->second->SetText(_Label(customizable));
+		fCustomizableListView->InvalidateItem(
+			fCustomizableListView->IndexOf(it->second));
 	}
 }
+
+
+void
+CustomizableRosterView::_AddItem(Customizable* customizable)
+{
+	BStringItem* item = new CustomizableItem(_Label(customizable),
+		customizable->Handle());
+	fCustomizableListView->AddItem(item);
+	fItems[customizable->Handle()] = item;
+}
+
+
+void
+CustomizableRosterView::_MakeEmpty()
+{
+	fCustomizableListView->MakeEmpty();
+	for (std::map<customizable_handle, BStringItem*>::iterator it
+		= fItems.begin(); it != fItems.end(); it++)
+		delete it->second;
+	fItems.clear();
+}
+
+
+BString
+CustomizableRosterView::_Label(Customizable* customizable)
+{
+	BString label = customizable->ObjectName();
+	if (customizable->CountOwnConnections() == 0)
+		label += " NC";
+	return label;
+}
@@ -87,6 +87,28 @@ CustomizableView::RemoveSelf()
 }
 
 
+status_t
+CustomizableView::Reset()
+{
+	status_t status = ResetContent();
+	if (status != B_OK)
+		return status;
+
+	// the identifier is proposed again when the view is inserted
+	RemoveSelf();
+	SetObjectName(NULL);
+	DisconnectAllEvents();
+	return B_OK;
+}
+
+
+status_t
+CustomizableView::ResetContent()
+{
+	return B_NOT_SUPPORTED;
+}
+
+
 BSize
 CustomizableView::PreferredSize()
 {
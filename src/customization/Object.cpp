@@ -6,16 +6,60 @@
 
 #include "Object.h"
 
+#include <string.h>
+
+#include <map>
+
 #include <Autolock.h>
 #include <Looper.h>
+#include <MessageFilter.h>
+
+
+struct event_name_less {
+	bool operator()(const char* name1, const char* name2) const
+	{
+		return strcmp(name1, name2) < 0;
+	}
+};
+
+
+//! The arguments of an async call, copied once and shared by all targets.
+struct async_args : BReferenceable {
+	PArgs						args;
+};
 
 
+/*! The targets of an async call that run on the same looper. The batch is
+queued at the AsyncEventFilter of the looper, which holds a reference to it. */
+struct async_batch : BReferenceable {
+	BReference<async_args>			args;
+	std::vector<connection_data>	calls;
+	BReference<async_refs>			refs;
+};
+
+
+static status_t
+PostAsyncBatch(BLooper* looper, async_batch* batch);
+
+
+/*! Changes are serialized by fConnectionLock. fSnapshotLock is only held to
+look up an event and to pick up or to replace its connection list, so the
+connected methods run without any lock held. */
 class BObject::EventConnections {
 public:
+	EventConnections()
+		:
+		fConnectionLock("event connections"),
+		fSnapshotLock("event snapshots")
+	{
+	}
+
 	~EventConnections()
 	{
 		for (int32 i = 0; i < fConnectedToEvents.CountItems(); i++)
 			delete fConnectedToEvents.ItemAt(i);
+		for (unsigned int i = 0; i < fEvents.size(); i++)
+			delete fEvents[i];
 	}
 
 	void Disconnect(BObject* source)
@@ -23,12 +67,41 @@ public:
 		BAutolock _(fConnectionLock);
 
 		for (unsigned int i = 0; i < fEvents.size(); i++) {
-			for (unsigned int c = 0; c < fEvents[i].connections.size(); c++)
-				fEvents[i].connections[c].target->DisconnectedFromEvent(source);
+			const std::vector<connection_data>& connections
+				= fEvents[i]->connections->connections;
+			for (unsigned int c = 0; c < connections.size(); c++)
+				connections[c].target->DisconnectedFromEvent(source);
 		}
 	
-		for (int32 i = 0; i < fConnectedToEvents.CountItems(); i++)
-			fConnectedToEvents.ItemAt(i)->DisconnectEvent(NULL, source);
+		// disconnecting removes the source from fConnectedToEvents
+		BObjectList<BObject> connectedToEvents(fConnectedToEvents);
+		for (int32 i = 0; i < connectedToEvents.CountItems(); i++)
+			connectedToEvents.ItemAt(i)->DisconnectEvent(NULL, source);
+	}
+
+	void DisconnectAll(BObject* source)
+	{
+		// collected first, disconnecting locks the connections again
+		std::vector<BString> events;
+		std::vector<BReference<BObject> > targets;
+		BObjectList<BObject> connectedToEvents;
+		{
+			BAutolock _(fConnectionLock);
+			for (unsigned int i = 0; i < fEvents.size(); i++) {
+				const std::vector<connection_data>& connections
+					= fEvents[i]->connections->connections;
+				for (unsigned int c = 0; c < connections.size(); c++) {
+					events.push_back(fEvents[i]->event);
+					targets.push_back(connections[c].target);
+				}
+			}
+			connectedToEvents.AddList(&fConnectedToEvents);
+		}
+
+		for (unsigned int i = 0; i < targets.size(); i++)
+			source->DisconnectEvent(events[i].String(), targets[i].Get());
+		for (int32 i = 0; i < connectedToEvents.CountItems(); i++)
+			connectedToEvents.ItemAt(i)->DisconnectEvent(NULL, source);
 	}
 
 	bool ConnectedToEvent(BObject* source)
@@ -45,16 +118,20 @@ public:
 
 	status_t AddEvent(const char* event, PMethodInterface* interface)
 	{
+		BAutolock _(fConnectionLock);
+
 		event_data* data = _FindEvent(event);
 		if (data != NULL)
 			return B_BAD_VALUE;
 
-		event_data newData;
-		fEvents.push_back(newData);
-		data = &fEvents[fEvents.size() - 1];
-
+		data = new event_data;
 		data->event = event;
 		data->interface = interface;
+		data->connections.SetTo(new connection_list, true);
+
+		BAutolock snapshotLocker(fSnapshotLock);
+		fEvents.push_back(data);
+		fEventIndex[data->event.String()] = data;
 		return B_OK;
 	}
 
@@ -73,8 +150,11 @@ public:
 		connection_data connection;
 		connection.target = target;
 		connection.method = method;
-		
-		data->connections.push_back(connection);
+
+		connection_list* connections = new connection_list;
+		connections->connections = data->connections->connections;
+		connections->connections.push_back(connection);
+		_Publish(data, connections);
 	
 		if (target->ConnectedToEvent(source) == true)
 			return B_OK;
@@ -82,120 +162,348 @@ public:
 		return B_BAD_VALUE;
 	}
 
-	status_t DisconnectEvent(const char* event, BObject* target)
+	status_t DisconnectEvent(BObject* source, const char* event,
+		BObject* target)
 	{
-		BAutolock _(fConnectionLock);
-
-		if (event == NULL) {
-			for (unsigned int i = 0; i < fEvents.size(); i++)
-				_DisconnectFromEvent(&fEvents[i], target);
-			return B_OK;
+		status_t status = B_BAD_VALUE;
+		int32 disconnected = 0;
+		{
+			BAutolock _(fConnectionLock);
+
+			if (event == NULL) {
+				for (unsigned int i = 0; i < fEvents.size(); i++) {
+					if (_DisconnectFromEvent(fEvents[i], target) == true)
+						disconnected++;
+				}
+				status = B_OK;
+			} else {
+				event_data* data = _FindEvent(event);
+				if (data != NULL
+					&& _DisconnectFromEvent(data, target) == true) {
+					disconnected++;
+					status = B_OK;
+				}
+			}
 		}
-	
-		event_data* data = _FindEvent(event);
-		if (data == NULL)
-			return B_BAD_VALUE;
-		if (_DisconnectFromEvent(data, target) == true)
-			return B_OK;
 
-		return B_BAD_VALUE;
+		// balance ConnectedToEvent(), outside of the lock since the target
+		// locks its own connections
+		for (int32 i = 0; i < disconnected; i++)
+			target->DisconnectedFromEvent(source);
+		return status;
 	}
 
 	status_t FireEventAsync(const char* event, PArgs &in, PArgs &out,
 		async_refs* refs)
 	{
-		BAutolock _(fConnectionLock);
-
-		event_data* data = _FindEvent(event);
-		if (data == NULL)
+		BReference<connection_list> snapshot;
+		if (!_GetSnapshot(event, snapshot))
 			return B_BAD_VALUE;
-		for (unsigned int i = 0; i < data->connections.size(); i++) {
-			connection_data& con = data->connections[i];
-			con.target->RunMethodAsync(con.method, in, out, refs);
+
+		const std::vector<connection_data>& connections
+			= snapshot->connections;
+		if (connections.empty())
+			return B_OK;
+
+		// the arguments are copied once, the targets are grouped by looper
+		BReference<async_args> args(new async_args, true);
+		args->args = in;
+
+		typedef std::map<BLooper*, async_batch*> BatchMap;
+		BatchMap batches;
+		for (unsigned int i = 0; i < connections.size(); i++) {
+			const connection_data& con = connections[i];
+			BLooper* looper = con.target->Looper();
+			if (looper == NULL)
+				continue;
+
+			async_batch*& batch = batches[looper];
+			if (batch == NULL) {
+				batch = new async_batch;
+				batch->args = args;
+				batch->refs = refs;
+			}
+			batch->calls.push_back(con);
 		}
-		return B_OK;
+
+		status_t status = B_OK;
+		for (BatchMap::iterator it = batches.begin(); it != batches.end();
+			it++) {
+			status_t postStatus = PostAsyncBatch(it->first, it->second);
+			if (postStatus != B_OK)
+				status = postStatus;
+		}
+		return status;
 	}
 
 	status_t FireEventSync(const char* event, PArgs &in, PArgs &out)
 	{
-		BAutolock _(fConnectionLock);
-
-		event_data* data = _FindEvent(event);
-		if (data == NULL)
+		BReference<connection_list> snapshot;
+		if (!_GetSnapshot(event, snapshot))
 			return B_BAD_VALUE;
-		for (unsigned int i = 0; i < data->connections.size(); i++) {
-			connection_data& con = data->connections[i];
-			con.method->Run(con.target, in, out);
+
+		const std::vector<connection_data>& connections
+			= snapshot->connections;
+		for (unsigned int i = 0; i < connections.size(); i++) {
+			const connection_data& con = connections[i];
+			con.method->Run(con.target.Get(), in, out);
 		}
 		return B_OK;
 	}
 
-	bool AsyncMethodSent(async_refs* refs)
-	{
-		BAutolock _(fConnectionLock);
-		refs->AcquireReference();
-		fAsyncArgumentRefs.AddItem(refs);
-		return true;
-	}
-
-	void AsyncMethodFinished(async_refs* refs)
-	{
-		if (refs == NULL)
-			return;
-		BAutolock _(fConnectionLock);
-		int32 count = refs->ReleaseReference();
-		if (count == 1)
-			fAsyncArgumentRefs.RemoveItem(refs);
-	}
-
 	int32
 	CountEvents()
 	{
+		BAutolock _(fSnapshotLock);
 		return fEvents.size();
 	}
 
+	//! Events are never removed, the data stays valid as long as this object.
 	const event_data*
 	EventAt(int32 index)
 	{
+		BAutolock _(fSnapshotLock);
 		if (index < 0 || index >= (int32)fEvents.size())
 			return NULL;
-		return &fEvents[index];
+		return fEvents[index];
 	}
 
 private:
 	bool _DisconnectFromEvent(event_data* data, BObject* target)
 	{
-		for (unsigned int i = 0; i < data->connections.size(); i++) {
-			connection_data& con = data->connections[i];
-			if (con.target.Get() == target) {
-				data->connections.erase(data->connections.begin() + i);
-				return true;
-			}
+		const std::vector<connection_data>& connections
+			= data->connections->connections;
+		for (unsigned int i = 0; i < connections.size(); i++) {
+			if (connections[i].target.Get() != target)
+				continue;
+
+			connection_list* newConnections = new connection_list;
+			newConnections->connections = connections;
+			newConnections->connections.erase(
+				newConnections->connections.begin() + i);
+			_Publish(data, newConnections);
+			return true;
 		}
 		return false;
 	}
 
-	event_data* _FindEvent(const char* event)
+	//! Replaces the connections, a fire in progress keeps the old list.
+	void _Publish(event_data* data, connection_list* connections)
 	{
-		for (unsigned int i = 0; i < fEvents.size(); i++) {
-			event_data& data = fEvents[i];
-			if (data.event == event)
-				return &data;
+		// The old list may hold the last reference to a target, release it
+		// after unlocking.
+		BReference<connection_list> oldConnections;
+		{
+			BAutolock _(fSnapshotLock);
+			oldConnections = data->connections;
+			data->connections.SetTo(connections, true);
 		}
-		return NULL;
+	}
+
+	bool _GetSnapshot(const char* event, BReference<connection_list>& snapshot)
+	{
+		BAutolock _(fSnapshotLock);
+		event_data* data = _FindEvent(event);
+		if (data == NULL)
+			return false;
+		snapshot = data->connections;
+		return true;
+	}
+
+	//! Needs one of the two locks.
+	event_data* _FindEvent(const char* event)
+	{
+		if (event == NULL)
+			return NULL;
+		EventIndex::const_iterator it = fEventIndex.find(event);
+		if (it == fEventIndex.end())
+			return NULL;
+		return it->second;
 	}
 
 private:
+	typedef std::map<const char*, event_data*, event_name_less> EventIndex;
+
 			BLocker				fConnectionLock;
-			std::vector<event_data>	fEvents;
+			BLocker				fSnapshotLock;
+			std::vector<event_data*>	fEvents;
+			EventIndex			fEventIndex;
 			BObjectList<BObject>	fConnectedToEvents;
-			BObjectList<async_refs>	fAsyncArgumentRefs;
 };
 
 
 const int32 kMsgRunAsyncEvent = '_REv';
 
 
+/*! Runs the async batches of one looper. It is a common filter of the looper
+and the batch messages are addressed to the looper itself, so no target can
+swallow the calls of the others by leaving the looper. The filter is deleted
+with the looper and releases the batches that never ran.
+
+Adding the filter needs the looper lock. Until a thread that holds it has done
+so, the batches wait in the filter and their messages are addressed to the
+targets, which install it when the first message reaches them. */
+class AsyncEventFilter : public BMessageFilter {
+public:
+	AsyncEventFilter()
+		:
+		BMessageFilter(kMsgRunAsyncEvent),
+		fInstalled(false)
+	{
+	}
+
+	~AsyncEventFilter()
+	{
+		std::vector<async_batch*> pending;
+		{
+			BAutolock _(sLock);
+			Filters::iterator it = sFilters.begin();
+			for (; it != sFilters.end(); it++) {
+				if (it->second == this) {
+					sFilters.erase(it);
+					break;
+				}
+			}
+			pending.swap(fPending);
+		}
+		for (unsigned int i = 0; i < pending.size(); i++)
+			pending[i]->ReleaseReference();
+	}
+
+	filter_result
+	Filter(BMessage* message, BHandler** target)
+	{
+		// a message runs all batches queued so far, the messages of those
+		// batches find nothing left to do
+		std::vector<async_batch*> pending;
+		{
+			BAutolock _(sLock);
+			pending.swap(fPending);
+		}
+
+		for (unsigned int i = 0; i < pending.size(); i++) {
+			BReference<async_batch> batch(pending[i], true);
+			for (unsigned int j = 0; j < batch->calls.size(); j++) {
+				const connection_data& call = batch->calls[j];
+				if (call.target->Looper() != Looper())
+					continue;
+
+				// every method gets its own copy, it may change its arguments
+				PArgs inArgs, outArgs;
+				inArgs = batch->args->args;
+				call.method->Run(call.target.Get(), inArgs, outArgs);
+			}
+		}
+		return B_SKIP_MESSAGE;
+	}
+
+	static bool
+	IsInstalled(BLooper* looper)
+	{
+		BAutolock _(sLock);
+		Filters::iterator it = sFilters.find(looper);
+		return it != sFilters.end() && it->second->fInstalled;
+	}
+
+	//! The looper must be locked.
+	static void
+	Install(BLooper* looper)
+	{
+		BAutolock _(sLock);
+		AsyncEventFilter* filter = _FilterFor(looper);
+		if (filter->fInstalled)
+			return;
+
+		filter->fInstalled = true;
+		looper->AddCommonFilter(filter);
+	}
+
+	//! Installs the filter and runs the batches, for MessageReceived().
+	static void
+	InstallAndRun(BLooper* looper, BMessage* message)
+	{
+		Install(looper);
+
+		AsyncEventFilter* filter;
+		{
+			BAutolock _(sLock);
+			filter = sFilters[looper];
+		}
+		filter->Filter(message, NULL);
+	}
+
+	//! Takes over the reference of the caller to the batch.
+	static status_t
+	Post(BLooper* looper, async_batch* batch)
+	{
+		BAutolock _(sLock);
+		AsyncEventFilter* filter = _FilterFor(looper);
+		std::vector<async_batch*>& pending = filter->fPending;
+		pending.push_back(batch);
+
+		BMessage message(kMsgRunAsyncEvent);
+		status_t status = B_ERROR;
+		if (filter->fInstalled)
+			status = looper->PostMessage(&message, looper);
+		else {
+			// any target that is still in the looper will do
+			for (unsigned int i = 0; i < batch->calls.size(); i++) {
+				BObject* target = batch->calls[i].target.Get();
+				if (target->Looper() == looper
+					&& looper->PostMessage(&message, target) == B_OK)
+					status = B_OK;
+			}
+		}
+		if (status != B_OK) {
+			pending.pop_back();
+			batch->ReleaseReference();
+		}
+		return status;
+	}
+
+private:
+	typedef std::map<BLooper*, AsyncEventFilter*> Filters;
+
+	//! sLock must be held.
+	static AsyncEventFilter*
+	_FilterFor(BLooper* looper)
+	{
+		AsyncEventFilter*& filter = sFilters[looper];
+		if (filter == NULL)
+			filter = new AsyncEventFilter;
+		return filter;
+	}
+
+	static	BLocker				sLock;
+	static	Filters				sFilters;
+
+			// guarded by sLock
+			std::vector<async_batch*>	fPending;
+			bool				fInstalled;
+};
+
+
+BLocker AsyncEventFilter::sLock("async event filters");
+AsyncEventFilter::Filters AsyncEventFilter::sFilters;
+
+
+/*! All batches to a looper go through its AsyncEventFilter. A target that has
+left the looper in the meantime is skipped. */
+static status_t
+PostAsyncBatch(BLooper* looper, async_batch* batch)
+{
+	// SetLooper() installs the filter. For targets that were added to the
+	// looper in another way it is installed here if the looper is free,
+	// waiting for it could deadlock with a looper that waits for the caller.
+	if (!AsyncEventFilter::IsInstalled(looper)
+		&& looper->LockWithTimeout(0) == B_OK) {
+		AsyncEventFilter::Install(looper);
+		looper->Unlock();
+	}
+	return AsyncEventFilter::Post(looper, batch);
+}
+
+
 BObject::BObject()
 	:
 	fEventConnections(NULL)
@@ -214,29 +522,13 @@ BObject::~BObject()
 void
 BObject::MessageReceived(BMessage* message)
 {
-	switch (message->what) {
-	case kMsgRunAsyncEvent:
-	{
-		PArgs inArgs, outArgs;
-		PMethod* method = NULL;
-		BMessage in, out;
-		async_refs* refs = NULL;
-		message->FindPointer("refs", (void**)&refs);
-		message->FindPointer("method", (void**)&method);
-		message->FindMessage("in", &in);
-
-		inArgs.SetBackend(in);
-		method->Run(this, inArgs, outArgs);
-
-		// release references
-		if (fEventConnections != NULL)
-			fEventConnections->AsyncMethodFinished(refs);
-		break;
+	// async calls are run by the AsyncEventFilter of the looper, this only
+	// gets the batches that were posted before it was installed
+	if (message->what == kMsgRunAsyncEvent) {
+		AsyncEventFilter::InstallAndRun(Looper(), message);
+		return;
 	}
-
-	default:
-		PObject::MessageReceived(message);	
-	}	
+	PObject::MessageReceived(message);
 }
 
 
@@ -249,6 +541,7 @@ BObject::SetLooper(BLooper* looper)
 	if (oldLooper != NULL)
 		oldLooper->RemoveHandler(this);
 	looper->AddHandler(this);
+	AsyncEventFilter::Install(looper);
 }
 
 
@@ -318,7 +611,7 @@ BObject::DisconnectEvent(const char* event, BObject* target)
 	if (fEventConnections == NULL)
 		return B_ERROR;
 
-	return fEventConnections->DisconnectEvent(event, target);
+	return fEventConnections->DisconnectEvent(this, event, target);
 }
 							
 
@@ -329,25 +622,17 @@ BObject::RunMethodAsync(PMethod* method, PArgs &in, PArgs &out,
 	BLooper* looper = Looper();
 	if (looper == NULL)
 		return B_ERROR;
-	if (refs != NULL) {
-		if (fEventConnections == NULL);
-			_GetEventConnections();
-		if (fEventConnections == NULL)
-			return B_NO_MEMORY;
-	}
 
-	BMessage message(kMsgRunAsyncEvent);
-	message.AddPointer("refs", refs);
-	message.AddPointer("method", method);
-	BMessage inMessage = in.GetBackend();
-	message.AddMessage("in", &inMessage);
-	status_t status = looper->PostMessage(&message, this);
-	if (status != B_OK)
-		return status;
+	connection_data call;
+	call.target = this;
+	call.method = method;
 
-	if (refs != NULL)
-		fEventConnections->AsyncMethodSent(refs);
-	return B_OK;
+	async_batch* batch = new async_batch;
+	batch->args.SetTo(new async_args, true);
+	batch->args->args = in;
+	batch->calls.push_back(call);
+	batch->refs = refs;
+	return PostAsyncBatch(looper, batch);
 }
 
 
@@ -380,6 +665,14 @@ BObject::ConnectedToEvent(BObject* source)
 }
 
 
+void
+BObject::DisconnectAllEvents()
+{
+	if (fEventConnections != NULL)
+		fEventConnections->DisconnectAll(this);
+}
+
+
 bool
 BObject::DisconnectedFromEvent(BObject* source)
 {
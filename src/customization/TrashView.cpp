@@ -7,6 +7,25 @@
 #include <TrashView.h>
 
 
+class TrashItem : public BStringItem {
+public:
+	TrashItem(Customizable* customizable)
+		:
+		BStringItem(customizable->ObjectName()),
+		fCustomizable(customizable)
+	{
+	}
+
+	BReference<Customizable> GetCustomizable()
+	{
+		return fCustomizable.GetReference();
+	}
+
+private:
+	BWeakReference<Customizable>	fCustomizable;
+};
+
+
 TrashView::TrashView(BALMEditor* editor)
 	:
 	fEditor(editor)
@@ -15,11 +34,19 @@ TrashView::TrashView(BALMEditor* editor)
 }
 
 
+TrashView::~TrashView()
+{
+	_MakeEmpty();
+}
+
+
 bool
 TrashView::InitiateDrag(BPoint point, int32 index, bool wasSelected)
 {
-	BReference<Customizable> customizable
-		= fTrashList.ItemAt(index).GetReference();
+	TrashItem* item = dynamic_cast<TrashItem*>(ItemAt(index));
+	if (item == NULL)
+		return false;
+	BReference<Customizable> customizable = item->GetCustomizable();
 	if (customizable.Get() == NULL)
 		return false;
 	BMessage dragMessage(BALM::kUnTrashComponent);
@@ -33,7 +60,9 @@ TrashView::InitiateDrag(BPoint point, int32 index, bool wasSelected)
 void
 TrashView::AttachedToWindow()
 {
+	// changes made before are only in the full list
 	fEditor->SetTrashWatcher(BMessenger(this));
+	_LoadTrash();
 }
 
 
@@ -42,7 +71,7 @@ TrashView::MessageReceived(BMessage* message)
 {
 	switch (message->what) {
 	case BALM::kTrashUpdated:
-		_LoadTrash();
+		_UpdateTrash();
 		break;
 
 	default:
@@ -54,15 +83,55 @@ TrashView::MessageReceived(BMessage* message)
 void
 TrashView::_LoadTrash()
 {
-	MakeEmpty();
-	fTrashList.MakeEmpty();
+	_MakeEmpty();
+
+	BArray<BWeakReference<Customizable> > trash;
+	fEditor->GetTrash(trash);
+	_AddItems(trash);
+}
+
 
-	fEditor->GetTrash(fTrashList);
-	for (int32 i = 0; i < fTrashList.CountItems(); i++) {
-		BReference<Customizable> customizable
-			= fTrashList.ItemAt(i).GetReference();
-		if (customizable.Get() == NULL)
+void
+TrashView::_UpdateTrash()
+{
+	BArray<BWeakReference<Customizable> > added;
+	BArray<customizable_handle> removed;
+	fEditor->GetTrashChanges(added, removed);
+
+	for (int32 i = 0; i < removed.CountItems(); i++) {
+		std::map<customizable_handle, BStringItem*>::iterator it
+			= fItems.find(removed.ItemAt(i));
+		if (it == fItems.end())
+			continue;
+		RemoveItem(it->second);
+		delete it->second;
+		fItems.erase(it);
+	}
+	_AddItems(added);
+}
+
+
+void
+TrashView::_AddItems(BArray<BWeakReference<Customizable> >& list)
+{
+	for (int32 i = 0; i < list.CountItems(); i++) {
+		BReference<Customizable> customizable = list.ItemAt(i).GetReference();
+		if (customizable.Get() == NULL
+			|| fItems.find(customizable->Handle()) != fItems.end())
 			continue;
-		AddItem(new BStringItem(customizable->ObjectName()));
+		BStringItem* item = new TrashItem(customizable.Get());
+		AddItem(item);
+		fItems[customizable->Handle()] = item;
 	}
 }
+
+
+void
+TrashView::_MakeEmpty()
+{
+	MakeEmpty();
+	for (std::map<customizable_handle, BStringItem*>::iterator it
+		= fItems.begin(); it != fItems.end(); it++)
+		delete it->second;
+	fItems.clear();
+}
@@ -21,6 +21,7 @@
 BALMEditor::trash_item::trash_item(Customizable* customizable)
 {
 	raw_pointer = customizable;
+	handle = customizable->Handle();
 	trash = customizable;
 }
 
@@ -34,7 +35,8 @@ BALMEditor::BALMEditor(BALMLayout* layout)
 	fCreationMode(false),
 	fShowXTabs(false),
 	fShowYTabs(false),
-	fFreePlacement(false)
+	fFreePlacement(false),
+	fTrashNotified(false)
 {
 	fOverlapManager = new BALM::OverlapManager(layout);
 }
@@ -268,7 +270,7 @@ BALMEditor::Trash(Customizable* customizable)
 	if (item == NULL)
 		return false;
 	fTrash.AddItem(item);
-	fTrashWatcher.SendMessage(kTrashUpdated);
+	_TrashChanged(item->handle, true);
 	return true;
 }
 
@@ -283,16 +285,16 @@ BALMEditor::UnTrash(Customizable* customizable)
 		BReference<Customizable> ref = item->trash;
 		if (ref.Get() == customizable) {
 			fTrash.RemoveItemAt(i);	
+			_TrashChanged(item->handle, false);
 			delete item;
-			fTrashWatcher.SendMessage(kTrashUpdated);
 			return ref;
 		}
 		ref = item->weak_trash.GetReference();
 		if (ref.Get() == NULL)
 			continue;
 		fTrash.RemoveItemAt(i);	
+		_TrashChanged(item->handle, false);
 		delete item;
-		fTrashWatcher.SendMessage(kTrashUpdated);
 		return ref;
 	}
 	return NULL;
@@ -307,23 +309,29 @@ BALMEditor::DeleteFromTrash(Customizable* customizable)
 	for (int32 i = 0; i < count; i++) {
 		trash_item* item = fTrash.ItemAt(i);
 		if (item->trash.Get() == customizable) {
+			// if nothing else uses it, it is reused for the next insertion
+			if (customizable->Roster()->RecycleCustomizable(customizable)) {
+				fTrash.RemoveItemAt(i);
+				_TrashChanged(item->handle, false);
+				delete item;
+				return true;
+			}
 			item->weak_trash = item->trash;
 			item->trash = NULL;
 			if (!item->weak_trash.IsAlive()) {
 				fTrash.RemoveItemAt(i);
+				_TrashChanged(item->handle, false);
 				delete item;
-				fTrashWatcher.SendMessage(kTrashUpdated);
-				return true;
 			}
-			fTrashWatcher.SendMessage(kTrashUpdated);
+			// otherwise the watcher's weak reference stays valid
 			return true;
 		}
 		BReference<Customizable> ref = item->weak_trash.GetReference();
 		if (ref.Get() != customizable)
 			continue;
 		fTrash.RemoveItemAt(i);
+		_TrashChanged(item->handle, false);
 		delete item;
-		fTrashWatcher.SendMessage(kTrashUpdated);
 		return true;
 	}
 	return false;
@@ -347,12 +355,42 @@ BALMEditor::GetTrash(BArray<BWeakReference<Customizable> >& list)
 	}
 }
 
+
+
+void
+BALMEditor::GetTrashChanges(BArray<BWeakReference<Customizable> >& added,
+	BArray<customizable_handle>& removed)
+{
+	BAutolock _(fLock);
+	int32 count = fTrash.CountItems();
+	for (int32 i = 0; i < count && !fTrashAdded.empty(); i++) {
+		trash_item* item = fTrash.ItemAt(i);
+		if (fTrashAdded.erase(item->handle) == 0)
+			continue;
+		if (item->trash.Get() == NULL)
+			added.AddItem(item->weak_trash);
+		else
+			added.AddItem(item->trash);
+	}
+	for (std::set<customizable_handle>::iterator it = fTrashRemoved.begin();
+		it != fTrashRemoved.end(); it++)
+		removed.AddItem(*it);
+
+	fTrashAdded.clear();
+	fTrashRemoved.clear();
+	fTrashNotified = false;
+}
+
 			
 void
 BALMEditor::SetTrashWatcher(BMessenger target)
 {
 	BAutolock _(fLock);
 	fTrashWatcher = target;
+	// a new watcher starts with GetTrash()
+	fTrashAdded.clear();
+	fTrashRemoved.clear();
+	fTrashNotified = false;
 }
 
 
@@ -399,3 +437,18 @@ BALMEditor::ProposeIdentifier(IViewContainer* container)
 	}
 	return identifier;
 }
+
+
+void
+BALMEditor::_TrashChanged(customizable_handle handle, bool added)
+{
+	if (added)
+		fTrashAdded.insert(handle);
+	else if (fTrashAdded.erase(handle) == 0)
+		fTrashRemoved.insert(handle);
+
+	if (fTrashNotified)
+		return;
+	if (fTrashWatcher.SendMessage(kTrashUpdated) == B_OK)
+		fTrashNotified = true;
+}
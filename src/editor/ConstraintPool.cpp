@@ -0,0 +1,164 @@
+/*
+ * Copyright 2012, Clemens Zeidler <haiku@clemens-zeidler.de>
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "ConstraintPool.h"
+
+
+using namespace BALM;
+
+
+ConstraintPool::ConstraintPool(LinearSpec* linearSpec)
+	:
+	fLinearSpec(linearSpec),
+	fAllocations(0),
+	fReuses(0)
+{
+}
+
+
+ConstraintPool::~ConstraintPool()
+{
+	RemoveAll();
+
+	// all constraints are detached now and owned by us
+	for (unsigned int i = 0; i < fSlots.size(); i++)
+		delete fSlots[i].constraint;
+}
+
+
+ConstraintPool::handle
+ConstraintPool::AddConstraint(double coeff1, Variable* var1, double coeff2,
+	Variable* var2, OperatorType op, double rightSide)
+{
+	if (fFreeSlots.empty()) {
+		Constraint* constraint = fLinearSpec->AddConstraint(coeff1, var1,
+			coeff2, var2, op, rightSide);
+		if (constraint == NULL)
+			return kInvalidHandle;
+		fAllocations++;
+
+		slot newSlot;
+		newSlot.constraint = constraint;
+		newSlot.used = true;
+		newSlot.enabled = true;
+		fSlots.push_back(newSlot);
+		return fSlots.size() - 1;
+	}
+
+	handle index = fFreeSlots.back();
+	fFreeSlots.pop_back();
+	slot& freeSlot = fSlots[index];
+	Constraint* constraint = freeSlot.constraint;
+
+	// The constraint is detached so the summands can be retargeted without
+	// notifying the solver. The solver picks up the new variables when the
+	// constraint is added again.
+	SummandList* summands = constraint->LeftSide();
+	Summand* summand1 = summands->ItemAt(0);
+	summand1->SetCoeff(coeff1);
+	summand1->SetVar(var1);
+	Summand* summand2 = summands->ItemAt(1);
+	summand2->SetCoeff(coeff2);
+	summand2->SetVar(var2);
+	if (constraint->Op() != op)
+		constraint->SetOp(op);
+	if (constraint->RightSide() != rightSide)
+		constraint->SetRightSide(rightSide);
+
+	if (!fLinearSpec->AddConstraint(constraint)) {
+		fFreeSlots.push_back(index);
+		return kInvalidHandle;
+	}
+	fReuses++;
+
+	freeSlot.used = true;
+	freeSlot.enabled = true;
+	return index;
+}
+
+
+bool
+ConstraintPool::RemoveConstraint(handle constraint)
+{
+	if (!_IsValid(constraint))
+		return false;
+
+	slot& usedSlot = fSlots[constraint];
+	if (usedSlot.enabled)
+		fLinearSpec->RemoveConstraint(usedSlot.constraint, false);
+	usedSlot.used = false;
+	usedSlot.enabled = false;
+	fFreeSlots.push_back(constraint);
+	return true;
+}
+
+
+void
+ConstraintPool::RemoveAll()
+{
+	for (unsigned int i = 0; i < fSlots.size(); i++) {
+		if (fSlots[i].used)
+			RemoveConstraint(i);
+	}
+}
+
+
+bool
+ConstraintPool::SetEnabled(handle constraint, bool enabled)
+{
+	if (!_IsValid(constraint))
+		return false;
+
+	slot& usedSlot = fSlots[constraint];
+	if (usedSlot.enabled == enabled)
+		return true;
+	if (enabled) {
+		if (!fLinearSpec->AddConstraint(usedSlot.constraint))
+			return false;
+	} else
+		fLinearSpec->RemoveConstraint(usedSlot.constraint, false);
+	usedSlot.enabled = enabled;
+	return true;
+}
+
+
+Constraint*
+ConstraintPool::ConstraintAt(handle constraint) const
+{
+	if (!_IsValid(constraint))
+		return NULL;
+	return fSlots[constraint].constraint;
+}
+
+
+int32
+ConstraintPool::CountConstraints() const
+{
+	return fSlots.size() - fFreeSlots.size();
+}
+
+
+int32
+ConstraintPool::CountAllocations() const
+{
+	return fAllocations;
+}
+
+
+int32
+ConstraintPool::CountReuses() const
+{
+	return fReuses;
+}
+
+
+bool
+ConstraintPool::_IsValid(handle constraint) const
+{
+	if (constraint < 0 || constraint >= (handle)fSlots.size())
+		return false;
+	return fSlots[constraint].used;
+}
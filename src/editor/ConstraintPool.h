@@ -0,0 +1,71 @@
+/*
+ * Copyright 2012, Clemens Zeidler <haiku@clemens-zeidler.de>
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef	CONSTRAINT_POOL_H
+#define	CONSTRAINT_POOL_H
+
+
+#include <vector>
+
+#include "LinearSpec.h"
+
+
+namespace BALM {
+
+
+/*! Keeps the two summand constraints (coeff1 * var1 + coeff2 * var2 op
+rightSide) that the editor adds and removes in every edit cycle. A removed
+constraint is only detached from the solver and is retargeted by the next
+AddConstraint() call. Thus a steady edit cycle does not allocate any Constraint
+or Summand object. Constraints are addressed by a handle which stays valid till
+the constraint is removed; a handle is reused after that. */
+class ConstraintPool {
+public:
+	typedef int32 handle;
+	static const handle kInvalidHandle = -1;
+
+								ConstraintPool(LinearSpec* linearSpec);
+								~ConstraintPool();
+
+			handle				AddConstraint(double coeff1, Variable* var1,
+									double coeff2, Variable* var2,
+									OperatorType op, double rightSide);
+			bool				RemoveConstraint(handle constraint);
+			void				RemoveAll();
+
+			//! Detaches or re-attaches a constraint without giving it back.
+			bool				SetEnabled(handle constraint, bool enabled);
+
+			Constraint*			ConstraintAt(handle constraint) const;
+			int32				CountConstraints() const;
+
+			//! Constraints allocated over the pool lifetime.
+			int32				CountAllocations() const;
+			//! AddConstraint() calls that reused a detached constraint.
+			int32				CountReuses() const;
+
+private:
+			struct slot {
+				Constraint*		constraint;
+				bool			used;
+				bool			enabled;
+			};
+
+			bool				_IsValid(handle constraint) const;
+
+			LinearSpec*			fLinearSpec;
+			std::vector<slot>	fSlots;
+			std::vector<handle>	fFreeSlots;
+			int32				fAllocations;
+			int32				fReuses;
+};
+
+
+}	// namespace BALM
+
+
+using BALM::ConstraintPool;
+
+
+#endif	// CONSTRAINT_POOL_H
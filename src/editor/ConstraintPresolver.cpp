@@ -0,0 +1,337 @@
+/*
+ * Copyright 2012, Clemens Zeidler <haiku@clemens-zeidler.de>
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "ConstraintPresolver.h"
+
+#include <algorithm>
+
+
+using namespace BALM;
+
+
+//! The acyclic reduction needs nodes * nodes bits.
+static const int32 kMaxAcyclicNodes = 8192;
+
+
+ConstraintPresolver::ConstraintPresolver()
+	:
+	fGeneration(0),
+	fEliminatedRows(0),
+	fCoalescedVariables(0)
+{
+}
+
+
+void
+ConstraintPresolver::AddEquality(Variable* var1, Variable* var2)
+{
+	Variable* root1 = _Find(var1);
+	Variable* root2 = _Find(var2);
+	if (root1 == root2)
+		return;
+	fParents.Put(root2, root1);
+	fCoalescedVariables++;
+}
+
+
+void
+ConstraintPresolver::AddFixedOrder(Variable* lower, Variable* upper)
+{
+	edge newEdge;
+	newEdge.lower = lower;
+	newEdge.upper = upper;
+	newEdge.candidate = -1;
+	newEdge.removed = false;
+	fEdges.push_back(newEdge);
+}
+
+
+int32
+ConstraintPresolver::AddCandidate(Variable* lower, Variable* upper)
+{
+	edge newEdge;
+	newEdge.lower = lower;
+	newEdge.upper = upper;
+	newEdge.candidate = fRedundant.size();
+	newEdge.removed = false;
+	fEdges.push_back(newEdge);
+	fRedundant.push_back(false);
+	return newEdge.candidate;
+}
+
+
+bool
+ConstraintPresolver::AddConstraint(Constraint* constraint)
+{
+	// soft constraints can be violated and imply nothing
+	if (constraint->PenaltyNeg() >= 0 || constraint->PenaltyPos() >= 0)
+		return false;
+	if (constraint->RightSide() != 0)
+		return false;
+	SummandList* summands = constraint->LeftSide();
+	if (summands->CountItems() != 2)
+		return false;
+	Summand* summand1 = summands->ItemAt(0);
+	Summand* summand2 = summands->ItemAt(1);
+	double coeff = summand2->Coeff();
+	if (coeff == 0 || summand1->Coeff() != -coeff)
+		return false;
+
+	// normalize to coeff * (var2 - var1) op 0 with a positive coeff
+	Variable* var1 = summand1->Var();
+	Variable* var2 = summand2->Var();
+	if (coeff < 0) {
+		var1 = summand2->Var();
+		var2 = summand1->Var();
+	}
+
+	switch (constraint->Op()) {
+		case LinearProgramming::kEQ:
+			AddEquality(var1, var2);
+			break;
+		case LinearProgramming::kGE:
+			AddFixedOrder(var1, var2);
+			break;
+		case LinearProgramming::kLE:
+			AddFixedOrder(var2, var1);
+			break;
+	}
+	return true;
+}
+
+
+void
+ConstraintPresolver::Run()
+{
+	fEliminatedRows = 0;
+	for (unsigned int i = 0; i < fRedundant.size(); i++)
+		fRedundant[i] = false;
+
+	fNodes.Clear();
+	for (unsigned int i = 0; i < fEdges.size(); i++) {
+		edge& current = fEdges[i];
+		current.lower = _Find(current.lower);
+		current.upper = _Find(current.upper);
+		current.from = _NodeIndex(current.lower);
+		current.to = _NodeIndex(current.upper);
+		current.removed = false;
+		// the variables have been coalesced
+		if (current.from == current.to && current.candidate >= 0)
+			_Remove(current);
+	}
+
+	int32 nodeCount = fNodes.Size();
+	_BuildOutgoing(nodeCount);
+
+	// Only drop a candidate if the remaining edges still imply it, this keeps
+	// the reduced set equivalent to the original one.
+	std::vector<int32> order;
+	if (nodeCount <= kMaxAcyclicNodes
+		&& _SortTopologically(nodeCount, order))
+		_ReduceAcyclic(order);
+	else
+		_ReduceCyclic(nodeCount);
+}
+
+
+bool
+ConstraintPresolver::IsRedundant(int32 candidate) const
+{
+	if (candidate < 0 || candidate >= (int32)fRedundant.size())
+		return false;
+	return fRedundant[candidate];
+}
+
+
+int32
+ConstraintPresolver::CountEliminatedRows() const
+{
+	return fEliminatedRows;
+}
+
+
+int32
+ConstraintPresolver::CountCoalescedVariables() const
+{
+	return fCoalescedVariables;
+}
+
+
+Variable*
+ConstraintPresolver::_Find(Variable* var)
+{
+	Variable** parent;
+	if (!fParents.Get(var, parent))
+		return var;
+	Variable* root = _Find(*parent);
+	// lookups don't change the map, so parent is still valid
+	*parent = root;
+	return root;
+}
+
+
+int32
+ConstraintPresolver::_NodeIndex(Variable* var)
+{
+	int32* index;
+	if (fNodes.Get(var, index))
+		return *index;
+	int32 newIndex = fNodes.Size();
+	fNodes.Put(var, newIndex);
+	return newIndex;
+}
+
+
+void
+ConstraintPresolver::_Remove(edge& current)
+{
+	current.removed = true;
+	fRedundant[current.candidate] = true;
+	fEliminatedRows++;
+}
+
+
+//! Sorts the edges by their lower node, edges within one node are left out.
+void
+ConstraintPresolver::_BuildOutgoing(int32 nodeCount)
+{
+	fFirstOutgoing.assign(nodeCount + 1, 0);
+	for (unsigned int i = 0; i < fEdges.size(); i++) {
+		if (fEdges[i].from != fEdges[i].to)
+			fFirstOutgoing[fEdges[i].from + 1]++;
+	}
+	for (int32 node = 0; node < nodeCount; node++)
+		fFirstOutgoing[node + 1] += fFirstOutgoing[node];
+
+	fOutgoing.resize(fFirstOutgoing[nodeCount]);
+	std::vector<int32> next(fFirstOutgoing.begin(), fFirstOutgoing.end() - 1);
+	for (unsigned int i = 0; i < fEdges.size(); i++) {
+		if (fEdges[i].from != fEdges[i].to)
+			fOutgoing[next[fEdges[i].from]++] = i;
+	}
+}
+
+
+//! Returns false if the edges have a cycle.
+bool
+ConstraintPresolver::_SortTopologically(int32 nodeCount,
+	std::vector<int32>& order)
+{
+	std::vector<int32> inDegree(nodeCount, 0);
+	for (unsigned int i = 0; i < fOutgoing.size(); i++)
+		inDegree[fEdges[fOutgoing[i]].to]++;
+
+	order.clear();
+	order.reserve(nodeCount);
+	for (int32 node = 0; node < nodeCount; node++) {
+		if (inDegree[node] == 0)
+			order.push_back(node);
+	}
+	for (unsigned int i = 0; i < order.size(); i++) {
+		int32 node = order[i];
+		for (int32 e = fFirstOutgoing[node]; e < fFirstOutgoing[node + 1];
+			e++) {
+			int32 to = fEdges[fOutgoing[e]].to;
+			if (--inDegree[to] == 0)
+				order.push_back(to);
+		}
+	}
+	return (int32)order.size() == nodeCount;
+}
+
+
+/*! Visits the nodes in reverse topological order, so the reachable set of
+every successor is complete. The successors of a node are visited in
+topological order: a successor can only be reached through one that comes
+before it, so an edge to an already reachable node is implied by the others.
+Fixed orders go first among edges to the same node, so a duplicated fixed
+order makes the candidate redundant and not the other way round. */
+void
+ConstraintPresolver::_ReduceAcyclic(const std::vector<int32>& order)
+{
+	int32 nodeCount = order.size();
+	size_t words = (nodeCount + 31) / 32;
+	std::vector<uint32> reachable(nodeCount * words, 0);
+
+	std::vector<int32> position(nodeCount);
+	for (int32 i = 0; i < nodeCount; i++)
+		position[order[i]] = i;
+
+	// (2 * position of the upper node + 1 for candidates, edge index)
+	std::vector<std::pair<int32, int32> > successors;
+	for (int32 i = nodeCount - 1; i >= 0; i--) {
+		int32 node = order[i];
+		successors.clear();
+		for (int32 e = fFirstOutgoing[node]; e < fFirstOutgoing[node + 1];
+			e++) {
+			const edge& current = fEdges[fOutgoing[e]];
+			int32 key = 2 * position[current.to]
+				+ (current.candidate >= 0 ? 1 : 0);
+			successors.push_back(std::make_pair(key, fOutgoing[e]));
+		}
+		std::sort(successors.begin(), successors.end());
+
+		uint32* nodeReachable = &reachable[node * words];
+		for (unsigned int s = 0; s < successors.size(); s++) {
+			edge& current = fEdges[successors[s].second];
+			int32 to = current.to;
+			if ((nodeReachable[to / 32] & (1u << (to % 32))) != 0) {
+				if (current.candidate >= 0)
+					_Remove(current);
+				continue;
+			}
+
+			nodeReachable[to / 32] |= 1u << (to % 32);
+			const uint32* toReachable = &reachable[to * words];
+			for (size_t w = 0; w < words; w++)
+				nodeReachable[w] |= toReachable[w];
+		}
+	}
+}
+
+
+//! Checks the candidates one by one, the last one added first.
+void
+ConstraintPresolver::_ReduceCyclic(int32 nodeCount)
+{
+	fVisited.assign(nodeCount, 0);
+	fGeneration = 0;
+	for (int32 i = fEdges.size() - 1; i >= 0; i--) {
+		edge& current = fEdges[i];
+		if (current.candidate < 0 || current.removed)
+			continue;
+		if (_HasPath(current.from, current.to, i))
+			_Remove(current);
+	}
+}
+
+
+bool
+ConstraintPresolver::_HasPath(int32 from, int32 to, int32 ignoreEdge)
+{
+	fGeneration++;
+	fStack.clear();
+	fStack.push_back(from);
+	fVisited[from] = fGeneration;
+	while (!fStack.empty()) {
+		int32 node = fStack.back();
+		fStack.pop_back();
+		if (node == to)
+			return true;
+
+		for (int32 e = fFirstOutgoing[node]; e < fFirstOutgoing[node + 1];
+			e++) {
+			const edge& current = fEdges[fOutgoing[e]];
+			if (current.removed || fOutgoing[e] == ignoreEdge)
+				continue;
+			if (fVisited[current.to] != fGeneration) {
+				fVisited[current.to] = fGeneration;
+				fStack.push_back(current.to);
+			}
+		}
+	}
+	return false;
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2012, Clemens Zeidler <haiku@clemens-zeidler.de>
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef	CONSTRAINT_PRESOLVER_H
+#define	CONSTRAINT_PRESOLVER_H
+
+
+#include <vector>
+
+#include <HashMap.h>
+
+#include "Constraint.h"
+
+
+namespace BALM {
+
+
+/*! Finds redundant difference constraints (lower <= upper) before they are
+handed to the solver.
+
+Variables that are tied together by an equality (a == b) are coalesced into one
+node. Fixed orders are constraints that stay in the specification anyway, e.g.
+the minimum size constraints of the areas. Candidates are the constraints the
+caller could drop. A candidate is redundant if its variables have been
+coalesced or if the order is implied by a path of other, still remaining
+constraints (transitive reduction). Only constraints with a zero right side
+are handled, so a path always implies the dropped constraint.
+
+If the orders have no cycle the reduction is one pass in reverse topological
+order, which collects the reachable variables of every variable. Otherwise
+every candidate is checked by a search over the remaining orders. */
+class ConstraintPresolver {
+public:
+								ConstraintPresolver();
+
+			void				AddEquality(Variable* var1, Variable* var2);
+			void				AddFixedOrder(Variable* lower, Variable* upper);
+			//! Returns the index of the candidate.
+			int32				AddCandidate(Variable* lower, Variable* upper);
+
+			/*! Adds a hard constraint of the form c * var1 - c * var2 op 0 as
+			equality or fixed order. Returns false if the constraint has
+			another form. */
+			bool				AddConstraint(Constraint* constraint);
+
+			void				Run();
+
+			bool				IsRedundant(int32 candidate) const;
+			//! Number of candidates found redundant by the last Run().
+			int32				CountEliminatedRows() const;
+			//! Number of variables merged into another one.
+			int32				CountCoalescedVariables() const;
+
+private:
+			typedef HashMap<HashKeyPointer<Variable*>, Variable*> ParentMap;
+			typedef HashMap<HashKeyPointer<Variable*>, int32> NodeMap;
+
+			struct edge {
+				Variable*		lower;
+				Variable*		upper;
+				//! Node indices of lower and upper, set by Run().
+				int32			from;
+				int32			to;
+				int32			candidate;
+				bool			removed;
+			};
+
+			Variable*			_Find(Variable* var);
+			int32				_NodeIndex(Variable* var);
+			void				_Remove(edge& current);
+
+			void				_BuildOutgoing(int32 nodeCount);
+			bool				_SortTopologically(int32 nodeCount,
+									std::vector<int32>& order);
+			void				_ReduceAcyclic(const std::vector<int32>& order);
+			void				_ReduceCyclic(int32 nodeCount);
+			bool				_HasPath(int32 from, int32 to,
+									int32 ignoreEdge);
+
+			ParentMap			fParents;
+			NodeMap				fNodes;
+			std::vector<edge>	fEdges;
+			//! The outgoing edges of node n are fOutgoing[fFirstOutgoing[n]]
+			//! up to fOutgoing[fFirstOutgoing[n + 1]].
+			std::vector<int32>	fFirstOutgoing;
+			std::vector<int32>	fOutgoing;
+			//! Search state of _HasPath(), reused for all candidates.
+			std::vector<int32>	fVisited;
+			std::vector<int32>	fStack;
+			int32				fGeneration;
+			std::vector<bool>	fRedundant;
+			int32				fEliminatedRows;
+			int32				fCoalescedVariables;
+};
+
+
+}	// namespace BALM
+
+
+using BALM::ConstraintPresolver;
+
+
+#endif	// CONSTRAINT_PRESOLVER_H
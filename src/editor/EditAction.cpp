@@ -175,19 +175,19 @@ InsertionIntoEmptyArea::Draw()
 	area_ref ref = fEmptyArea.to_ref(fView->Layout());
 	BRect outerFrame = availableAreaRef.Frame();
 	if (ref.left != NULL) {
-		fView->StrokeLine(BPoint(ref.left->Value(), outerFrame.top),
+		fView->StrokeOverlayLine(BPoint(ref.left->Value(), outerFrame.top),
 			BPoint(ref.left->Value(), outerFrame.bottom));
 	}
 	if (ref.right != NULL) {
-		fView->StrokeLine(BPoint(ref.right->Value(), outerFrame.top),
+		fView->StrokeOverlayLine(BPoint(ref.right->Value(), outerFrame.top),
 			BPoint(ref.right->Value(), outerFrame.bottom));
 	}
 	if (ref.top != NULL) {
-		fView->StrokeLine(BPoint(outerFrame.left, ref.top->Value()),
+		fView->StrokeOverlayLine(BPoint(outerFrame.left, ref.top->Value()),
 			BPoint(outerFrame.right, ref.top->Value()));
 	}
 	if (ref.bottom != NULL) {
-		fView->StrokeLine(BPoint(outerFrame.left, ref.bottom->Value()),
+		fView->StrokeOverlayLine(BPoint(outerFrame.left, ref.bottom->Value()),
 			BPoint(outerFrame.right, ref.bottom->Value()));
 	}	
 
@@ -403,7 +403,7 @@ void
 InsertionIntoEmptyArea::MaximizeEmptyArea(area_ref& ref, BRect target, BRect ignore)
 {
 	BALMLayout* layout = fView->Layout();
-	BRegion takenSpace = fView->fTakenSpace;
+	BRegion takenSpace = fView->_TakenSpace();
 	takenSpace.Exclude(ignore);
 	area_info areaInfo(ref, layout);
 	// try to match the target
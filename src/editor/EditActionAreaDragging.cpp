@@ -176,7 +176,7 @@ LayoutEditView::DragState::Draw(BRect updateRect)
 	fView->SetPenSize(1);
 	rgb_color color = {100, 100, 100};
 	fView->SetHighColor(color);
-	fView->StrokeRect(fDragFrame);
+	fView->StrokeOverlayRect(fDragFrame);
 }
 
 
@@ -277,6 +277,15 @@ public:
 		}
 	}
 
+	virtual ~CreateAndInsertState()
+	{
+		// the component was dragged around but never inserted
+		if (!fPerformed && fNewComponent.Get() != NULL) {
+			CustomizableRoster::DefaultRoster()->RecycleCustomizable(
+				fNewComponent);
+		}
+	}
+
 private:
 			BString				fComponent;
 };
@@ -294,7 +294,7 @@ LayoutEditView::ResizeState::MouseMoved(BPoint point, uint32 transit,
 				BRect increase(ceilf(xTab->Value()), ceilf(areaFrame.top),
 					floorf(areaFrame.left),	floorf(areaFrame.bottom));
 				increase.InsetBy(1, 1);
-				if (fView->fTakenSpace.Intersects(increase) == false)
+				if (fView->_TakenSpace().Intersects(increase) == false)
 					fMouseOverXTab = layout->IndexOf(xTab, true);
 			} else {
 #if RESIZE_TO_TABS_IN_AREA
@@ -310,7 +310,7 @@ LayoutEditView::ResizeState::MouseMoved(BPoint point, uint32 transit,
 				BRect increase(ceilf(areaFrame.right), ceilf(areaFrame.top),
 					floorf(xTab->Value()), floorf(areaFrame.bottom));
 				increase.InsetBy(1, 1);
-				if (fView->fTakenSpace.Intersects(increase) == false)
+				if (fView->_TakenSpace().Intersects(increase) == false)
 					fMouseOverXTab = layout->IndexOf(xTab, true);
 			} else {
 #if RESIZE_TO_TABS_IN_AREA
@@ -329,7 +329,7 @@ LayoutEditView::ResizeState::MouseMoved(BPoint point, uint32 transit,
 				BRect increase(ceilf(areaFrame.left), ceilf(yTab->Value()),
 					floorf(areaFrame.right), floorf(areaFrame.top));
 				increase.InsetBy(1, 1);
-				if (fView->fTakenSpace.Intersects(increase) == false)
+				if (fView->_TakenSpace().Intersects(increase) == false)
 					fMouseOverYTab = layout->IndexOf(yTab, true);
 			} else {
 #if RESIZE_TO_TABS_IN_AREA
@@ -345,7 +345,7 @@ LayoutEditView::ResizeState::MouseMoved(BPoint point, uint32 transit,
 				BRect increase(ceilf(areaFrame.left), ceilf(areaFrame.bottom),
 					floorf(areaFrame.right), floorf(yTab->Value()));
 				increase.InsetBy(1, 1);
-				if (fView->fTakenSpace.Intersects(increase) == false)
+				if (fView->_TakenSpace().Intersects(increase) == false)
 					fMouseOverYTab = layout->IndexOf(yTab, true);
 			} else {
 #if RESIZE_TO_TABS_IN_AREA
@@ -503,12 +503,12 @@ LayoutEditView::ResizeState::Draw(BRect updateRect)
 	fView->SetHighColor(kSuggestionColor);
 	if (fHardResizeToX > 0) {
 		BRect frame = fSelectedArea->Frame();
-		fView->StrokeLine(BPoint(fHardResizeToX, frame.top),
+		fView->StrokeOverlayLine(BPoint(fHardResizeToX, frame.top),
 			BPoint(fHardResizeToX, frame.bottom));
 	}
 	if (fHardResizeToY > 0) {
 		BRect frame = fSelectedArea->Frame();
-		fView->StrokeLine(BPoint(frame.left, fHardResizeToY),
+		fView->StrokeOverlayLine(BPoint(frame.left, fHardResizeToY),
 			BPoint(frame.right, fHardResizeToY));
 	}
 }
@@ -527,9 +527,10 @@ LayoutEditView::ResizeState::_DrawXResizeTabs()
 		if (tabPosition >= frame.left && tabPosition <= frame.right) {
 			fView->SetPenSize(kTabWidth);
 			fView->SetHighColor(kSuggestionColor);
-			fView->StrokeLine(BPoint(tabPosition, 0), BPoint(tabPosition,
-				frame.top - kTabWidth / 2));
-			fView->StrokeLine(BPoint(tabPosition, frame.bottom + kTabWidth / 2),
+			fView->StrokeOverlayLine(BPoint(tabPosition, 0),
+				BPoint(tabPosition, frame.top - kTabWidth / 2));
+			fView->StrokeOverlayLine(
+				BPoint(tabPosition, frame.bottom + kTabWidth / 2),
 				BPoint(tabPosition, fView->Bounds().Height() - kTabWidth / 2));
 		} else
 			fView->DrawTab(tab, kTabWidth, kSuggestionColor);
@@ -551,9 +552,10 @@ LayoutEditView::ResizeState::_DrawYResizeTabs()
 		if (tabPosition >= frame.top && tabPosition <= frame.bottom) {
 			fView->SetPenSize(kTabWidth);
 			fView->SetHighColor(kSuggestionColor);
-			fView->StrokeLine(BPoint(0, tabPosition),
+			fView->StrokeOverlayLine(BPoint(0, tabPosition),
 				BPoint(frame.left - kTabWidth / 2, tabPosition));
-			fView->StrokeLine(BPoint(frame.right + kTabWidth / 2, tabPosition),
+			fView->StrokeOverlayLine(
+				BPoint(frame.right + kTabWidth / 2, tabPosition),
 				BPoint(fView->Bounds().Width() - kTabWidth / 2, tabPosition));
 		} else
 			fView->DrawTab(tab, kTabWidth, kSuggestionColor);
@@ -307,7 +307,7 @@ public:
 				increase.left = ceilf(xTab->Value());
 				increase.right = floorf(selectedTab->Value());
 				increase.InsetBy(1, 1);
-				if (fView->fTakenSpace.Intersects(increase) == true)
+				if (fView->_TakenSpace().Intersects(increase) == true)
 					xTab = NULL;
 			} else if (xTab->Value() >= GroupDetection::LeftmostRight(
 				fAreaGroup)->Value())
@@ -317,7 +317,7 @@ public:
 				increase.left = ceilf(selectedTab->Value());
 				increase.right = floorf(xTab->Value());
 				increase.InsetBy(1, 1);
-				if (fView->fTakenSpace.Intersects(increase) == true)
+				if (fView->_TakenSpace().Intersects(increase) == true)
 					xTab = NULL;
 			} else if (xTab->Value() <= GroupDetection::RightmostLeft(
 				fAreaGroup)->Value())
@@ -357,7 +357,7 @@ public:
 		fView->DrawTab(selectedTab, 2, kSelectedColor);
 
 		if (fDetach) {
-			fView->StrokeLine(BPoint(fLastPoint.x,
+			fView->StrokeOverlayLine(BPoint(fLastPoint.x,
 				fView->fALMEngine->Top()->Value()),
 				BPoint(fLastPoint.x, fView->fALMEngine->Bottom()->Value()));	
 		} else {
@@ -461,7 +461,7 @@ public:
 				increase.top = ceilf(yTab->Value());
 				increase.bottom = floorf(selectedTab->Value());
 				increase.InsetBy(1, 1);
-				if (fView->fTakenSpace.Intersects(increase) == true)
+				if (fView->_TakenSpace().Intersects(increase) == true)
 					yTab = NULL;
 			} else if (yTab->Value() >= GroupDetection::TopmostBottom(
 				fAreaGroup)->Value())
@@ -471,7 +471,7 @@ public:
 				increase.top = ceilf(selectedTab->Value());
 				increase.bottom = floorf(yTab->Value());
 				increase.InsetBy(1, 1);
-				if (fView->fTakenSpace.Intersects(increase) == true)
+				if (fView->_TakenSpace().Intersects(increase) == true)
 					yTab = NULL;
 			} else if (yTab->Value() <= GroupDetection::BottommostTop(
 				fAreaGroup)->Value())
@@ -511,7 +511,7 @@ public:
 		fView->DrawTab(selectedTab, 2, kSelectedColor);
 
 		if (fDetach) {
-			fView->StrokeLine(BPoint(fView->fALMEngine->Left()->Value(),
+			fView->StrokeOverlayLine(BPoint(fView->fALMEngine->Left()->Value(),
 				fLastPoint.y),
 				BPoint(fView->fALMEngine->Right()->Value(), fLastPoint.y));
 		} else {
@@ -6,42 +6,91 @@
 
 #include "EditAnimation.h"
 
-#include <Messenger.h>
+#include "LayoutEditView.h"
 
 
 using namespace BALM;
 
 
-const int32 kMsgAnimate = '&Ani';
+const bigtime_t kAnimationDuration = 160000;
 
 
-EditAnimation::area_animation::area_animation(Area* a)
-	:
-	area(a)
+namespace {
+
+
+typedef HashMap<HashKeyPointer<Variable*>, float> TabValues;
+typedef HashMap<HashKeyPointer<Variable*>, bool> TabSet;
+
+
+template<class Type>
+bool
+TabMoved(Type* tab, const TabValues& capturedValues)
+{
+	float* value;
+	if (!capturedValues.Get(tab, value))
+		return false;
+	return *value != tab->Value();
+}
+
+
+template<class Type>
+void
+AddMovedTab(Type* tab, const TabValues& capturedValues, TabSet& addedTabs,
+	std::vector<BReference<Type> >& tabs, std::vector<float>& startValues,
+	std::vector<float>& deltas)
 {
-	startRect = area->Frame();
+	if (!TabMoved(tab, capturedValues))
+		return;
+	if (addedTabs.ContainsKey(tab))
+		return;
+	addedTabs.Put(tab, true);
+	float start = capturedValues.Get(tab);
+	tabs.push_back(BReference<Type>(tab));
+	startValues.push_back(start);
+	deltas.push_back(tab->Value() - start);
+}
+
+
 }
 
 
-EditAnimation::EditAnimation(BALMLayout* layout, BView* view)
+EditAnimation::EditAnimation(BALMLayout* layout, LayoutEditView* view,
+	FrameScheduler* scheduler)
 	:
 	fLayout(layout),
 	fView(view),
-	fStopped(false)
+	fScheduler(scheduler),
+	fRunning(false),
+	fStartTime(0),
+	fDuration(kAnimationDuration)
+{
+}
+
+
+EditAnimation::~EditAnimation()
 {
+	Cancel();
 }
 
 
 void
 EditAnimation::CaptureStartpoint()
 {
-	Cancel();
+	// Start from where a running animation is right now, the next Animate()
+	// call retargets it.
+	if (fRunning)
+		_SetTabs(_Progress(system_time()));
 
-	fAnimationList.MakeEmpty();
+	fCapturedAreas.Clear();
+	fCapturedValues.Clear();
 
 	for (int32 i = 0; i < fLayout->CountAreas(); i++) {
 		Area* area = fLayout->AreaAt(i);
-		fAnimationList.AddItem(area_animation(area));
+		fCapturedAreas.Put(area, i);
+		fCapturedValues.Put(area->Left(), area->Left()->Value());
+		fCapturedValues.Put(area->Top(), area->Top()->Value());
+		fCapturedValues.Put(area->Right(), area->Right()->Value());
+		fCapturedValues.Put(area->Bottom(), area->Bottom()->Value());
 	}
 }
 
@@ -49,42 +98,68 @@ EditAnimation::CaptureStartpoint()
 bool
 EditAnimation::Animate()
 {
-	if (fLayout->CountAreas() <= 1)
+	if (fLayout->CountAreas() <= 1) {
+		Cancel();
 		return true;
+	}
+
+	fXTabs.clear();
+	fYTabs.clear();
+	fMovedAreas.clear();
 
+	TabSet addedTabs;
+	std::vector<float> xStartValues;
+	std::vector<float> xDeltas;
+	std::vector<float> yStartValues;
+	std::vector<float> yDeltas;
 	for (int32 i = 0; i < fLayout->CountAreas(); i++) {
 		Area* area = fLayout->AreaAt(i);
-		area_animation* animation;
-		if (!_FindAnimation(area, &animation)) {
+		if (!fCapturedAreas.ContainsKey(area)) {
 			// probably a new area just set it to its final position, this
 			// speeds up the insertion operation
 			_LayoutArea(area);
 			continue;
 		}
-		
-		// calculate animation
-		BRect endRect = area->Frame();
-		animation->translation.x = endRect.left - animation->startRect.left;
-		animation->translation.y = endRect.top - animation->startRect.top;
 
-		animation->scale.x = endRect.Width() - animation->startRect.Width();
-		animation->scale.y = endRect.Height() - animation->startRect.Height();
+		if (!TabMoved(area->Left(), fCapturedValues)
+			&& !TabMoved(area->Top(), fCapturedValues)
+			&& !TabMoved(area->Right(), fCapturedValues)
+			&& !TabMoved(area->Bottom(), fCapturedValues))
+			continue;
+		fMovedAreas.push_back(area);
+
+		AddMovedTab(area->Left(), fCapturedValues, addedTabs, fXTabs,
+			xStartValues, xDeltas);
+		AddMovedTab(area->Right(), fCapturedValues, addedTabs, fXTabs,
+			xStartValues, xDeltas);
+		AddMovedTab(area->Top(), fCapturedValues, addedTabs, fYTabs,
+			yStartValues, yDeltas);
+		AddMovedTab(area->Bottom(), fCapturedValues, addedTabs, fYTabs,
+			yStartValues, yDeltas);
 	}
 
+	fStartValues = xStartValues;
+	fStartValues.insert(fStartValues.end(), yStartValues.begin(),
+		yStartValues.end());
+	fDeltas = xDeltas;
+	fDeltas.insert(fDeltas.end(), yDeltas.begin(), yDeltas.end());
+	fValues.resize(fStartValues.size());
+	_IndexMovedAreas();
+
 	// set areas to start point
-	_SetAreas(0.0);
+	_SetTabs(0.0);
 
-	fStopped = false;
-	// start timer
-	fDuration = 160000;
-	fFramesPerSec = 25;
+	fStartTime = system_time();
+	if (fRunning)
+		return true;
 
 	fLayout->DisableLayoutInvalidation();
-
-	thread_id id = spawn_thread(_TimerThread, "timer", B_DISPLAY_PRIORITY,
-		(void*)this);
-	resume_thread(id);
-	
+	fRunning = true;
+	if (!fScheduler->AddClient(this)) {
+		// not attached to a looper, there is nothing to animate
+		Cancel();
+		return false;
+	}
 	return true;
 }
 
@@ -92,109 +167,127 @@ EditAnimation::Animate()
 void
 EditAnimation::Cancel()
 {
-	fStopped = true;
+	if (!fRunning)
+		return;
+	fScheduler->RemoveClient(this);
+	// the layout invalidation moves all areas to their final position
+	_Finish();
+}
+
+
+bool
+EditAnimation::IsRunning() const
+{
+	return fRunning;
 }
 
 
 void
-EditAnimation::MessageReceived(BMessage* message)
-{
-	switch (message->what) {
-	case kMsgAnimate:
-	{
-		float progress = message->FindFloat("progress");
-		_SetAreas(progress);
-		if (progress == 1) {
-			fLayout->EnableLayoutInvalidation();
-			fLayout->InvalidateLayout();
-		}
-		break;
-	}
+EditAnimation::LayoutChanged()
+{
+	if (fMovedAreas.empty())
+		return;
 
-	default:
-		BHandler::MessageReceived(message);
+	// one pass over the layout, the frames don't have to check the areas
+	std::vector<Area*> areas;
+	areas.reserve(fMovedAreas.size());
+	for (int32 i = 0; i < fLayout->CountAreas(); i++) {
+		Area* area = fLayout->AreaAt(i);
+		if (fMovedIndex.ContainsKey(area))
+			areas.push_back(area);
 	}
+	if (areas.size() == fMovedAreas.size())
+		return;
+
+	fMovedAreas.swap(areas);
+	_IndexMovedAreas();
 }
 
 
 bool
-EditAnimation::_FindAnimation(Area* area, area_animation** animation)
+EditAnimation::AnimateFrame(bigtime_t time)
 {
-	for (int32 i = 0; i < fAnimationList.CountItems(); i++) {
-		area_animation& ani = fAnimationList.ItemAt(i);
-		if (ani.area == area) {
-			*animation = &ani;
-			return true;
-		}
-	}
-	*animation = NULL;
+	float progress = _Progress(time);
+	_SetTabs(progress);
+	if (progress < 1)
+		return true;
+
+	_Finish();
 	return false;
 }
 
 
-int32
-EditAnimation::_TimerThread(void* cookie)
+float
+EditAnimation::_Progress(bigtime_t time) const
 {
-	EditAnimation* that = (EditAnimation*)cookie;
+	// Calculated from the time and not from the number of frames, late
+	// frames just skip some steps.
+	float progress = float(time - fStartTime) / fDuration;
+	if (progress > 1)
+		return 1;
+	if (progress < 0)
+		return 0;
+	return progress;
+}
 
-	BMessenger messenger(that);
-	bigtime_t snoozeTime = 1000000 / (that->fFramesPerSec - 1);
-	bigtime_t elapsed = 0;
-	bigtime_t endTime = that->fDuration;
-	while (elapsed < endTime) {
-		snooze(snoozeTime);
-		elapsed += snoozeTime;
 
-		if (that->fStopped)
-			elapsed = endTime;
+void
+EditAnimation::_Finish()
+{
+	fRunning = false;
+	fXTabs.clear();
+	fYTabs.clear();
+	fMovedAreas.clear();
+	fMovedIndex.Clear();
+
+	fLayout->EnableLayoutInvalidation();
+	fLayout->InvalidateLayout();
+}
 
-		BMessage message(kMsgAnimate);
-		float progress = float(elapsed) / endTime;
-		if (progress > 1)
-			progress = 1;
-		message.AddFloat("progress", progress);
-		messenger.SendMessage(&message);
-	}
 
-	return 0;
+void
+EditAnimation::_SetTabs(float progress)
+{
+	// one plain pass over the arrays, the compiler can vectorize it
+	// the old positions have to be redrawn too
+	_MarkMovedDirty();
+
+	const unsigned int count = fValues.size();
+	for (unsigned int i = 0; i < count; i++)
+		fValues[i] = fStartValues[i] + fDeltas[i] * progress;
+
+	const unsigned int nXTabs = fXTabs.size();
+	for (unsigned int i = 0; i < nXTabs; i++)
+		fXTabs[i]->SetValue(fValues[i]);
+	for (unsigned int i = 0; i < fYTabs.size(); i++)
+		fYTabs[i]->SetValue(fValues[nXTabs + i]);
+
+	_LayoutMovedAreas();
+	// only the moved areas and tabs get redrawn
+	_MarkMovedDirty();
+	fView->InvalidateChanges();
 }
 
 
 void
-EditAnimation::_SetAreas(float progress)
+EditAnimation::_LayoutMovedAreas()
 {
-	for (int32 i = 0; i < fAnimationList.CountItems(); i++) {
-		area_animation& ani = fAnimationList.ItemAt(i);
-		Area* area = ani.area;
-		// check if area is still there
-		if (!_ValidateArea(area))
-			continue;
-		BRect targetRect = ani.startRect;
-		targetRect.OffsetBy(ani.translation.x * progress,
-			ani.translation.y * progress);
-		targetRect.right += ani.scale.x * progress;
-		targetRect.bottom += ani.scale.y * progress;
-
-		area->Left()->SetValue(targetRect.left);
-		area->Top()->SetValue(targetRect.top);
-		area->Right()->SetValue(targetRect.right);
-		area->Bottom()->SetValue(targetRect.bottom);
-
-		_LayoutArea(area);
-	}
-	fView->Invalidate();
+	// LayoutChanged() already dropped the removed areas
+	for (unsigned int i = 0; i < fMovedAreas.size(); i++)
+		_LayoutArea(fMovedAreas[i]);
 }
 
 
-bool
-EditAnimation::_ValidateArea(Area* area)
+void
+EditAnimation::_MarkMovedDirty()
 {
-	for (int32 i = 0; i < fLayout->CountAreas(); i++) {
-		Area* a = fLayout->AreaAt(i);
-		if (area == a)
-			return true;
-	}
-	return false;
+	for (unsigned int i = 0; i < fXTabs.size(); i++)
+		fView->MarkDirty(fXTabs[i].Get());
+	for (unsigned int i = 0; i < fYTabs.size(); i++)
+		fView->MarkDirty(fYTabs[i].Get());
+
+	for (unsigned int i = 0; i < fMovedAreas.size(); i++)
+		fView->MarkDirty(fMovedAreas[i]);
 }
 
 
@@ -216,3 +309,12 @@ EditAnimation::_LayoutArea(Area* area)
 			fLayout->LayoutArea().LeftTop()));
 	}
 }
+
+
+void
+EditAnimation::_IndexMovedAreas()
+{
+	fMovedIndex.Clear();
+	for (unsigned int i = 0; i < fMovedAreas.size(); i++)
+		fMovedIndex.Put(fMovedAreas[i], i);
+}
@@ -6,52 +6,81 @@
 #define	EDIT_ANIMATOIN_H
 
 
-#include <ArrayContainer.h>
+#include <vector>
+
 #include <ALMLayout.h>
-#include <Handler.h>
-#include <View.h>
+#include <HashMap.h>
+
+#include "FrameScheduler.h"
 
 
 namespace BALM {
 
 
-class EditAnimation : public BHandler {
+class LayoutEditView;
+
+
+/*! Animates the areas from the positions captured in CaptureStartpoint() to
+their current positions. If CaptureStartpoint() is called while an animation is
+running the current (interpolated) positions are captured and the next
+Animate() call retargets the running animation.
+
+The animation works on tabs and not on areas, so a tab that is shared by
+multiple areas is only interpolated once per frame. The frames only go over the
+moved tabs and areas, LayoutChanged() drops the areas that have been removed
+from the layout. */
+class EditAnimation : public FrameScheduler::Client {
 public:
-								EditAnimation(BALMLayout* layout, BView* view);
+								EditAnimation(BALMLayout* layout,
+									LayoutEditView* view,
+									FrameScheduler* scheduler);
+								~EditAnimation();
 
 			void				CaptureStartpoint();
 			bool				Animate();
 
+			//! Jumps to the end of a running animation.
 			void				Cancel();
+			bool				IsRunning() const;
+			//! Has to be called when areas may have been removed.
+			void				LayoutChanged();
 
-			void				MessageReceived(BMessage* message);
+	virtual	bool				AnimateFrame(bigtime_t time);
 private:
-	struct area_animation {
-		area_animation(Area* area);
-
-		Area*		area;
-		BRect		startRect;
-		BPoint		translation;
-		BPoint		scale;		
-	};
+			float				_Progress(bigtime_t time) const;
+			void				_Finish();
 
-			bool				_FindAnimation(Area* area,
-									area_animation** animation);
-
-	static	int32				_TimerThread(void* cookie);
-
-			void				_SetAreas(float progress);
-			bool				_ValidateArea(Area* area);
+			void				_SetTabs(float progress);
+			void				_LayoutMovedAreas();
+			void				_MarkMovedDirty();
 			void				_LayoutArea(Area* area);
+			void				_IndexMovedAreas();
 private:
-			BALMLayout*			fLayout;
-			BView*				fView;
-			BArray<area_animation>	fAnimationList;
-
-			bool				fStopped;
+			typedef HashMap<HashKeyPointer<Area*>, int32> AreaIndex;
+			typedef HashMap<HashKeyPointer<Variable*>, float> TabValues;
 
+			BALMLayout*			fLayout;
+			LayoutEditView*		fView;
+			FrameScheduler*		fScheduler;
+
+			// start point, the areas and tabs are only used as keys
+			AreaIndex			fCapturedAreas;
+			TabValues			fCapturedValues;
+
+			/* Animated tabs, the x tabs come first in the value arrays. The
+			references keep tabs alive that are removed while animating. */
+			std::vector<BReference<XTab> >	fXTabs;
+			std::vector<BReference<YTab> >	fYTabs;
+			std::vector<float>	fStartValues;
+			std::vector<float>	fDeltas;
+			std::vector<float>	fValues;
+			//! The moved areas, fMovedIndex maps them to their slot.
+			std::vector<Area*>	fMovedAreas;
+			AreaIndex			fMovedIndex;
+
+			bool				fRunning;
+			bigtime_t			fStartTime;
 			bigtime_t			fDuration;
-			int32				fFramesPerSec;
 };
 
 
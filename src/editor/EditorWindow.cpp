@@ -175,7 +175,7 @@ private:
 		BSize size = sizePolicy.Get(fItem);
 		directionPolicy.Set(size, value);
 		sizePolicy.Set(fItem, size);
-		fEditView->Invalidate();
+		fEditView->InvalidateStaticLayer();
 	}
 
 private:
@@ -492,7 +492,7 @@ private:
 			}
 		}
 		if (fEditView->LockLooper()) {
-			fEditView->Invalidate();
+			fEditView->InvalidateStaticLayer();
 			fEditView->UnlockLooper();
 		}
 	}
@@ -728,6 +728,12 @@ EditWindow::_InitializeComponent()
 	fileMenu->AddItem(new BMenuItem("Exit", new BMessage(B_QUIT_REQUESTED)));
 	
 	fMainMenu->AddItem(fileMenu);
+
+	BMenu* debugMenu = new BMenu("Debug");
+	fShowInvalidationItem = new BMenuItem("Show Invalidation",
+		new BMessage(kMsgShowInvalidation));
+	debugMenu->AddItem(fShowInvalidationItem);
+	fMainMenu->AddItem(debugMenu);
 	fMainMenu->SetExplicitAlignment(BAlignment(B_ALIGN_LEFT,
 		B_ALIGN_USE_FULL_HEIGHT));
 
@@ -881,6 +887,17 @@ EditWindow::MessageReceived(BMessage* message)
 				fFreePlacementBox->Value() == B_CONTROL_ON);
 			break;
 
+		case kMsgShowInvalidation:
+		{
+			bool show = !fShowInvalidationItem->IsMarked();
+			fShowInvalidationItem->SetMarked(show);
+			if (fEditView->LockLooper()) {
+				fEditView->SetShowInvalidation(show);
+				fEditView->UnlockLooper();
+			}
+			break;
+		}
+
 		case kMsgLoadDialog:
 			fOpenPanel->Show();
 			break;
@@ -935,7 +952,7 @@ EditWindow::MessageReceived(BMessage* message)
 				archiver.SaveLayout(&archive, true);
 				archiver.SaveToFile(&file, &archive);
 				fEditView->InvalidateLayout();
-				fEditView->Invalidate();
+				fEditView->InvalidateStaticLayer();
 
 				UpdateEditWindow();
 				fEditView->UnlockLooper();
@@ -55,6 +55,7 @@ public:
 	kMsgClearLayout,
 	kMsgLoadLayout,
 	kMsgSaveLayout,
+	kMsgShowInvalidation,
 	};
 	
 public:
@@ -89,6 +90,7 @@ private:
 			BFilePanel*			fSavePanel;
 
 			BMenuBar*			fMainMenu;
+			BMenuItem*			fShowInvalidationItem;
 
 			BView*				fAreaView;
 
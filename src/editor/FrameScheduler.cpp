@@ -0,0 +1,191 @@
+/*
+ * Copyright 2012, Clemens Zeidler <haiku@clemens-zeidler.de>
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "FrameScheduler.h"
+
+#include <Looper.h>
+#include <Messenger.h>
+
+
+using namespace BALM;
+
+
+const uint32 kMsgFrame = '&Frm';
+
+// 60 fps at most
+const bigtime_t kMinFrameInterval = 16666;
+// 15 fps at least, otherwise the animation looks broken
+const bigtime_t kMaxFrameInterval = 66666;
+
+
+FrameScheduler::FrameScheduler()
+	:
+	BHandler("frame scheduler"),
+	fTimer(NULL),
+	fInterval(kMinFrameInterval),
+	fFrameCost(0),
+	fDrawCost(0),
+	fLastFrame(0),
+	fFrames(0),
+	fDroppedFrames(0)
+{
+}
+
+
+FrameScheduler::~FrameScheduler()
+{
+	_StopTimer();
+}
+
+
+bool
+FrameScheduler::AddClient(Client* client)
+{
+	if (fClients.HasItem(client))
+		return true;
+	if (Looper() == NULL)
+		return false;
+	if (!fClients.AddItem(client))
+		return false;
+
+	if (fTimer == NULL) {
+		BMessage message(kMsgFrame);
+		fTimer = new BMessageRunner(BMessenger(this), &message, fInterval);
+		fLastFrame = system_time();
+	}
+	return true;
+}
+
+
+void
+FrameScheduler::RemoveClient(Client* client)
+{
+	fClients.RemoveItem(client);
+	if (fClients.CountItems() == 0)
+		_StopTimer();
+}
+
+
+bool
+FrameScheduler::HasClient(Client* client) const
+{
+	return fClients.HasItem(client);
+}
+
+
+void
+FrameScheduler::ReportDrawCost(bigtime_t cost)
+{
+	// only the draw cost during an animation is of interest
+	if (fTimer == NULL)
+		return;
+	fDrawCost = (fDrawCost * 3 + cost) / 4;
+	_UpdateInterval();
+}
+
+
+bigtime_t
+FrameScheduler::FrameInterval() const
+{
+	return fInterval;
+}
+
+
+bigtime_t
+FrameScheduler::AverageFrameCost() const
+{
+	return fFrameCost + fDrawCost;
+}
+
+
+int32
+FrameScheduler::CountFrames() const
+{
+	return fFrames;
+}
+
+
+int32
+FrameScheduler::CountDroppedFrames() const
+{
+	return fDroppedFrames;
+}
+
+
+void
+FrameScheduler::MessageReceived(BMessage* message)
+{
+	switch (message->what) {
+	case kMsgFrame:
+		_Frame();
+		break;
+
+	default:
+		BHandler::MessageReceived(message);
+	}
+}
+
+
+void
+FrameScheduler::_Frame()
+{
+	if (fTimer == NULL)
+		return;
+
+	bigtime_t now = system_time();
+	bigtime_t sinceLastFrame = now - fLastFrame;
+	// The timer messages queue up when the looper is busy, only handle the
+	// first one of such a burst.
+	if (sinceLastFrame < fInterval / 2)
+		return;
+	if (sinceLastFrame >= fInterval * 3 / 2)
+		fDroppedFrames += sinceLastFrame / fInterval - 1;
+	fLastFrame = now;
+	fFrames++;
+
+	for (int32 i = fClients.CountItems() - 1; i >= 0; i--) {
+		Client* client = fClients.ItemAt(i);
+		if (!client->AnimateFrame(now))
+			fClients.RemoveItemAt(i);
+	}
+
+	// exponential moving average of the frame cost
+	bigtime_t cost = system_time() - now;
+	fFrameCost = (fFrameCost * 3 + cost) / 4;
+
+	if (fClients.CountItems() == 0) {
+		_StopTimer();
+		return;
+	}
+	_UpdateInterval();
+}
+
+
+void
+FrameScheduler::_UpdateInterval()
+{
+	// leave the looper some time for other messages
+	bigtime_t interval = AverageFrameCost() * 2;
+	if (interval < kMinFrameInterval)
+		interval = kMinFrameInterval;
+	else if (interval > kMaxFrameInterval)
+		interval = kMaxFrameInterval;
+
+	// avoid resetting the timer for small changes
+	if (interval > fInterval * 3 / 4 && interval < fInterval * 5 / 4)
+		return;
+	fInterval = interval;
+	if (fTimer != NULL)
+		fTimer->SetInterval(fInterval);
+}
+
+
+void
+FrameScheduler::_StopTimer()
+{
+	delete fTimer;
+	fTimer = NULL;
+}
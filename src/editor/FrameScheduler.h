@@ -0,0 +1,77 @@
+/*
+ * Copyright 2012, Clemens Zeidler <haiku@clemens-zeidler.de>
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef	FRAME_SCHEDULER_H
+#define	FRAME_SCHEDULER_H
+
+
+#include <Handler.h>
+#include <MessageRunner.h>
+#include <ObjectList.h>
+
+
+namespace BALM {
+
+
+/*! Drives all editor animations from one timer. The frame interval adapts to
+the measured cost of a frame, i.e. the time the clients need plus the draw time
+reported by the view. Clients get the current time on each frame and should
+calculate their state from it. In this way frames are simply skipped when the
+scheduler falls behind.
+
+The scheduler has to be added to the looper of the animated view. */
+class FrameScheduler : public BHandler {
+public:
+	class Client {
+	public:
+		virtual					~Client() {}
+
+		/*! Returns false if the client needs no further frames. The client
+		must not call RemoveClient() from here. */
+		virtual	bool			AnimateFrame(bigtime_t time) = 0;
+	};
+
+								FrameScheduler();
+								~FrameScheduler();
+
+			bool				AddClient(Client* client);
+			void				RemoveClient(Client* client);
+			bool				HasClient(Client* client) const;
+
+			//! Should be called by the view with the time it needed to draw.
+			void				ReportDrawCost(bigtime_t cost);
+
+			bigtime_t			FrameInterval() const;
+			bigtime_t			AverageFrameCost() const;
+			int32				CountFrames() const;
+			//! Frames that have been skipped because a frame came too late.
+			int32				CountDroppedFrames() const;
+
+	virtual	void				MessageReceived(BMessage* message);
+
+private:
+			void				_Frame();
+			void				_UpdateInterval();
+			void				_StopTimer();
+
+			BObjectList<Client>	fClients;
+			BMessageRunner*		fTimer;
+
+			bigtime_t			fInterval;
+			bigtime_t			fFrameCost;
+			bigtime_t			fDrawCost;
+			bigtime_t			fLastFrame;
+
+			int32				fFrames;
+			int32				fDroppedFrames;
+};
+
+
+}	// namespace BALM
+
+
+using BALM::FrameScheduler;
+
+
+#endif	// FRAME_SCHEDULER_H
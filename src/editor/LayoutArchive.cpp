@@ -124,22 +124,10 @@ LayoutArchive::SaveLayout(BMessage* archive, bool saveComponent) const
 		if (saveComponent)
 			_SaveComponent(area, archive);
 
-		if (area->Left() == fLayout->Left())
-			archive->AddInt32("left", kLeftBorderIndex);
-		else
-			archive->AddInt32("left", xTabs.IndexOf(area->Left()));
-		if (area->Top() == fLayout->Top())
-			archive->AddInt32("top", kTopBorderIndex);
-		else
-			archive->AddInt32("top", yTabs.IndexOf(area->Top()));
-		if (area->Right() == fLayout->Right())
-			archive->AddInt32("right", kRightBorderIndex);
-		else
-			archive->AddInt32("right", xTabs.IndexOf(area->Right()));
-		if (area->Bottom() == fLayout->Bottom())
-			archive->AddInt32("bottom", kBottomBorderIndex);
-		else
-			archive->AddInt32("bottom", yTabs.IndexOf(area->Bottom()));
+		archive->AddInt32("left", _TabIndex(area->Left(), xTabs));
+		archive->AddInt32("top", _TabIndex(area->Top(), yTabs));
+		archive->AddInt32("right", _TabIndex(area->Right(), xTabs));
+		archive->AddInt32("bottom", _TabIndex(area->Bottom(), yTabs));
 
 		// store values
 		archive->AddFloat("leftValue", area->Left()->Value());
@@ -190,6 +178,73 @@ LayoutArchive::SaveLayout(BMessage* archive, bool saveComponent) const
 }
 
 
+status_t
+LayoutArchive::UpdateTabValues(BMessage* archive) const
+{
+	int32 nXTabs;
+	int32 nYTabs;
+	if (archive->FindInt32("nXTabs", &nXTabs) != B_OK
+		|| archive->FindInt32("nYTabs", &nYTabs) != B_OK)
+		return B_BAD_VALUE;
+	if (nXTabs != fLayout->CountXTabs() || nYTabs != fLayout->CountYTabs())
+		return B_BAD_VALUE;
+
+	int32 nAreas = fLayout->CountAreas();
+	type_code type;
+	int32 count;
+	if (archive->GetInfo("leftValue", &type, &count) != B_OK) {
+		if (nAreas != 0)
+			return B_BAD_VALUE;
+		count = 0;
+	}
+	if (count != nAreas)
+		return B_BAD_VALUE;
+
+	// The counts can match while areas or tabs have been exchanged, the
+	// values are only replaced if every area is still the same component
+	// between the same tabs.
+	XTabList xTabs = fLayout->GetXTabs();
+	xTabs.RemoveItem(fLayout->Left());
+	xTabs.RemoveItem(fLayout->Right());
+	YTabList yTabs = fLayout->GetYTabs();
+	yTabs.RemoveItem(fLayout->Top());
+	yTabs.RemoveItem(fLayout->Bottom());
+
+	for (int32 i = 0; i < nAreas; i++) {
+		Area* area = fLayout->AreaAt(i);
+		if (archive->FindInt32("left", i) != _TabIndex(area->Left(), xTabs)
+			|| archive->FindInt32("top", i) != _TabIndex(area->Top(), yTabs)
+			|| archive->FindInt32("right", i)
+				!= _TabIndex(area->Right(), xTabs)
+			|| archive->FindInt32("bottom", i)
+				!= _TabIndex(area->Bottom(), yTabs))
+			return B_BAD_VALUE;
+
+		BMessage componentData;
+		if (archive->FindMessage("component", i, &componentData) != B_OK)
+			continue;
+		CustomizableView* customizable = dynamic_cast<CustomizableView*>(
+			area->Item()->View());
+		if (customizable == NULL)
+			customizable = dynamic_cast<CustomizableView*>(area->Item());
+		BString identifier;
+		if (customizable != NULL)
+			identifier = customizable->Identifier();
+		if (identifier != componentData.FindString("identifier"))
+			return B_BAD_VALUE;
+	}
+
+	for (int32 i = 0; i < nAreas; i++) {
+		Area* area = fLayout->AreaAt(i);
+		archive->ReplaceFloat("leftValue", i, area->Left()->Value());
+		archive->ReplaceFloat("rightValue", i, area->Right()->Value());
+		archive->ReplaceFloat("topValue", i, area->Top()->Value());
+		archive->ReplaceFloat("bottomValue", i, area->Bottom()->Value());
+	}
+	return B_OK;
+}
+
+
 status_t
 LayoutArchive::RestoreLayout(const BMessage* archive, bool restoreComponents)
 {
@@ -477,6 +532,29 @@ LayoutArchive::_RestoreArea(Area* area, int32 i, const BMessage* archive,
 }
 
 
+//! The index as it is archived, the borders have their own indices.
+int32
+LayoutArchive::_TabIndex(XTab* tab, const XTabList& xTabs) const
+{
+	if (tab == fLayout->Left())
+		return kLeftBorderIndex;
+	if (tab == fLayout->Right())
+		return kRightBorderIndex;
+	return xTabs.IndexOf(tab);
+}
+
+
+int32
+LayoutArchive::_TabIndex(YTab* tab, const YTabList& yTabs) const
+{
+	if (tab == fLayout->Top())
+		return kTopBorderIndex;
+	if (tab == fLayout->Bottom())
+		return kBottomBorderIndex;
+	return yTabs.IndexOf(tab);
+}
+
+
 bool	
 LayoutArchive::_SaveComponent(Area* area, BMessage* archive) const
 {
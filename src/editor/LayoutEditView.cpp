@@ -11,9 +11,15 @@
 #include <Cursor.h>
 #include <Looper.h>
 #include <Message.h>
+#include <Messenger.h>
 #include <Region.h>
 #include <Size.h>
 
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+
 #include <AutoDeleter.h>
 
 #include "ALMEditor.h"
@@ -86,9 +92,14 @@ private:
 
 
 const float kEnlargedAreaInset = 3;
+// the area border plus the 5 pixel temp constraint marks
+const float kDirtyAreaInset = 7;
 
 const uint32 kMsgUndo = '&Udo';
 const uint32 kMsgRedo = '&Rdo';
+const uint32 kMsgResizeSettled = '&Rsz';
+
+const bigtime_t kResizeSettleDelay = 250000;
 
 
 LayoutEditView::LayoutEditView(BALMEditor* editor)
@@ -112,10 +123,26 @@ LayoutEditView::LayoutEditView(BALMEditor* editor)
 
 	fState(NULL),
 
+	fTakenSpaceValid(false),
+	fResizeRunner(NULL),
+	fLastResize(0),
+
 	fOverlapManager(editor->GetOverlapManager()),
-	fEditAnimation(fALMEngine, this)
+	fEditAnimation(fALMEngine, this, &fFrameScheduler),
+
+	fStaticLayer(NULL),
+	fStaticLayerView(NULL),
+	fStaticLayerValid(false),
+	fLayoutGeneration(0),
+	fStaticLayerGeneration(0),
+	fBackgroundGeneration(0),
+	fBackgroundValid(false),
+
+	fMeasuredOverlay(NULL),
+	fShowInvalidation(false)
 {
 	fInformant = new ToolTipInformant(this);
+	memset(&fPaintStatistics, 0, sizeof(fPaintStatistics));
 
 	SetViewColor(B_TRANSPARENT_COLOR);
 	SetExplicitMinSize(BSize(0, 0));
@@ -134,6 +161,8 @@ LayoutEditView::~LayoutEditView()
 
 	delete fInformant;
 	delete fMessageFilter;
+	delete fStaticLayer;
+	delete fResizeRunner;
 }
 
 
@@ -159,7 +188,7 @@ LayoutEditView::AttachedToWindow()
 	if (LockLooper()) {
 		BWindow* window = Window();
 		window->AddCommonFilter(fMessageFilter);
-		window->AddHandler(&fEditAnimation);
+		window->AddHandler(&fFrameScheduler);
 
 		window->AddShortcut('z', 0, new BMessage(kMsgUndo), this);
 		window->AddShortcut('z', B_SHIFT_KEY, new BMessage(kMsgRedo), this);
@@ -176,16 +205,23 @@ LayoutEditView::AttachedToWindow()
 void
 LayoutEditView::DetachedFromWindow()
 {
+	fEditAnimation.Cancel();
+	if (fResizeRunner != NULL)
+		_ResizeSettled();
 	fOverlapManager.DisconnectAreas();
 
 	_SetState(NULL);
 
 	delete fRightClickMenu;
 
+	delete fStaticLayer;
+	fStaticLayer = NULL;
+	fStaticLayerView = NULL;
+
 	if (LockLooper()) {
 		BWindow* window = Window();
 		window->RemoveCommonFilter(fMessageFilter);
-		window->RemoveHandler(&fEditAnimation);
+		window->RemoveHandler(&fFrameScheduler);
 		
 		window->RemoveShortcut('z', 0);
 		window->RemoveShortcut('z', B_SHIFT_KEY);
@@ -226,7 +262,7 @@ void
 LayoutEditView::SetShowXTabs(bool show)
 {
 	fShowXTabs = show;
-	Invalidate();
+	InvalidateStaticLayer();
 }
 
 
@@ -234,13 +270,17 @@ void
 LayoutEditView::SetShowYTabs(bool show)
 {
 	fShowYTabs = show;
-	Invalidate();
+	InvalidateStaticLayer();
 }
 
 
 bool
 LayoutEditView::Undo()
 {
+	// the resized tab values belong to the current history entry
+	if (fResizeRunner != NULL)
+		_ResizeSettled();
+
 	history_entry* entry = fHistory.CurrentEvent();
 	if (entry == NULL)
 		debugger("we have no history!");
@@ -270,7 +310,10 @@ LayoutEditView::Undo()
 	if (window != NULL)
 		window->PostMessage(kMsgLayoutEdited);
 
-	Invalidate();
+	// Any area might have been added, removed or moved and the static layer
+	// is rendered again anyway.
+	fDirtyRegion.Include(Bounds());
+	InvalidateChanges();
 	InvalidateLayout();
 
 	fSelectedArea = NULL;
@@ -283,6 +326,10 @@ LayoutEditView::Undo()
 bool
 LayoutEditView::Redo()
 {
+	// the resized tab values belong to the current history entry
+	if (fResizeRunner != NULL)
+		_ResizeSettled();
+
 	history_entry* entry = fHistory.MoveForward();
 	if (entry == NULL)
 		return false;
@@ -304,11 +351,16 @@ LayoutEditView::Redo()
 		return false;
 	}
 
+	_InvalidateAreaData();
+
 	BWindow* window = Window();
 	if (window != NULL)
 		window->PostMessage(kMsgLayoutEdited);
 
-	Invalidate();
+	// Any area might have been added, removed or moved and the static layer
+	// is rendered again anyway.
+	fDirtyRegion.Include(Bounds());
+	InvalidateChanges();
 	InvalidateLayout();
 
 	fSelectedArea = NULL;
@@ -320,6 +372,9 @@ LayoutEditView::Redo()
 BMessage*
 LayoutEditView::CurrentLayout()
 {
+	// the actions need the tab values after a pending resize
+	if (fResizeRunner != NULL)
+		_ResizeSettled();
 	return &fHistory.CurrentEvent()->layout;
 }
 
@@ -329,6 +384,10 @@ LayoutEditView::PerformAction(EditAction* action)
 {
 	ObjectDeleter<EditAction> actionDeleter(action);
 
+	// the resized tab values belong to the current history entry
+	if (fResizeRunner != NULL)
+		_ResizeSettled();
+
 	fEditAnimation.CaptureStartpoint();
 	// Disable the layout invalidation till we start the animation.
 	fALMEngine->DisableLayoutInvalidation();
@@ -364,7 +423,10 @@ LayoutEditView::PerformAction(EditAction* action)
 	if (window != NULL)
 		window->PostMessage(kMsgLayoutEdited);
 
-	Invalidate();
+	// the moved areas are invalidated by the animation frames, but areas can
+	// also be added or removed
+	fDirtyRegion.Include(Bounds());
+	InvalidateChanges();
 	InvalidateLayout();
 	actionDeleter.Detach();
 	return true;
@@ -443,6 +505,94 @@ LayoutEditView::TrashArea(Area* area)
 }
 
 
+const FrameScheduler*
+LayoutEditView::GetFrameScheduler() const
+{
+	return &fFrameScheduler;
+}
+
+
+void
+LayoutEditView::GetPaintStatistics(paint_statistics& statistics) const
+{
+	statistics = fPaintStatistics;
+}
+
+
+void
+LayoutEditView::InvalidateStaticLayer()
+{
+	fLayoutGeneration++;
+	Invalidate();
+}
+
+
+void
+LayoutEditView::InvalidateChanges()
+{
+	if (Window() == NULL) {
+		fDirtyRegion.MakeEmpty();
+		return;
+	}
+
+	_IncludeOverlayChanges(fDirtyRegion);
+
+	if (fShowInvalidation) {
+		BRegion invalidated = fDirtyRegion;
+		// erase the old outlines
+		fDirtyRegion.Include(&fInvalidated);
+		fInvalidated = invalidated;
+	}
+	if (fDirtyRegion.CountRects() > 0)
+		Invalidate(&fDirtyRegion);
+	fDirtyRegion.MakeEmpty();
+}
+
+
+void
+LayoutEditView::MarkDirty(const Area* area)
+{
+	BRect frame = _AreaFrame(area);
+	_EnlargeTooSmallArea(frame);
+	// the area border and the temp constraint marks left of and above it
+	frame.InsetBy(-kDirtyAreaInset, -kDirtyAreaInset);
+	fDirtyRegion.Include(frame);
+}
+
+
+void
+LayoutEditView::MarkDirty(const XTab* tab)
+{
+	if (!fShowXTabs)
+		return;
+	BRect bounds = Bounds();
+	float position = _TabPosition(tab);
+	fDirtyRegion.Include(BRect(position - kTabWidth - 1, bounds.top,
+		position + kTabWidth + 1, bounds.bottom));
+}
+
+
+void
+LayoutEditView::MarkDirty(const YTab* tab)
+{
+	if (!fShowYTabs)
+		return;
+	BRect bounds = Bounds();
+	float position = _TabPosition(tab);
+	fDirtyRegion.Include(BRect(bounds.left, position - kTabWidth - 1,
+		bounds.right, position + kTabWidth + 1));
+}
+
+
+void
+LayoutEditView::SetShowInvalidation(bool show)
+{
+	fShowInvalidation = show;
+	fInvalidated.MakeEmpty();
+	Invalidate();
+}
+
+
 bool
 LayoutEditView::ConnectedToLeftBorder(Area* area)
 {
@@ -563,7 +713,7 @@ LayoutEditView::MouseDown(BPoint point)
 			}
 		}
 		_NotifyAreaSelected(fSelectedArea);
-		Invalidate();
+		InvalidateChanges();
 		fEditor->UpdateEditWindow();
 	}
 	
@@ -586,7 +736,7 @@ LayoutEditView::MouseUp(BPoint point)
 	if (fState != NULL && fState->MouseUp(point) == true)
 		_SetState(new(std::nothrow) MouseOverState(this));
 
-	Invalidate();
+	InvalidateChanges();
 	fEditor->UpdateEditWindow();
 }
 
@@ -606,11 +756,8 @@ LayoutEditView::MouseMoved(BPoint point, uint32 transit,
 		CustomizableRoster* roster = CustomizableRoster::DefaultRoster();
 		BString component;
 		message->FindString("component", &component);
-		BReference<Customizable> customizable = roster->InstantiateCustomizable(
-			component, message);
-		IViewContainer* view = dynamic_cast<IViewContainer*>(
-			customizable.Get());
-		if (view != NULL)
+		// the state creates the component, the add-on knows its type
+		if (roster->IsInsertable(component))
 			_SetState(new CreateAndInsertState(this, component, NULL));
 	} else if (message != NULL && message->what == kUnTrashComponent) {
 		Customizable* customizable;
@@ -622,7 +769,7 @@ LayoutEditView::MouseMoved(BPoint point, uint32 transit,
 	if (fState != NULL)
 		fState->MouseMoved(point, transit, message);
 
-	Invalidate();
+	InvalidateChanges();
 }
 
 
@@ -671,11 +818,11 @@ LayoutEditView::FindEmptyArea(const BPoint& point, area_ref& ref, Area* ignore)
 	if (point.x <= 0 || point.y <= 0)
 		return false;
 	if (ignore != NULL) {
-		BRegion takenSpace = fTakenSpace;
+		BRegion takenSpace = _TakenSpace();
 		takenSpace.Exclude(ignore->Frame());
 		if (takenSpace.Contains(point))
 			return false;
-	} else if (fTakenSpace.Contains(point))
+	} else if (_TakenSpace().Contains(point))
 		return false;
 
 	for (int32 i = 1; i < fALMEngine->CountXTabs(); i++) {
@@ -890,7 +1037,7 @@ LayoutEditView::DrawHighLightArea(BRect frame, float penSize,
 	SetHighColor(color);
 	_EnlargeTooSmallArea(frame);
 	frame.InsetBy(2, 2);
-	StrokeRect(frame);
+	StrokeOverlayRect(frame);
 }
 
 
@@ -913,65 +1060,77 @@ LayoutEditView::DrawResizeKnops(const Area* area)
 	BPoint middle = areaFrame.LeftTop();
 	BPoint leftTop = middle - knopSizeHalf;
 	BPoint rightBottom = middle + knopSizeHalf;
-	StrokeRect(BRect(leftTop, rightBottom));
+	StrokeOverlayRect(BRect(leftTop, rightBottom));
 
 	middle = areaFrame.LeftBottom();
 	leftTop = middle - knopSizeHalf;
 	rightBottom = middle + knopSizeHalf;
-	StrokeRect(BRect(leftTop, rightBottom));
+	StrokeOverlayRect(BRect(leftTop, rightBottom));
 
 	middle = areaFrame.RightTop();
 	leftTop = middle - knopSizeHalf;
 	rightBottom = middle + knopSizeHalf;
-	StrokeRect(BRect(leftTop, rightBottom));
+	StrokeOverlayRect(BRect(leftTop, rightBottom));
 
 	middle = areaFrame.RightBottom();
 	leftTop = middle - knopSizeHalf;
 	rightBottom = middle + knopSizeHalf;
-	StrokeRect(BRect(leftTop, rightBottom));
+	StrokeOverlayRect(BRect(leftTop, rightBottom));
 
 	
 	middle = BPoint(areaFrame.left + areaFrame.Width() / 2, areaFrame.top);
 	leftTop = middle - knopSizeHalf;
 	rightBottom = middle + knopSizeHalf;
-	StrokeRect(BRect(leftTop, rightBottom));
+	StrokeOverlayRect(BRect(leftTop, rightBottom));
 
 	middle = BPoint(areaFrame.left + areaFrame.Width() / 2, areaFrame.bottom);
 	leftTop = middle - knopSizeHalf;
 	rightBottom = middle + knopSizeHalf;
-	StrokeRect(BRect(leftTop, rightBottom));
+	StrokeOverlayRect(BRect(leftTop, rightBottom));
 
 	middle = BPoint(areaFrame.left, areaFrame.top + areaFrame.Height() / 2);
 	leftTop = middle - knopSizeHalf;
 	rightBottom = middle + knopSizeHalf;
-	StrokeRect(BRect(leftTop, rightBottom));
+	StrokeOverlayRect(BRect(leftTop, rightBottom));
 
 	middle = BPoint(areaFrame.right, areaFrame.top + areaFrame.Height() / 2);
 	leftTop = middle - knopSizeHalf;
 	rightBottom = middle + knopSizeHalf;
-	StrokeRect(BRect(leftTop, rightBottom));
+	StrokeOverlayRect(BRect(leftTop, rightBottom));
 }
 
 
 void
-LayoutEditView::DrawTab(const XTab* tab, float penSize, const rgb_color& color)
+LayoutEditView::DrawTab(const XTab* tab, float penSize, const rgb_color& color,
+	BView* target)
 {
-	SetPenSize(penSize);
-	SetHighColor(color);
+	BView* view = _DrawTarget(target);
+	view->SetPenSize(penSize);
+	view->SetHighColor(color);
 	float tabPosition = _TabPosition(tab);
-	StrokeLine(BPoint(tabPosition, 0), BPoint(tabPosition,
-		Bounds().Height() - penSize / 2));
+	BPoint start(tabPosition, 0);
+	BPoint end(tabPosition, Bounds().Height() - penSize / 2);
+	if (target == NULL)
+		StrokeOverlayLine(start, end);
+	else
+		view->StrokeLine(start, end);
 }
 
 
 void
-LayoutEditView::DrawTab(const YTab* tab, float penSize, const rgb_color& color)
+LayoutEditView::DrawTab(const YTab* tab, float penSize, const rgb_color& color,
+	BView* target)
 {
-	SetPenSize(penSize);
-	SetHighColor(color);
+	BView* view = _DrawTarget(target);
+	view->SetPenSize(penSize);
+	view->SetHighColor(color);
 	float tabPosition = _TabPosition(tab);
-	StrokeLine(BPoint(0, tabPosition), BPoint(Bounds().Width() - penSize / 2,
-		tabPosition));
+	BPoint start(0, tabPosition);
+	BPoint end(Bounds().Width() - penSize / 2, tabPosition);
+	if (target == NULL)
+		StrokeOverlayLine(start, end);
+	else
+		view->StrokeLine(start, end);
 }
 
 
@@ -994,7 +1153,7 @@ LayoutEditView::DrawXTabConnections(XTab* tab)
 		Area* area = links.areas1.ItemAt(i);
 		start.y = area->Top()->Value() + space;
 		end.y = area->Bottom()->Value() - space;
-		StrokeLine(start, end);
+		StrokeOverlayLine(start, end);
 		
 	}
 
@@ -1004,7 +1163,7 @@ LayoutEditView::DrawXTabConnections(XTab* tab)
 		Area* area = links.areas2.ItemAt(i);
 		start.y = area->Top()->Value() + space;
 		end.y = area->Bottom()->Value() - space;
-		StrokeLine(start, end);
+		StrokeOverlayLine(start, end);
 	}
 }
 
@@ -1028,7 +1187,7 @@ LayoutEditView::DrawYTabConnections(YTab* tab)
 		Area* area = links.areas1.ItemAt(i);
 		start.x = area->Left()->Value() + space;
 		end.x = area->Right()->Value() - space;
-		StrokeLine(start, end);
+		StrokeOverlayLine(start, end);
 		
 	}
 
@@ -1038,7 +1197,7 @@ LayoutEditView::DrawYTabConnections(YTab* tab)
 		Area* area = links.areas2.ItemAt(i);
 		start.x = area->Left()->Value() + space;
 		end.x = area->Right()->Value() - space;
-		StrokeLine(start, end);
+		StrokeOverlayLine(start, end);
 	}
 }
 
@@ -1060,7 +1219,7 @@ LayoutEditView::DrawAreaWithInnerTabs(const area_ref& ref)
 		float tabPosition = tab->Value();
 		if (tabPosition > frame.right)
 			break;
-		StrokeLine(BPoint(tabPosition, frame.top),
+		StrokeOverlayLine(BPoint(tabPosition, frame.top),
 			BPoint(tabPosition, frame.bottom));
 	}
 
@@ -1070,72 +1229,76 @@ LayoutEditView::DrawAreaWithInnerTabs(const area_ref& ref)
 		float tabPosition = tab->Value();
 		if (tabPosition > frame.bottom)
 			break;
-		StrokeLine(BPoint(frame.left, tabPosition),
+		StrokeOverlayLine(BPoint(frame.left, tabPosition),
 			BPoint(frame.right, tabPosition));
 	}
 }
 
 
 void
-LayoutEditView::DrawTooSmallArea(Area* area)
+LayoutEditView::DrawTooSmallArea(Area* area, BView* target)
 {
 	BRect frame = _AreaFrame(area);
 	if (!_EnlargeTooSmallArea(frame))
 		return;
 
+	BView* view = _DrawTarget(target);
 	rgb_color color = {0, 0, 200, 40};
-	SetDrawingMode(B_OP_ALPHA);
-	SetHighColor(color);
-	FillRect(frame);
-	SetDrawingMode(B_OP_OVER);
+	view->SetDrawingMode(B_OP_ALPHA);
+	view->SetHighColor(color);
+	view->FillRect(frame);
+	view->SetDrawingMode(B_OP_OVER);
 }
 
 
 void
-LayoutEditView::DrawSpacer(Area* area, BSpaceLayoutItem* spacer)
+LayoutEditView::DrawSpacer(Area* area, BSpaceLayoutItem* spacer,
+	BView* target)
 {
-	rgb_color spacerColor = {20, 20, 20};
-	rgb_color barColor = {100, 100, 100};
+	BView* view = _DrawTarget(target);
+	rgb_color spacerColor = {20, 20, 20, 255};
+	rgb_color barColor = {100, 100, 100, 255};
 
 	BRect rect = _AreaFrame(area);
 	const float kKnopSize = 6;
 	float middleH = rect.left + rect.Width() / 2;
 	float middleV = rect.top + rect.Height() / 2;
 
-	SetHighColor(spacerColor);
+	view->SetHighColor(spacerColor);
 	// left
-	FillRect(BRect(rect.left, middleV - kKnopSize / 2,
+	view->FillRect(BRect(rect.left, middleV - kKnopSize / 2,
 		rect.left + kKnopSize / 2, middleV + kKnopSize / 2));
 	// top
-	FillRect(BRect(middleH - kKnopSize / 2, rect.top,
+	view->FillRect(BRect(middleH - kKnopSize / 2, rect.top,
 		middleH + kKnopSize / 2, rect.top + kKnopSize / 2));
 	// right
-	FillRect(BRect(rect.right - kKnopSize / 2, middleV - kKnopSize / 2,
+	view->FillRect(BRect(rect.right - kKnopSize / 2, middleV - kKnopSize / 2,
 		rect.right, middleV + kKnopSize / 2));
 	// bottom
-	FillRect(BRect(middleH - kKnopSize / 2, rect.bottom - kKnopSize / 2,
+	view->FillRect(BRect(middleH - kKnopSize / 2, rect.bottom - kKnopSize / 2,
 		middleH + kKnopSize / 2, rect.bottom));
 
 	float lengthH = rect.Width() * 0.3;
 	float lengthV = rect.Height() * 0.3;
-	SetPenSize(3);
-	StrokeLine(BPoint(rect.left + lengthH, middleV),
+	view->SetPenSize(3);
+	view->StrokeLine(BPoint(rect.left + lengthH, middleV),
 		BPoint(rect.right - kKnopSize / 2, middleV));
-	StrokeLine(BPoint(middleH, rect.top + lengthV),
+	view->StrokeLine(BPoint(middleH, rect.top + lengthV),
 		BPoint(middleH, rect.bottom- kKnopSize / 2));
 
-	SetHighColor(barColor);
-	SetPenSize(1);
-	StrokeLine(BPoint(rect.left + kKnopSize / 2, middleV),
+	view->SetHighColor(barColor);
+	view->SetPenSize(1);
+	view->StrokeLine(BPoint(rect.left + kKnopSize / 2, middleV),
 		BPoint(rect.left + lengthH, middleV));
-	StrokeLine(BPoint(middleH, rect.top + kKnopSize / 2),
+	view->StrokeLine(BPoint(middleH, rect.top + kKnopSize / 2),
 		BPoint(middleH, rect.top + lengthV));
 }
 
 
 void
-LayoutEditView::DrawAreaBackground(Area* area)
+LayoutEditView::DrawAreaBackground(Area* area, BView* target)
 {
+	BView* view = _DrawTarget(target);
 	BRect frame = area->Frame();
 
 /*BRect areaFrame = _AreaFrame(area);
@@ -1158,14 +1321,14 @@ StrokeRect(areaFrame);
 		region.Exclude(item->Frame());
 
 	const uint8 shade = 240;
-	rgb_color backgoundColor = {shade, shade, shade};
-	SetHighColor(backgoundColor);
-	FillRegion(&region);
+	rgb_color backgoundColor = {shade, shade, shade, 255};
+	view->SetHighColor(backgoundColor);
+	view->FillRegion(&region);
 
 	const uint8 shadeDark = 220;
-	rgb_color borderColor = {shadeDark, shadeDark, shadeDark};
-	SetHighColor(borderColor);
-	StrokeRect(region.Frame());
+	rgb_color borderColor = {shadeDark, shadeDark, shadeDark, 255};
+	view->SetHighColor(borderColor);
+	view->StrokeRect(region.Frame());
 }
 
 
@@ -1175,7 +1338,8 @@ LayoutEditView::DrawTakenSpace()
 	rgb_color color = {0, 255, 0, 20};
 	SetDrawingMode(B_OP_ALPHA);
 	SetHighColor(color);
-	FillRegion(&fTakenSpace);
+	BRegion takenSpace = _TakenSpace();
+	FillRegion(&takenSpace);
 	SetDrawingMode(B_OP_OVER);
 }
 
@@ -1207,7 +1371,7 @@ LayoutEditView::DrawTempConstraints()
 				XTab* xTab = static_cast<XTab*>(summand1->Var());
 				if (fALMEngine->IndexOf(xTab) >= 0) {
 					if (area->Left() == xTab) {
-						StrokeLine(BPoint(xTab->Value() - 5,
+						StrokeOverlayLine(BPoint(xTab->Value() - 5,
 							area->Top()->Value()),
 							BPoint(xTab->Value(), area->Top()->Value()));
 					}
@@ -1215,7 +1379,7 @@ LayoutEditView::DrawTempConstraints()
 				YTab* yTab = static_cast<YTab*>(summand1->Var());
 				if (fALMEngine->IndexOf(yTab) >= 0) {
 					if (area->Top() == yTab) {
-						StrokeLine(BPoint(area->Left()->Value(),
+						StrokeOverlayLine(BPoint(area->Left()->Value(),
 							yTab->Value() - 5),
 							BPoint(area->Left()->Value(), yTab->Value()));
 					}
@@ -1231,7 +1395,7 @@ LayoutEditView::DrawTempConstraints()
 					if ((xVar1 == area->Left() && xVar2 == area->Right()) ||
 						(xVar1 == area->Right() && xVar2 == area->Left())) {
 						BRect frame = area->Frame();
-						StrokeLine(BPoint(frame.left,
+						StrokeOverlayLine(BPoint(frame.left,
 							frame.top + frame.Height() / 2), BPoint(frame.right,
 							frame.top + frame.Height() / 2));
 						break;
@@ -1241,7 +1405,7 @@ LayoutEditView::DrawTempConstraints()
 					if ((yVar1 == area->Top() && yVar2 == area->Bottom()) ||
 						(yVar1 == area->Bottom() && yVar2 == area->Top())) {
 						BRect frame = area->Frame();
-						StrokeLine(BPoint(frame.left + frame.Width() / 2,
+						StrokeOverlayLine(BPoint(frame.left + frame.Width() / 2,
 							frame.top), BPoint(frame.left + frame.Width() / 2,
 							frame.bottom));
 						break;
@@ -1254,68 +1418,76 @@ LayoutEditView::DrawTempConstraints()
 
 
 void
-LayoutEditView::Draw(BRect updateRect)
+LayoutEditView::StrokeOverlayLine(BPoint start, BPoint end)
 {
-	rgb_color backgoundColor = {255, 255, 255};
-	if (fALMEngine->View() != NULL)
-		backgoundColor = fALMEngine->View()->ViewColor();
-	SetHighColor(backgoundColor);
-
-	BRegion background(updateRect);
-	for (int32 i = 0; i < fALMEngine->CountItems(); i++) {
-		BLayoutItem* item = fALMEngine->ItemAt(i);
-		BView* view = item->View();
-		if (view == this)
-			continue;
-		_RecursiveExcludeViews(item, background);
+	if (fMeasuredOverlay != NULL) {
+		_IncludeOverlayBounds(BRect(std::min(start.x, end.x),
+			std::min(start.y, end.y), std::max(start.x, end.x),
+			std::max(start.y, end.y)));
+		return;
 	}
-	FillRegion(&background);
+	StrokeLine(start, end);
+}
 
-	// Draw selected area
-	if (fSelectedArea != NULL) {
-		DrawXTabConnections(fSelectedArea->Left());
-		DrawXTabConnections(fSelectedArea->Right());
-		DrawYTabConnections(fSelectedArea->Top());
-		DrawYTabConnections(fSelectedArea->Bottom());
 
-		DrawHighLightArea(fSelectedArea, 1, kSelectedColor);
-		DrawResizeKnops(fSelectedArea);
+void
+LayoutEditView::StrokeOverlayRect(BRect rect)
+{
+	if (fMeasuredOverlay != NULL) {
+		_IncludeOverlayBounds(rect);
+		return;
 	}
+	StrokeRect(rect);
+}
 
-	for (int32 i = 0; i < fALMEngine->CountItems(); i++) {
-		Area* area = fALMEngine->AreaAt(i);
-		DrawAreaBackground(area);
-	}
 
-	// Paint tabs if the option is selected
-	if (fShowXTabs) {
-		for (int32 i = 0; i < fALMEngine->CountXTabs(); i++)
-			DrawTab(fALMEngine->XTabAt(i), kTabWidth, kSuggestionColor);
-	}
-	if (fShowYTabs) {
-		for (int32 i = 0; i < fALMEngine->CountYTabs(); i++)
-			DrawTab(fALMEngine->YTabAt(i), kTabWidth, kSuggestionColor);
+void
+LayoutEditView::Draw(BRect updateRect)
+{
+	bigtime_t drawStart = system_time();
+
+	_DrawBackground(updateRect);
+	// the area decorations are drawn on top of the selection
+	_DrawSelection();
+
+	// During an animation the static layer changes with every frame, caching
+	// it would only add a copy. It is rendered again when the animation is
+	// over.
+	bool cached = false;
+	int32 staticLayerPaints = fPaintStatistics.staticLayerPaints;
+	if (fEditAnimation.IsRunning())
+		fStaticLayerValid = false;
+	else {
+		_CheckLayoutChanged();
+		cached = _UpdateStaticLayer();
 	}
 
-	// draw spacer and to small areas
-	for (int32 i = 0; i < fALMEngine->CountItems(); i++) {
-		Area* area = fALMEngine->AreaAt(i);
+	bigtime_t staticLayerStart = system_time();
+	if (cached) {
+		if (staticLayerPaints == fPaintStatistics.staticLayerPaints)
+			fPaintStatistics.cachedDraws++;
+		SetDrawingMode(B_OP_ALPHA);
+		SetBlendingMode(B_PIXEL_ALPHA, B_ALPHA_OVERLAY);
+		DrawBitmap(fStaticLayer, updateRect, updateRect);
+	} else {
+		_DrawStaticLayer(this);
+		fPaintStatistics.staticLayerTime = system_time() - staticLayerStart;
+		fPaintStatistics.staticLayerPaints++;
+	}
+	SetDrawingMode(B_OP_OVER);
 
-		DrawTooSmallArea(area);
+	bigtime_t overlayStart = system_time();
+	_DrawOverlay(updateRect);
+	fPaintStatistics.overlayTime = system_time() - overlayStart;
 
-		BSpaceLayoutItem* spacer = dynamic_cast<BSpaceLayoutItem*>(
-			area->Item());
-		if (spacer == NULL)
-			continue;
-		DrawSpacer(area, spacer);
+	if (fShowInvalidation) {
+		SetPenSize(1);
+		SetHighColor(255, 0, 0);
+		for (int32 i = 0; i < fInvalidated.CountRects(); i++)
+			StrokeRect(fInvalidated.RectAt(i));
 	}
 
-	if (fState != NULL)
-		fState->Draw(updateRect);
-
-//	fOverlapManager.Draw(this);
-//	DrawTakenSpace();
-	DrawTempConstraints();
+	fFrameScheduler.ReportDrawCost(system_time() - drawStart);
 }
 
 
@@ -1324,7 +1496,14 @@ LayoutEditView::FrameResized(float width, float height)
 {
 	_InvalidateAreaData();
 
-	_UpdateCurrentLayout();
+	// Updating the history on every resize event makes a live resize slow,
+	// wait till the resize settles.
+	fLastResize = system_time();
+	if (fResizeRunner == NULL) {
+		BMessage message(kMsgResizeSettled);
+		fResizeRunner = new BMessageRunner(BMessenger(this), &message,
+			kResizeSettleDelay, 1);
+	}
 }
 
 
@@ -1340,6 +1519,21 @@ LayoutEditView::MessageReceived(BMessage* message)
 			Redo();
 			break;
 
+		case kMsgResizeSettled:
+		{
+			bigtime_t sinceLastResize = system_time() - fLastResize;
+			if (sinceLastResize < kResizeSettleDelay) {
+				// still resizing, try again later
+				delete fResizeRunner;
+				BMessage settled(kMsgResizeSettled);
+				fResizeRunner = new BMessageRunner(BMessenger(this), &settled,
+					kResizeSettleDelay - sinceLastResize, 1);
+				break;
+			}
+			_ResizeSettled();
+			break;
+		}
+
 		case kMsgCreateComponent:
 		{
 			BString component;
@@ -1560,14 +1754,27 @@ LayoutEditView::_NotifyAreaSelected(Area* area)
 void
 LayoutEditView::_InvalidateAreaData()
 {
-	fTakenSpace.Set(BRect(0, 0, 0, 0));
+	fLayoutGeneration++;
+	fTakenSpaceValid = false;
+	fEditAnimation.LayoutChanged();
+}
+
 
+const BRegion&
+LayoutEditView::_TakenSpace()
+{
+	if (fTakenSpaceValid)
+		return fTakenSpace;
+
+	fTakenSpace.Set(BRect(0, 0, 0, 0));
 	for (int32 i = 0; i < fALMEngine->CountItems(); i++) {
 		Area* area = fALMEngine->AreaAt(i);
 		if (area->Item()->View() == this)
 			continue;
 		fTakenSpace.Include(area->Frame());
 	}
+	fTakenSpaceValid = true;
+	return fTakenSpace;
 }
 
 
@@ -1584,7 +1791,7 @@ LayoutEditView::_HightlightCustomizableView(Customizable* customizable)
 		Area* area = fALMEngine->AreaAt(i);
 		if (area->Item()->View() == view) {
 			fSelectedArea = area;
-			Invalidate();
+			InvalidateChanges();
 			break;
 		}
 	}	
@@ -1618,7 +1825,20 @@ LayoutEditView::_UpdateCurrentLayout()
 	if (entry == NULL)
 		debugger("we have no history!");
 
-	LayoutArchive(fALMEngine).SaveLayout(&entry->layout, false);
+	LayoutArchive archive(fALMEngine);
+	// a resize only moves tabs, don't archive the complete layout again
+	if (archive.UpdateTabValues(&entry->layout) != B_OK)
+		archive.SaveLayout(&entry->layout, false);
+}
+
+
+void
+LayoutEditView::_ResizeSettled()
+{
+	delete fResizeRunner;
+	fResizeRunner = NULL;
+
+	_UpdateCurrentLayout();
 }
 
 
@@ -1801,3 +2021,222 @@ LayoutEditView::_RecursiveExcludeViews(BLayoutItem* item, BRegion& region)
 	BRect itemFrame = item->Frame();
 	region.Exclude(itemFrame);
 }
+
+
+BView*
+LayoutEditView::_DrawTarget(BView* target)
+{
+	if (target == NULL)
+		return this;
+	return target;
+}
+
+
+//! Fills the space that is not covered by an item view.
+void
+LayoutEditView::_DrawBackground(BRect updateRect)
+{
+	rgb_color backgoundColor = {255, 255, 255, 255};
+	if (fALMEngine->View() != NULL)
+		backgoundColor = fALMEngine->View()->ViewColor();
+	SetHighColor(backgoundColor);
+
+	if (!fBackgroundValid || fBackgroundGeneration != fLayoutGeneration) {
+		fBackground.Set(Bounds());
+		for (int32 i = 0; i < fALMEngine->CountItems(); i++) {
+			BLayoutItem* item = fALMEngine->ItemAt(i);
+			BView* view = item->View();
+			if (view == this)
+				continue;
+			_RecursiveExcludeViews(item, fBackground);
+		}
+		fBackgroundGeneration = fLayoutGeneration;
+		// the items move with every animation frame
+		fBackgroundValid = !fEditAnimation.IsRunning();
+	}
+
+	BRegion background(updateRect);
+	background.IntersectWith(&fBackground);
+	FillRegion(&background);
+}
+
+
+void
+LayoutEditView::_DrawSelection()
+{
+	if (fSelectedArea == NULL)
+		return;
+
+	DrawXTabConnections(fSelectedArea->Left());
+	DrawXTabConnections(fSelectedArea->Right());
+	DrawYTabConnections(fSelectedArea->Top());
+	DrawYTabConnections(fSelectedArea->Bottom());
+
+	DrawHighLightArea(fSelectedArea, 1, kSelectedColor);
+	DrawResizeKnops(fSelectedArea);
+}
+
+
+/*! Draws everything that only changes with the layout, i.e. area decorations
+and tabs. */
+void
+LayoutEditView::_DrawStaticLayer(BView* target)
+{
+	for (int32 i = 0; i < fALMEngine->CountItems(); i++) {
+		Area* area = fALMEngine->AreaAt(i);
+		DrawAreaBackground(area, target);
+	}
+
+	// Paint tabs if the option is selected
+	if (fShowXTabs) {
+		for (int32 i = 0; i < fALMEngine->CountXTabs(); i++) {
+			DrawTab(fALMEngine->XTabAt(i), kTabWidth, kSuggestionColor,
+				target);
+		}
+	}
+	if (fShowYTabs) {
+		for (int32 i = 0; i < fALMEngine->CountYTabs(); i++) {
+			DrawTab(fALMEngine->YTabAt(i), kTabWidth, kSuggestionColor,
+				target);
+		}
+	}
+
+	// draw spacer and to small areas
+	for (int32 i = 0; i < fALMEngine->CountItems(); i++) {
+		Area* area = fALMEngine->AreaAt(i);
+
+		DrawTooSmallArea(area, target);
+
+		BSpaceLayoutItem* spacer = dynamic_cast<BSpaceLayoutItem*>(
+			area->Item());
+		if (spacer == NULL)
+			continue;
+		DrawSpacer(area, spacer, target);
+	}
+}
+
+
+//! Draws the state feedback on top of the static layer.
+void
+LayoutEditView::_DrawOverlay(BRect updateRect)
+{
+	if (fState != NULL)
+		fState->Draw(updateRect);
+
+//	fOverlapManager.Draw(this);
+//	DrawTakenSpace();
+	DrawTempConstraints();
+}
+
+
+/*! Renders the static layer into the cache bitmap if the layout changed since
+the last render. Returns false if there is no usable cache, the static layer
+has to be drawn directly then. */
+bool
+LayoutEditView::_UpdateStaticLayer()
+{
+	BRect bounds = Bounds().OffsetToCopy(B_ORIGIN);
+	if (fStaticLayer != NULL && fStaticLayer->Bounds() != bounds) {
+		delete fStaticLayer;
+		fStaticLayer = NULL;
+		fStaticLayerView = NULL;
+	}
+	if (fStaticLayer == NULL) {
+		fStaticLayer = new(std::nothrow) BBitmap(bounds,
+			B_BITMAP_ACCEPTS_VIEWS, B_RGBA32);
+		if (fStaticLayer == NULL)
+			return false;
+		if (fStaticLayer->InitCheck() != B_OK) {
+			delete fStaticLayer;
+			fStaticLayer = NULL;
+			return false;
+		}
+		fStaticLayerView = new BView(bounds, "static layer", B_FOLLOW_NONE, 0);
+		fStaticLayer->AddChild(fStaticLayerView);
+		fStaticLayerValid = false;
+	}
+
+	if (fStaticLayerValid && fStaticLayerGeneration == fLayoutGeneration)
+		return true;
+
+	bigtime_t start = system_time();
+	if (!fStaticLayer->Lock())
+		return false;
+	// everything that is not painted stays transparent, e.g. the background
+	memset(fStaticLayer->Bits(), 0, fStaticLayer->BitsLength());
+	fStaticLayerView->SetBlendingMode(B_PIXEL_ALPHA, B_ALPHA_COMPOSITE);
+	fStaticLayerView->SetDrawingMode(B_OP_COPY);
+	_DrawStaticLayer(fStaticLayerView);
+	fStaticLayerView->Sync();
+	fStaticLayer->Unlock();
+
+	fStaticLayerValid = true;
+	fStaticLayerGeneration = fLayoutGeneration;
+	fPaintStatistics.staticLayerTime = system_time() - start;
+	fPaintStatistics.staticLayerPaints++;
+	return true;
+}
+
+
+/*! A relayout of the edited layout, e.g. because a component changed its
+size, moves areas without any edit. Compares the tabs, the area frames and the
+item sizes the static layer is drawn from with the last check, and starts a
+new layout generation if they changed. */
+void
+LayoutEditView::_CheckLayoutChanged()
+{
+	fNewLayoutSnapshot.clear();
+	for (int32 i = 0; i < fALMEngine->CountXTabs(); i++)
+		fNewLayoutSnapshot.push_back(fALMEngine->XTabAt(i)->Value());
+	for (int32 i = 0; i < fALMEngine->CountYTabs(); i++)
+		fNewLayoutSnapshot.push_back(fALMEngine->YTabAt(i)->Value());
+	for (int32 i = 0; i < fALMEngine->CountItems(); i++) {
+		Area* area = fALMEngine->AreaAt(i);
+		BRect frame = area->Frame();
+		BSize minSize = area->Item()->MinSize();
+		BSize maxSize = area->Item()->MaxSize();
+		fNewLayoutSnapshot.push_back(frame.left);
+		fNewLayoutSnapshot.push_back(frame.top);
+		fNewLayoutSnapshot.push_back(frame.right);
+		fNewLayoutSnapshot.push_back(frame.bottom);
+		fNewLayoutSnapshot.push_back(minSize.width);
+		fNewLayoutSnapshot.push_back(minSize.height);
+		fNewLayoutSnapshot.push_back(maxSize.width);
+		fNewLayoutSnapshot.push_back(maxSize.height);
+	}
+
+	if (fNewLayoutSnapshot == fLayoutSnapshot)
+		return;
+	fLayoutSnapshot.swap(fNewLayoutSnapshot);
+	_InvalidateAreaData();
+}
+
+
+/*! The selection and the state feedback are run in a measuring mode to find
+their new bounds, the bounds of the last run tell where the old ones have to be
+erased. Both only draw the few items they are about, the temp constraints are
+left out, they only change with an action and move with their areas. */
+void
+LayoutEditView::_IncludeOverlayChanges(BRegion& region)
+{
+	BRegion overlay;
+	fMeasuredOverlay = &overlay;
+	_DrawSelection();
+	if (fState != NULL)
+		fState->Draw(Bounds());
+	fMeasuredOverlay = NULL;
+
+	region.Include(&fDrawnOverlay);
+	region.Include(&overlay);
+	fDrawnOverlay = overlay;
+}
+
+
+void
+LayoutEditView::_IncludeOverlayBounds(BRect rect)
+{
+	// the pen is centered on the outline
+	float inset = ceilf(PenSize() / 2) + 1;
+	rect.InsetBy(-inset, -inset);
+	fMeasuredOverlay->Include(rect);
+}
@@ -9,7 +9,9 @@
 
 
 #include "app/MessageFilter.h"
+#include <Bitmap.h>
 #include <MenuItem.h>
+#include <MessageRunner.h>
 #include <Point.h>
 #include <PopUpMenu.h>
 #include <Region.h>
@@ -17,6 +19,8 @@
 #include <SupportDefs.h>
 #include <View.h>
 
+#include <vector>
+
 #include <ALMLayout.h>
 #include <Customizable.h>
 #include <CustomizableView.h>
@@ -259,6 +263,38 @@ public:
 			bool				TestAndPerformAction(EditAction* action);
 
 			bool				TrashArea(Area* area);
+
+			//! Frame statistics of the edit animations.
+			const FrameScheduler*	GetFrameScheduler() const;
+
+			struct paint_statistics {
+				//! Duration of the last static layer paint, cached or direct
+				bigtime_t		staticLayerTime;
+				bigtime_t		overlayTime;
+
+				int32			staticLayerPaints;
+				//! Draw calls that used the cached static layer
+				int32			cachedDraws;
+			};
+
+			void				GetPaintStatistics(
+									paint_statistics& statistics) const;
+			/*! The static layer (tabs, spacer and area decorations) is
+			cached. Call this after changing an item or an option that is
+			drawn in this layer, relayouts are detected by Draw(). */
+			void				InvalidateStaticLayer();
+
+			/*! Invalidates what has been marked dirty since the last call,
+			plus the old and new bounds of the selection and the state
+			feedback. */
+			void				InvalidateChanges();
+			/*! Mark the area or tab before and after it moves, so that its
+			old and new position is redrawn. */
+			void				MarkDirty(const Area* area);
+			void				MarkDirty(const XTab* tab);
+			void				MarkDirty(const YTab* tab);
+			//! Outlines the invalidated rects, to spot wrong invalidations.
+			void				SetShowInvalidation(bool show);
 protected:
 			void				KeyDown(const char* bytes, int32 numBytes);
 
@@ -274,19 +310,29 @@ protected:
 									float penSize, const rgb_color& color);
 			void				DrawResizeKnops(const Area* area);
 			void				DrawTab(const XTab* tab, float penSize,
-									const rgb_color& color);
+									const rgb_color& color,
+									BView* target = NULL);
 			void				DrawTab(const YTab* tab, float penSize,
-									const rgb_color& color);
+									const rgb_color& color,
+									BView* target = NULL);
 			void				DrawXTabConnections(XTab* tab);
 			void				DrawYTabConnections(YTab* tab);
 			void				DrawAreaWithInnerTabs(const area_ref& ref);
-			void				DrawTooSmallArea(Area* area);
+			void				DrawTooSmallArea(Area* area,
+									BView* target = NULL);
 			void				DrawSpacer(Area* area,
-									BSpaceLayoutItem* spacer);
-			void				DrawAreaBackground(Area* area);
+									BSpaceLayoutItem* spacer,
+									BView* target = NULL);
+			void				DrawAreaBackground(Area* area,
+									BView* target = NULL);
 			void				DrawTakenSpace();
 			void				DrawTempConstraints();
 
+			/*! Primitives for the overlay. While the overlay is measured they
+			only record the area they would draw to. */
+			void				StrokeOverlayLine(BPoint start, BPoint end);
+			void				StrokeOverlayRect(BRect rect);
+
 			void				Draw(BRect updateRect);
 			void				FrameResized(float width, float height);
 			void				MessageReceived(BMessage* message);
@@ -366,6 +412,8 @@ private:
 
 			//! Trigger the recalculation of the taken space.
 			void				_InvalidateAreaData();
+			//! The taken space is only recalculated when it is needed.
+			const BRegion&		_TakenSpace();
 
 			void				_HightlightCustomizableView(
 									Customizable* customizable);
@@ -373,6 +421,7 @@ private:
 			void				_StoreAction(EditAction* action);
 			void				_ResetHistory();
 			void				_UpdateCurrentLayout();
+			void				_ResizeSettled();
 
 			void				_UpdateRightClickMenu(Area* area);
 
@@ -381,6 +430,17 @@ private:
 			void				_RecursiveExcludeViews(BLayoutItem* item,
 									BRegion& region);
 
+			BView*				_DrawTarget(BView* target);
+			void				_DrawBackground(BRect updateRect);
+			void				_DrawSelection();
+			void				_DrawStaticLayer(BView* target);
+			void				_DrawOverlay(BRect updateRect);
+			bool				_UpdateStaticLayer();
+			void				_CheckLayoutChanged();
+
+			void				_IncludeOverlayChanges(BRegion& region);
+			void				_IncludeOverlayBounds(BRect rect);
+
 			BALMEditor*			fEditor;
 			BALMLayout*			fALMEngine;
 			BMessageFilter*		fMessageFilter;
@@ -400,6 +460,11 @@ private:
 			State*				fState;
 
 			BRegion				fTakenSpace;
+			bool				fTakenSpaceValid;
+
+			//! Delays the history update till a window resize has settled.
+			BMessageRunner*		fResizeRunner;
+			bigtime_t			fLastResize;
 
 			Informant*			fInformant;
 
@@ -418,7 +483,32 @@ struct history_entry {
 			OverlapManager&		fOverlapManager;
 			BPoint				fLastMenuPosition;
 
+			FrameScheduler		fFrameScheduler;
 			EditAnimation		fEditAnimation;
+
+			BBitmap*			fStaticLayer;
+			BView*				fStaticLayerView;
+			bool				fStaticLayerValid;
+			//! Counts the layout changes, the caches compare it to their own.
+			uint32				fLayoutGeneration;
+			uint32				fStaticLayerGeneration;
+			//! What the static layer depends on, as of the last check.
+			std::vector<float>	fLayoutSnapshot;
+			std::vector<float>	fNewLayoutSnapshot;
+			BRegion				fBackground;
+			uint32				fBackgroundGeneration;
+			bool				fBackgroundValid;
+			paint_statistics	fPaintStatistics;
+
+			//! Collects the changes till the next InvalidateChanges().
+			BRegion				fDirtyRegion;
+			//! The selection and state feedback that is on screen right now.
+			BRegion				fDrawnOverlay;
+			//! Only set while the overlay is measured.
+			BRegion*			fMeasuredOverlay;
+
+			bool				fShowInvalidation;
+			BRegion				fInvalidated;
 };
 
 
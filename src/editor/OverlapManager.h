@@ -13,6 +13,8 @@
 
 #include <ALMLayout.h>
 
+#include "ConstraintPool.h"
+#include "ConstraintPresolver.h"
 #include "LinearProgrammingTypes.h"
 
 
@@ -395,6 +397,12 @@ public:
 	virtual void				ConnectAreas() = 0;
 
 	virtual void				Draw(BView* view) = 0;
+
+	/*! Number of redundant constraints that have not been added to the
+	solver and number of tabs merged by equalities in the last ConnectAreas
+	call. */
+	virtual void				GetPresolveStatistics(int32& eliminatedRows,
+									int32& coalescedTabs) const = 0;
 };
 
 
@@ -419,6 +427,11 @@ public:
 	void ConnectAreas(bool fillTabConnections = true);
 	void Draw(BView* view);
 
+	void GetPresolveStatistics(int32& eliminatedRows, int32& coalescedTabs)
+	{
+		fOverlapEngine->GetPresolveStatistics(eliminatedRows, coalescedTabs);
+	}
+
 	void ReconnectAreas()
 	{
 		DisconnectAreas();
@@ -496,6 +509,9 @@ public:
 	SimpleOverlapEngine(BALMLayout* layout, OverlapManager* manager)
 		:
 		fALMLayout(layout),
+		fConstraintPool(layout->Solver()),
+		fEliminatedRows(0),
+		fCoalescedTabs(0),
 		fTabConnections(manager->GetTabConnections()),
 		fXTabLinkMap(fTabConnections->GetXTabLinkMap()),
 		fYTabLinkMap(fTabConnections->GetYTabLinkMap())
@@ -507,13 +523,13 @@ public:
 	{
 		fDebugInfos.clear();
 
-		for (int32 i = 0; i < fVConstraints.CountItems(); i++)
-			fALMLayout->Solver()->RemoveConstraint(fVConstraints.ItemAt(i));
-		for (int32 i = 0; i < fHConstraints.CountItems(); i++)
-			fALMLayout->Solver()->RemoveConstraint(fHConstraints.ItemAt(i));
+		// the constraints are recycled by the next ConnectAreas call
+		fConstraintPool.RemoveAll();
 
-		fVConstraints.MakeEmpty();
-		fHConstraints.MakeEmpty();
+		fVConstraints.clear();
+		fHConstraints.clear();
+		fEliminatedRows = 0;
+		fCoalescedTabs = 0;
 	}
 
 	virtual void ConnectAreas()
@@ -552,11 +568,8 @@ public:
 					side. This can happen if both tabs at the same position. */
 					tab_links<XTab>& links = fXTabLinkMap[closestArea->Right()];
 					if (!links.tabs1.HasItem(closestTab)) {
-						Constraint* constraint
-							= fALMLayout->Solver()->AddConstraint(
-								-1., closestArea->Right(), 1., closestTab,
-								LinearProgramming::kGE, 0);
-						fHConstraints.AddItem(constraint);
+						fHOrders.push_back(overlap_order(closestArea->Right(),
+							closestTab));
 		
 						tab_links<XTab>& links = fXTabLinkMap[closestTab];
 						links.tabs1.AddItem(closestArea->Right());
@@ -576,11 +589,8 @@ public:
 						dist);
 					tab_links<YTab>& links = fYTabLinkMap[closestArea->Bottom()];
 					if (!links.tabs1.HasItem(closestTab)) {
-						Constraint* constraint
-							= fALMLayout->Solver()->AddConstraint(
-								-1., closestArea->Bottom(), 1., closestTab,
-								LinearProgramming::kGE, 0);
-						fVConstraints.AddItem(constraint);
+						fVOrders.push_back(overlap_order(closestArea->Bottom(),
+							closestTab));
 
 						tab_links<YTab>& links = fYTabLinkMap[closestTab];
 						links.tabs1.AddItem(closestArea->Bottom());
@@ -600,11 +610,8 @@ public:
 						dist);
 					tab_links<XTab>& links = fXTabLinkMap[closestArea->Left()];
 					if (!links.tabs2.HasItem(closestTab)) {
-						Constraint* constraint
-							= fALMLayout->Solver()->AddConstraint(
-								-1., closestTab, 1., closestArea->Left(),
-								LinearProgramming::kGE, 0);
-						fHConstraints.AddItem(constraint);
+						fHOrders.push_back(overlap_order(closestTab,
+							closestArea->Left()));
 
 						tab_links<XTab>& links = fXTabLinkMap[closestTab];
 						links.tabs2.AddItem(closestArea->Left());
@@ -625,11 +632,8 @@ public:
 
 					tab_links<YTab>& links = fYTabLinkMap[closestArea->Top()];
 					if (!links.tabs2.HasItem(closestTab)) {
-						Constraint* constraint
-							= fALMLayout->Solver()->AddConstraint(
-								-1., closestTab, 1., closestArea->Top(),
-								LinearProgramming::kGE, 0);
-						fVConstraints.AddItem(constraint);
+						fVOrders.push_back(overlap_order(closestTab,
+							closestArea->Top()));
 
 						tab_links<YTab>& links = fYTabLinkMap[closestTab];
 						links.tabs2.AddItem(closestArea->Top());
@@ -652,10 +656,8 @@ public:
 			tab_links<YTab>& bottomLinks = fYTabLinkMap[area->Bottom()];
 			if (area->Left() != fALMLayout->Left()
 				&& leftLinks.tabs1.CountItems() == 0) {
-				Constraint* constraint = fALMLayout->Solver()->AddConstraint(
-					-1., fALMLayout->Left(), 1., area->Left(),
-					LinearProgramming::kGE, 0);
-				fHConstraints.AddItem(constraint);
+				fHOrders.push_back(overlap_order(fALMLayout->Left(),
+					area->Left()));
 
 				tab_links<XTab>& links = fXTabLinkMap[area->Left()];
 				links.tabs1.AddItem(fALMLayout->Left());
@@ -663,10 +665,8 @@ public:
 			}
 			if (area->Top() != fALMLayout->Top()
 				&& topLinks.tabs1.CountItems() == 0) {
-				Constraint* constraint = fALMLayout->Solver()->AddConstraint(
-					-1., fALMLayout->Top(), 1., area->Top(),
-					LinearProgramming::kGE, 0);
-				fVConstraints.AddItem(constraint);
+				fVOrders.push_back(overlap_order(fALMLayout->Top(),
+					area->Top()));
 
 				tab_links<YTab>& links = fYTabLinkMap[area->Top()];
 				links.tabs1.AddItem(fALMLayout->Top());
@@ -675,10 +675,8 @@ public:
 			}
 			if (area->Right() != fALMLayout->Right()
 				&& rightLinks.tabs2.CountItems() == 0) {
-				Constraint* constraint = fALMLayout->Solver()->AddConstraint(
-					-1., area->Right(), 1., fALMLayout->Right(),
-					LinearProgramming::kGE, 0);
-				fHConstraints.AddItem(constraint);
+				fHOrders.push_back(overlap_order(area->Right(),
+					fALMLayout->Right()));
 
 				tab_links<XTab>& links = fXTabLinkMap[area->Right()];
 				links.tabs2.AddItem(fALMLayout->Right());
@@ -687,10 +685,8 @@ public:
 			}
 			if (area->Bottom() != fALMLayout->Bottom()
 				&& bottomLinks.tabs2.CountItems() == 0) {
-				Constraint* constraint = fALMLayout->Solver()->AddConstraint(
-					-1., area->Bottom(), 1., fALMLayout->Bottom(),
-					LinearProgramming::kGE, 0);
-				fVConstraints.AddItem(constraint);
+				fVOrders.push_back(overlap_order(area->Bottom(),
+					fALMLayout->Bottom()));
 
 				tab_links<YTab>& links = fYTabLinkMap[area->Bottom()];
 				links.tabs2.AddItem(fALMLayout->Bottom());
@@ -698,8 +694,23 @@ public:
 				_AddDebugInfo(area, NULL, area->Bottom(), NULL);
 			}			
 		}
+
+		_Presolve();
 	}
 
+	//! An overlap constraint lower <= upper that hasn't been presolved yet.
+	struct overlap_order {
+		overlap_order(Variable* lower, Variable* upper)
+			:
+			lower(lower),
+			upper(upper)
+		{
+		}
+
+		Variable*	lower;
+		Variable*	upper;
+	};
+
 	struct debug_info {
 		Area*	area1;
 		Area*	area2;
@@ -779,28 +790,85 @@ public:
 		}
 	}
 
+	virtual void GetPresolveStatistics(int32& eliminatedRows,
+		int32& coalescedTabs) const
+	{
+		eliminatedRows = fEliminatedRows;
+		coalescedTabs = fCoalescedTabs;
+	}
+
 	void
 	DisableOverlapConstraints(bool disable)
 	{
 		debugger("you have good reasons to use this?");
 		if (disable == true) {
-			for (int32 i = 0; i < fVConstraints.CountItems(); i++) {
-				fALMLayout->Solver()->RemoveConstraint(fVConstraints.ItemAt(i),
-					false);
-			}
-			for (int32 i = 0; i < fHConstraints.CountItems(); i++) {
-				fALMLayout->Solver()->RemoveConstraint(fHConstraints.ItemAt(i),
-					false);
-			}
+			for (unsigned int i = 0; i < fVConstraints.size(); i++)
+				fConstraintPool.SetEnabled(fVConstraints[i], false);
+			for (unsigned int i = 0; i < fHConstraints.size(); i++)
+				fConstraintPool.SetEnabled(fHConstraints[i], false);
 			return;
 		}
-		for (int32 i = 0; i < fVConstraints.CountItems(); i++)
-			fALMLayout->Solver()->AddConstraint(fVConstraints.ItemAt(i));
-		for (int32 i = 0; i < fHConstraints.CountItems(); i++)
-			fALMLayout->Solver()->AddConstraint(fHConstraints.ItemAt(i));
+		for (unsigned int i = 0; i < fVConstraints.size(); i++)
+			fConstraintPool.SetEnabled(fVConstraints[i], true);
+		for (unsigned int i = 0; i < fHConstraints.size(); i++)
+			fConstraintPool.SetEnabled(fHConstraints[i], true);
 	}
 
 private:
+	/*! Adds the overlap orders to the solver that are not already implied by
+	the area size constraints, by hard custom constraints or by other overlap
+	orders. The tab links are kept, they describe the connections and not the
+	constraints in the solver. */
+	void _Presolve()
+	{
+		ConstraintPresolver presolver;
+		for (int32 i = 0; i < fALMLayout->CountConstraints(); i++)
+			presolver.AddConstraint(fALMLayout->ConstraintAt(i));
+		for (int32 i = 0; i < fALMLayout->CountAreas(); i++) {
+			Area* area = fALMLayout->AreaAt(i);
+			presolver.AddFixedOrder(area->Left(), area->Right());
+			presolver.AddFixedOrder(area->Top(), area->Bottom());
+		}
+
+		// candidate indices are the indices in fHOrders followed by the ones
+		// in fVOrders
+		for (unsigned int i = 0; i < fHOrders.size(); i++)
+			presolver.AddCandidate(fHOrders[i].lower, fHOrders[i].upper);
+		for (unsigned int i = 0; i < fVOrders.size(); i++)
+			presolver.AddCandidate(fVOrders[i].lower, fVOrders[i].upper);
+		presolver.Run();
+
+		int32 offset = _AddRemaining(presolver, fHOrders, 0, fHConstraints);
+		_AddRemaining(presolver, fVOrders, offset, fVConstraints);
+		fHOrders.clear();
+		fVOrders.clear();
+
+		fEliminatedRows = presolver.CountEliminatedRows();
+		fCoalescedTabs = presolver.CountCoalescedVariables();
+	#if DEBUG
+		printf("Overlap presolve: %i of %i constraints redundant, %i tabs "
+			"coalesced\n", (int)fEliminatedRows,
+			(int)(fHConstraints.size() + fVConstraints.size()
+				+ fEliminatedRows), (int)fCoalescedTabs);
+	#endif
+	}
+
+	/*! Adds the orders that are not redundant as lower <= upper constraints.
+	Returns the candidate index after the last order. */
+	int32 _AddRemaining(const ConstraintPresolver& presolver,
+		const std::vector<overlap_order>& orders, int32 offset,
+		std::vector<ConstraintPool::handle>& constraints)
+	{
+		for (unsigned int i = 0; i < orders.size(); i++) {
+			if (presolver.IsRedundant(offset + i))
+				continue;
+			constraints.push_back(fConstraintPool.AddConstraint(-1.,
+				orders[i].lower, 1., orders[i].upper, LinearProgramming::kGE,
+				0));
+		}
+		return offset + orders.size();
+	}
+
 	void _AddDebugInfo(Area* area1, Area* area2, XTab* tab1, XTab* tab2)
 	{
 		debug_info info;
@@ -958,8 +1026,14 @@ private:
 
 private:
 			BALMLayout*			fALMLayout;
-			BObjectList<Constraint>	fVConstraints;
-			BObjectList<Constraint>	fHConstraints;
+			ConstraintPool		fConstraintPool;
+			std::vector<ConstraintPool::handle>	fVConstraints;
+			std::vector<ConstraintPool::handle>	fHConstraints;
+			//! Collected by ConnectAreas() and handed to the presolver.
+			std::vector<overlap_order>	fVOrders;
+			std::vector<overlap_order>	fHOrders;
+			int32				fEliminatedRows;
+			int32				fCoalescedTabs;
 
 			TabConnections*		fTabConnections;
 			std::map<XTab*, tab_links<XTab> >& fXTabLinkMap;